@@ -0,0 +1,66 @@
+#include "Array.hpp"
+#include "Benchmark.hpp"
+
+#include <sstream>
+
+using namespace CppUtil;
+
+// std::to_string(Array) as it was before the Format module: copies the array and creates two temporaries per element
+template <typename T> std::string legacyToString(const Array<T> arr)
+{
+  std::string res = "{";
+  arr.foreach ([&](const T& el) { res += std::to_string(el) + " "; });
+  res += "}";
+  return res;
+}
+
+template <typename T> void benchDump(const char * type, size_t count)
+{
+  Array<T> arr(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    arr[i] = (T)(i * 7919 % 1'000'003);
+  }
+
+  std::string name;
+  size_t      len = 0;
+
+  double legacy = Benchmark::measure([&] { len = legacyToString(arr).size(); }, 1);
+  name          = std::string("legacy to_string(Array<") + type + ">)";
+  Benchmark::report(name.c_str(), legacy, count, len);
+
+  double fresh = Benchmark::measure([&] { len = std::to_string(arr).size(); });
+  name         = std::string("to_string(Array<") + type + ">)";
+  Benchmark::report(name.c_str(), fresh, count, len);
+
+  FormatBuffer buf;
+  double       reused = Benchmark::measure(
+    [&]
+    {
+      buf.clear();
+      formatTo(buf, arr);
+      len = buf.length();
+    });
+  name = std::string("formatTo(FormatBuffer, Array<") + type + ">) reused";
+  Benchmark::report(name.c_str(), reused, count, len);
+
+  double streamed = Benchmark::measure(
+    [&]
+    {
+      std::ostringstream out;
+      formatTo(out, arr);
+      len = (size_t)out.tellp();
+    });
+  name = std::string("formatTo(ostream, Array<") + type + ">)";
+  Benchmark::report(name.c_str(), streamed, count, len);
+
+  printf("  speedup to_string: %.1fx\n\n", legacy / fresh);
+}
+
+int main()
+{
+  benchDump<int>("int", 10'000'000);
+  benchDump<long long>("long long", 10'000'000);
+  benchDump<double>("double", 1'000'000);
+  return 0;
+}
@@ -0,0 +1,116 @@
+#include "Benchmark.hpp"
+#include "BitArray.hpp"
+#include "RoaringBitArray.hpp"
+
+#include <random>
+
+using namespace CppUtil;
+
+static constexpr size_t Bits1B = 1'000'000'000;
+
+int main()
+{
+  std::mt19937_64 rng(42);
+
+  // Dense flags: every bit random
+  BitArray a(Bits1B), b(Bits1B);
+  {
+    uint64_t * wa = a.getData();
+    uint64_t * wb = b.getData();
+    for (size_t i = 0; i < a.getWordCount(); i++)
+    {
+      wa[i] = rng();
+      wb[i] = rng();
+    }
+  }
+  size_t bytes = a.getWordCount() * sizeof(uint64_t);
+
+  {
+    Array<bool> flags(Bits1B);
+    for (size_t i = 0; i < Bits1B; i++)
+      flags[i] = a[i];
+
+    size_t n      = 0;
+    double legacy = Benchmark::measure(
+      [&]
+      {
+        n = 0;
+        flags.foreach ([&](bool f) { n += f ? 1 : 0; });
+        Benchmark::doNotOptimize(n);
+      },
+      1);
+    Benchmark::report("Array<bool>::foreach count, 1B", legacy, Bits1B, Bits1B);
+
+    double fresh = Benchmark::measure(
+      [&]
+      {
+        n = a.count();
+        Benchmark::doNotOptimize(n);
+      });
+    Benchmark::report("BitArray::count, 1B", fresh, Bits1B, bytes);
+    printf("  speedup count: %.1fx\n\n", legacy / fresh);
+  }
+
+  BitArray c = a;
+  Benchmark::report("BitArray &=, 1B", Benchmark::measure([&] { c &= b; }), Bits1B, 3 * bytes);
+  Benchmark::report("BitArray |=, 1B", Benchmark::measure([&] { c |= b; }), Bits1B, 3 * bytes);
+  Benchmark::report("BitArray ^=, 1B", Benchmark::measure([&] { c ^= b; }), Bits1B, 3 * bytes);
+  Benchmark::report("BitArray::flip, 1B", Benchmark::measure([&] { c.flip(); }), Bits1B, 2 * bytes);
+
+  // Sparse flags: one bit in ~1000
+  BitArray sparse(Bits1B);
+  for (size_t i = 0; i < Bits1B / 1'000; i++)
+    sparse.set(rng() % Bits1B);
+
+  size_t visited = 0;
+  double next    = Benchmark::measure(
+    [&]
+    {
+      visited = 0;
+      for (size_t i = sparse.findFirst(); i != BitArray::npos; i = sparse.findNext(i))
+        visited++;
+      Benchmark::doNotOptimize(visited);
+    },
+    3);
+  Benchmark::report("BitArray findFirst/findNext, 1B sparse", next, Bits1B, bytes);
+
+  RoaringBitArray roaring(sparse);
+  printf("\n  sparse set of %zu values: BitArray %zu MB, RoaringBitArray %zu MB\n", roaring.getCount(), bytes >> 20,
+         roaring.getMemoryUsage() >> 20);
+
+  RoaringBitArray other;
+  for (size_t i = 0; i < Bits1B / 1'000; i++)
+    other.add((uint32_t)(rng() % Bits1B));
+
+  uint64_t sum         = 0;
+  double   roaringNext = Benchmark::measure(
+    [&]
+    {
+      sum = 0;
+      roaring.foreach ([&](uint32_t v) { sum += v; });
+      Benchmark::doNotOptimize(sum);
+    },
+    3);
+  Benchmark::report("RoaringBitArray::foreach, 1B sparse", roaringNext, roaring.getCount());
+
+  size_t hits = 0;
+  double band = Benchmark::measure(
+    [&]
+    {
+      hits = (roaring & other).getCount();
+      Benchmark::doNotOptimize(hits);
+    },
+    3);
+  Benchmark::report("RoaringBitArray &, 1B sparse", band, roaring.getCount() + other.getCount());
+
+  double bor = Benchmark::measure(
+    [&]
+    {
+      hits = (roaring | other).getCount();
+      Benchmark::doNotOptimize(hits);
+    },
+    3);
+  Benchmark::report("RoaringBitArray |, 1B sparse", bor, roaring.getCount() + other.getCount());
+
+  return 0;
+}
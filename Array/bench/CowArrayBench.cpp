@@ -0,0 +1,70 @@
+#include "Benchmark.hpp"
+#include "CowArray.hpp"
+
+#include <vector>
+
+using namespace CppUtil;
+
+// Copy-heavy workload: an array is copied into many holders, which mostly only read it
+static constexpr size_t Elements = 256;
+static constexpr size_t Copies   = 200'000;
+
+template <typename A, typename Read> static double copyAndRead(const A& source, Read&& read)
+{
+  return Benchmark::measure(
+    [&]
+    {
+      std::vector<A> holders;
+      holders.reserve(Copies);
+      long sum = 0;
+      for (size_t i = 0; i < Copies; i++)
+      {
+        holders.push_back(source);
+        sum += read(holders.back(), i % Elements);
+      }
+      Benchmark::doNotOptimize(sum);
+    },
+    3);
+}
+
+// Every copy is modified once, so `CowArray` pays the deep copy as well
+template <typename A> static double copyAndWrite(const A& source)
+{
+  return Benchmark::measure(
+    [&]
+    {
+      long sum = 0;
+      for (size_t i = 0; i < Copies; i++)
+      {
+        A copy             = source;
+        copy[i % Elements] = (int)i;
+        sum += copy[0];
+      }
+      Benchmark::doNotOptimize(sum);
+    },
+    3);
+}
+
+int main()
+{
+  Array<int>    arr(Elements);
+  CowArray<int> cow(Elements);
+  for (size_t i = 0; i < Elements; i++)
+  {
+    arr[i] = (int)i;
+    cow[i] = (int)i;
+  }
+
+  double arrRead = copyAndRead(arr, [](const Array<int>& a, size_t i) { return a[i]; });
+  double cowRead = copyAndRead(cow, [](const CowArray<int>& a, size_t i) { return a[i]; });
+  Benchmark::report("Array copy + read", arrRead, Copies, Copies * Elements * sizeof(int));
+  Benchmark::report("CowArray copy + read", cowRead, Copies, Copies * Elements * sizeof(int));
+
+  double arrWrite = copyAndWrite(arr);
+  double cowWrite = copyAndWrite(cow);
+  Benchmark::report("Array copy + write", arrWrite, Copies, Copies * Elements * sizeof(int));
+  Benchmark::report("CowArray copy + write", cowWrite, Copies, Copies * Elements * sizeof(int));
+
+  printf("  speedup: %.1fx read-only copies, %.2fx copies written once\n", arrRead / cowRead, arrWrite / cowWrite);
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "Array.hpp"
+#include "Benchmark.hpp"
+
+using namespace CppUtil;
+
+static constexpr size_t AppendCount = 1'000'000;
+static constexpr size_t InsertBase  = 100'000;
+static constexpr size_t InsertCount = 1'000;
+
+int main()
+{
+  Array<long> items(AppendCount);
+  for (size_t i = 0; i < AppendCount; i++)
+    items[i] = (long)i;
+
+  // Append 1M items to an empty array
+  {
+    double single = Benchmark::measure(
+      [&]
+      {
+        DynamicArray<long> arr;
+        for (size_t i = 0; i < AppendCount; i++)
+          arr.add(items[i]);
+        Benchmark::doNotOptimize(arr);
+      });
+    double bulk = Benchmark::measure(
+      [&]
+      {
+        DynamicArray<long> arr;
+        arr.append(items);
+        Benchmark::doNotOptimize(arr);
+      });
+    Benchmark::report("add() x 1M", single, AppendCount, AppendCount * sizeof(long));
+    Benchmark::report("append(Array) 1M", bulk, AppendCount, AppendCount * sizeof(long));
+    printf("  speedup: %.1fx\n\n", single / bulk);
+  }
+
+  DynamicArray<long> base;
+  base.addRange(items, InsertBase);
+
+  // Insert 1K items at the front of 100K
+  {
+    DynamicArray<long> arr;
+    double             single = Benchmark::measure([&] { arr = base; },
+                                       [&]
+                                       {
+                                         for (size_t i = 0; i < InsertCount; i++)
+                                           arr.add(items[i], i);
+                                       },
+                                       5);
+    double bulk = Benchmark::measure([&] { arr = base; }, [&] { arr.insertRange(0, items, InsertCount); }, 5);
+    Benchmark::report("add(item, idx) x 1K at front of 100K", single, InsertCount);
+    Benchmark::report("insertRange 1K at front of 100K", bulk, InsertCount);
+    printf("  speedup: %.1fx\n\n", single / bulk);
+  }
+
+  // Erase 1K items at the front of 100K
+  {
+    DynamicArray<long> arr;
+    double             single = Benchmark::measure([&] { arr = base; },
+                                       [&]
+                                       {
+                                         for (size_t i = 0; i < InsertCount; i++)
+                                           arr.remove(0);
+                                       },
+                                       5);
+    double             bulk   = Benchmark::measure([&] { arr = base; }, [&] { arr.eraseRange(0, InsertCount); }, 5);
+    Benchmark::report("remove(0) x 1K of 100K", single, InsertCount);
+    Benchmark::report("eraseRange 1K of 100K", bulk, InsertCount);
+    printf("  speedup: %.1fx\n\n", single / bulk);
+  }
+
+  // Erase every other item of 100K
+  {
+    DynamicArray<long> arr;
+    double             single = Benchmark::measure([&] { arr = base; },
+                                       [&]
+                                       {
+                                         for (size_t i = 0; i < arr.getCount();)
+                                         {
+                                           if (arr[i] % 2 == 0)
+                                             arr.remove(i);
+                                           else
+                                             i++;
+                                         }
+                                       },
+                                       3);
+    double bulk = Benchmark::measure([&] { arr = base; }, [&] { arr.eraseIf([](long& x) { return x % 2 == 0; }); }, 3);
+    Benchmark::report("remove(idx) loop, every other of 100K", single, InsertBase);
+    Benchmark::report("eraseIf, every other of 100K", bulk, InsertBase);
+    printf("  speedup: %.1fx\n", single / bulk);
+  }
+  return 0;
+}
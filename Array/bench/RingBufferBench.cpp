@@ -0,0 +1,76 @@
+#include "Benchmark.hpp"
+#include "RingBuffer.hpp"
+
+#include <deque>
+#include <string>
+
+using namespace CppUtil;
+
+// Queue workload: keep `Depth` items queued while pushing and popping `Ops` items
+static constexpr size_t Ops = 200'000;
+
+template <typename Push, typename Pop> static double queue(size_t depth, Push&& push, Pop&& pop)
+{
+  return Benchmark::measure(
+    [&]
+    {
+      long sum = 0;
+      for (size_t i = 0; i < depth; i++)
+        push((long)i);
+      for (size_t i = 0; i < Ops; i++)
+      {
+        push((long)i);
+        sum += pop();
+      }
+      for (size_t i = 0; i < depth; i++)
+        sum += pop();
+      Benchmark::doNotOptimize(sum);
+    },
+    3);
+}
+
+int main()
+{
+  for (size_t depth : {16, 1'024, 4'096})
+  {
+    DynamicArray<long> arr;
+    RingBuffer<long>   ring;
+    std::deque<long>   ref;
+
+    double legacy = queue(
+      depth, [&](long v) { arr.add(v); },
+      [&]
+      {
+        long v = arr[0];
+        arr.remove(0);
+        return v;
+      });
+    double fresh = queue(
+      depth, [&](long v) { ring.pushBack(v); }, [&] { return ring.popFront(); });
+    double std = queue(
+      depth, [&](long v) { ref.push_back(v); },
+      [&]
+      {
+        long v = ref.front();
+        ref.pop_front();
+        return v;
+      });
+
+    std::string suffix = ", depth " + std::to_string(depth);
+    Benchmark::report(("DynamicArray add/remove(0)" + suffix).c_str(), legacy, Ops);
+    Benchmark::report(("RingBuffer pushBack/popFront" + suffix).c_str(), fresh, Ops);
+    Benchmark::report(("std::deque push_back/pop_front" + suffix).c_str(), std, Ops);
+    printf("  speedup: %.1fx\n\n", legacy / fresh);
+  }
+
+  // Bulk shifts, formerly one checked element access per element
+  Array<long> arr(10'000'000);
+  double      shift = Benchmark::measure(
+    [&]
+    {
+      arr.shiftLeft(1);
+      arr.shiftRight(1);
+    });
+  Benchmark::report("Array shiftLeft + shiftRight, 10M", shift, 2 * arr.getSize(), 4 * arr.getSize() * sizeof(long));
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include "Benchmark.hpp"
+#include "SmallDynamicArray.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace CppUtil;
+
+// Parser workload: split each short record into a temporary list of field offsets, then consume the list
+static constexpr size_t Records = 1'000'000;
+
+template <typename List, typename Add, typename Sum>
+static double split(const std::vector<std::string>& records, Add&& add, Sum&& sumOf)
+{
+  return Benchmark::measure(
+    [&]
+    {
+      size_t sum = 0;
+      for (const std::string& record : records)
+      {
+        List fields;
+        add(fields, 0);
+        for (size_t i = 0; i < record.size(); i++)
+        {
+          if (record[i] == ',')
+            add(fields, i + 1);
+        }
+        sum += sumOf(fields);
+      }
+      Benchmark::doNotOptimize(sum);
+    },
+    3);
+}
+
+int main()
+{
+  // Records of 1 to 8 fields
+  std::mt19937             rng(1);
+  std::vector<std::string> records(Records);
+  for (auto& record : records)
+  {
+    size_t fields = 1 + rng() % 8;
+    for (size_t f = 0; f < fields; f++)
+    {
+      record += (f > 0 ? "," : "") + std::to_string(rng() % 1000);
+    }
+  }
+
+  auto sumOf = [](const size_t * data, size_t n)
+  {
+    size_t res = 0;
+    for (size_t i = 0; i < n; i++)
+      res += data[i];
+    return res;
+  };
+
+  double dynamic = split<DynamicArray<size_t>>(
+    records, [](DynamicArray<size_t>& l, size_t x) { l.add(x); },
+    [&](const DynamicArray<size_t>& l) { return sumOf(l.getData(), l.getCount()); });
+  double vector = split<std::vector<size_t>>(
+    records, [](std::vector<size_t>& l, size_t x) { l.push_back(x); },
+    [&](const std::vector<size_t>& l) { return sumOf(l.data(), l.size()); });
+  double small = split<SmallDynamicArray<size_t, 8>>(
+    records, [](SmallDynamicArray<size_t, 8>& l, size_t x) { l.add(x); },
+    [&](const SmallDynamicArray<size_t, 8>& l) { return sumOf(l.getData(), l.getCount()); });
+
+  Benchmark::report("DynamicArray temporary lists", dynamic, Records);
+  Benchmark::report("std::vector temporary lists", vector, Records);
+  Benchmark::report("SmallDynamicArray<8> temporary lists", small, Records);
+  printf("  speedup vs DynamicArray: %.1fx\n", dynamic / small);
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include "Benchmark.hpp"
+#include "SoAArray.hpp"
+
+#include <cstdint>
+#include <random>
+
+using namespace CppUtil;
+
+static constexpr size_t Rows = 50'000'000;
+
+struct Record
+{
+  int64_t timestamp;
+  double  price;
+  int32_t id;
+  int32_t quantity;
+  int32_t store;
+  int32_t flags;
+
+  // Required by DynamicArray
+  bool operator!=(const Record& other) const
+  {
+    return this->timestamp != other.timestamp || this->price != other.price || this->id != other.id ||
+           this->quantity != other.quantity || this->store != other.store || this->flags != other.flags;
+  }
+};
+
+// Filter `quantity > Threshold` on one int column, against the same table stored row-wise
+static constexpr int32_t Threshold = 900;
+
+int main()
+{
+  std::mt19937 rng(42);
+
+  double aosForeach = 0;
+  double aosRaw     = 0;
+  {
+    DynamicArray<Record> records(Rows);
+    for (size_t i = 0; i < Rows; i++)
+    {
+      records.add(Record{(int64_t)i, 1.5, (int32_t)i, (int32_t)(rng() % 1'000), (int32_t)(i % 64), 0});
+    }
+
+    size_t hits = 0;
+    aosForeach  = Benchmark::measure(
+      [&]
+      {
+        hits = 0;
+        records.foreach ([&](Record& r) { hits += (r.quantity > Threshold) ? 1 : 0; });
+        Benchmark::doNotOptimize(hits);
+      },
+      3);
+    Benchmark::report("DynamicArray<Record>::foreach filter", aosForeach, Rows, Rows * sizeof(Record));
+
+    aosRaw = Benchmark::measure(
+      [&]
+      {
+        const Record * data = records.getData();
+        hits                = 0;
+        for (size_t i = 0; i < Rows; i++)
+          hits += (data[i].quantity > Threshold) ? 1 : 0;
+        Benchmark::doNotOptimize(hits);
+      },
+      3);
+    Benchmark::report("DynamicArray<Record> raw loop filter", aosRaw, Rows, Rows * sizeof(Record));
+  }
+
+  rng.seed(42);
+  {
+    SoAArray<int64_t, double, int32_t, int32_t, int32_t, int32_t> table(Rows);
+    for (size_t i = 0; i < Rows; i++)
+    {
+      table.add((int64_t)i, 1.5, (int32_t)i, (int32_t)(rng() % 1'000), (int32_t)(i % 64), 0);
+    }
+
+    size_t hits = 0;
+    double soa  = Benchmark::measure(
+      [&]
+      {
+        hits = table.countIf<3>([](int32_t q) { return q > Threshold; });
+        Benchmark::doNotOptimize(hits);
+      },
+      3);
+    Benchmark::report("SoAArray::countIf filter", soa, Rows, Rows * sizeof(int32_t));
+
+    ThreadPool pool;
+    double     parallel = Benchmark::measure(
+      [&]
+      {
+        hits = table.countIfParallel<3>(pool, [](int32_t q) { return q > Threshold; });
+        Benchmark::doNotOptimize(hits);
+      },
+      3);
+    Benchmark::report("SoAArray::countIfParallel filter", parallel, Rows, Rows * sizeof(int32_t));
+
+    size_t found = 0;
+    double ids   = Benchmark::measure(
+      [&]
+      {
+        found = table.findIf<3>([](int32_t q) { return q > Threshold; }).getSize();
+        Benchmark::doNotOptimize(found);
+      },
+      3);
+    Benchmark::report("SoAArray::findIf filter", ids, Rows, Rows * sizeof(int32_t));
+
+    printf("  speedup countIf vs DynamicArray foreach: %.1fx, vs raw loop: %.1fx\n", aosForeach / soa, aosRaw / soa);
+  }
+  return 0;
+}
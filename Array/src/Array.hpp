@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "Exception.hpp"
+#include "Format.hpp"
 
 // Hope a billion is enough elements you sick people
 #define ARRAY_MAX_SIZE 1'000'000'000
@@ -16,10 +19,20 @@ protected:
   T *    arr;
   size_t size;
 
+  // Set every element back to a default constructed one
+  void reset()
+  {
+    for (size_t i = 0; i < this->size; i++)
+    {
+      this->arr[i] = T();
+    }
+  }
+
 public:
   Array<T>()
   {
-    this->arr = new T[0]();
+    this->arr  = new T[0]();
+    this->size = 0;
   }
 
   Array<T>(size_t size)
@@ -116,6 +129,19 @@ public:
     return *this;
   }
 
+  Array<T>(Array<T>&& other) noexcept : arr(other.arr), size(other.size)
+  {
+    other.arr  = nullptr;
+    other.size = 0;
+  }
+
+  Array<T>& operator=(Array<T>&& other) noexcept
+  {
+    std::swap(this->arr, other.arr);
+    std::swap(this->size, other.size);
+    return *this;
+  }
+
   operator T *() const
   {
     return this->arr;
@@ -199,20 +225,38 @@ public:
     return true;
   }
 
+  /**
+     * Move all elements `num` places to the left, dropping the first `num` elements.
+     *
+     * @note The last `num` elements are left in a valid but unspecified state. Shifting by the size or more resets
+     * all elements.
+     */
   void shiftLeft(const size_t num)
   {
-    for (int i = num; i < this->size; i++)
-    {
-      this->operator[](i - num) = this->operator[](i);
-    }
+    if (num == 0)
+      return;
+
+    if (num >= this->size)
+      return this->reset();
+
+    std::move(this->arr + num, this->arr + this->size, this->arr);
   }
 
+  /**
+     * Move all elements `num` places to the right, dropping the last `num` elements.
+     *
+     * @note The first `num` elements are left in a valid but unspecified state. Shifting by the size or more resets
+     * all elements.
+     */
   void shiftRight(const size_t num)
   {
-    for (int i = this->size - num; i > 0; i--)
-    {
-      this->operator[](i + num) = this->operator[](i);
-    }
+    if (num == 0)
+      return;
+
+    if (num >= this->size)
+      return this->reset();
+
+    std::move_backward(this->arr, this->arr + this->size - num, this->arr + this->size);
   }
 
   //ToDo: UnitTest
@@ -393,10 +437,7 @@ public:
     if (newSize > this->size)
     {
       T * tmp = new T[newSize]();
-      for (size_t i = 0; i < this->size; i++)
-      {
-        tmp[i] = this->arr[i];
-      }
+      std::move(this->arr, this->arr + this->size, tmp);
       delete[] this->arr;
       this->arr = tmp;
 
@@ -436,10 +477,7 @@ public:
     else
     {
       T * tmp = new T[newSize]();
-      for (size_t i = 0; i < newSize; i++)
-      {
-        tmp[i] = this->arr[i];
-      }
+      std::move(this->arr, this->arr + newSize, tmp);
       delete[] this->arr;
 
       this->arr  = tmp;
@@ -456,6 +494,46 @@ protected:
 
   ResizableArray<T> arr;
 
+  T * data()
+  {
+    return this->arr;
+  }
+
+  // Grow once, so at least `needed` elements fit
+  void reserveFor(size_t needed)
+  {
+    if (needed > ARRAY_MAX_SIZE)
+    {
+      throw std::length_error("Size " + std::to_string(needed) + " is not a valid array size!");
+    }
+
+    if (needed > this->getCap())
+    {
+      this->arr.resize(std::max(needed, this->getCap() * this->resizeFactor));
+    }
+  }
+
+  // Shrink once, to the capacity repeated single `remove` calls would have left
+  void shrinkAfterRemove()
+  {
+    size_t cap = this->getCap();
+    while (this->count * this->resizeFactor <= cap && cap >= this->resizeFactor)
+    {
+      cap /= this->resizeFactor;
+    }
+
+    if (cap != this->getCap())
+    {
+      this->arr.resizeForce(cap);
+    }
+  }
+
+  bool isOwnElement(const T * item) const
+  {
+    const T * begin = this->getData();
+    return item >= begin && item < begin + this->getCap();
+  }
+
 public:
   DynamicArray<T>() : arr(2)
   {
@@ -490,6 +568,31 @@ public:
     this->resizeFactor = resizeFactor;
   }
 
+  DynamicArray<T>(const DynamicArray<T>& other)            = default;
+  DynamicArray<T>& operator=(const DynamicArray<T>& other) = default;
+
+  /**
+     * Take over the buffer of `other`, leaving it empty with a capacity of 0
+     */
+  DynamicArray<T>(DynamicArray<T>&& other) noexcept
+    : count(other.count), resizeFactor(other.resizeFactor), arr(std::move(other.arr))
+  {
+    other.count = 0;
+  }
+
+  DynamicArray<T>& operator=(DynamicArray<T>&& other) noexcept
+  {
+    if (&other != this)
+    {
+      // The buffers are swapped, so `other` keeps a valid (but empty) array
+      this->arr          = std::move(other.arr);
+      this->count        = other.count;
+      this->resizeFactor = other.resizeFactor;
+      other.count        = 0;
+    }
+    return *this;
+  }
+
   T& operator[](size_t idx)
   {
     if (idx > ARRAY_MAX_SIZE)
@@ -537,14 +640,20 @@ public:
     return this->resizeFactor;
   }
 
-  virtual void add(T item) final
+  /**
+     * Get a pointer to the first element
+     *
+     * @warning The pointer is invalidated by any operation changing the capacity.
+     */
+  const T * getData() const
   {
-    if (this->count >= this->getCap())
-    {
-      this->arr.resize(this->count * this->resizeFactor);
-    }
+    return this->arr;
+  }
 
-    this->arr[count++] = item;
+  virtual void add(T item) final
+  {
+    this->reserveFor(this->count + 1);
+    this->data()[this->count++] = std::move(item);
   }
 
   virtual void add(T item, size_t idx) final
@@ -560,19 +669,118 @@ public:
                               std::to_string(this->count) + " elements!");
     }
 
-    if (this->count >= this->getCap())
+    this->reserveFor(this->count + 1);
+
+    std::move_backward(this->data() + idx, this->data() + this->count, this->data() + this->count + 1);
+    this->data()[idx] = std::move(item);
+    this->count++;
+  }
+
+  /**
+     * Append the `n` elements at `items`, growing at most once
+     *
+     * @throws `invalid_argument` if `items` is a nullpointer
+     */
+  void addRange(const T * items, size_t n)
+  {
+    this->insertRange(this->count, items, n);
+  }
+
+  void append(const Array<T>& items)
+  {
+    this->addRange(items, items.getSize());
+  }
+
+  void append(const DynamicArray<T>& items)
+  {
+    this->addRange(items.getData(), items.getCount());
+  }
+
+  /**
+     * Insert the `n` elements at `items` before index @param idx, growing at most once and shifting the following
+     * elements in one go
+     *
+     * @throws `out_of_range` if @param idx is behind the last element
+     * @throws `invalid_argument` if `items` is a nullpointer
+     */
+  void insertRange(size_t idx, const T * items, size_t n)
+  {
+    if (idx > this->count)
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for dynamic array with " +
+                              std::to_string(this->count) + " elements!");
+    }
+
+    if (items == nullptr)
     {
-      this->arr.resize(this->getCap() * this->resizeFactor);
+      if (n == 0)
+        return;
+      throw std::invalid_argument("Buffer must not be a nullpointer!");
     }
 
-    for (size_t i = this->getCap() - 1; i > idx; i--)
+    // Growing or shifting would invalidate a range inside the array itself
+    if (n > 0 && this->isOwnElement(items))
     {
-      this->arr[i] = this->arr[i - 1];
+      Array<T> copy(items, n);
+      return this->insertRange(idx, copy, n);
     }
 
-    this->arr[idx] = item;
-    this->count++;
+    this->reserveFor(this->count + n);
+
+    T * buf = this->data();
+    std::move_backward(buf + idx, buf + this->count, buf + this->count + n);
+    std::copy(items, items + n, buf + idx);
+    this->count += n;
+  }
+
+  void insertRange(size_t idx, const Array<T>& items)
+  {
+    this->insertRange(idx, items, items.getSize());
+  }
+
+  /**
+     * Remove the @param n elements starting at index @param idx, shifting the following elements in one go
+     *
+     * @throws `out_of_range` if the range is not inside the array
+     */
+  void eraseRange(size_t idx, size_t n)
+  {
+    if (idx > this->count || n > this->count - idx)
+    {
+      throw std::out_of_range("Range [" + std::to_string(idx) + ", " + std::to_string(idx + n) +
+                              ") out of bounds for dynamic array with " + std::to_string(this->count) + " elements!");
+    }
+
+    T * buf = this->data();
+    std::move(buf + idx + n, buf + this->count, buf + idx);
+    this->count -= n;
+    this->shrinkAfterRemove();
+  }
+
+  /**
+     * Remove all elements for which `pred` returns true, keeping the order of the others
+     *
+     * @return The amount of removed elements
+     */
+  template <typename func> size_t eraseIf(func&& pred)
+  {
+    T *    buf  = this->data();
+    T *    end  = std::remove_if(buf, buf + this->count, pred);
+    size_t kept = (size_t)(end - buf);
+
+    size_t removed = this->count - kept;
+    this->count    = kept;
+    this->shrinkAfterRemove();
+    return removed;
   }
+  /**
+     * Remove all elements, keeping the capacity
+     */
+  void clear()
+  {
+    this->count = 0;
+  }
+
   /**
      * Remove the last element (the one with the biggest index) from the array
      * 
@@ -621,10 +829,7 @@ public:
 
     this->count--;
 
-    for (size_t i = idx; i < this->count; i++)
-    {
-      this->arr[i] = this->arr[i + 1];
-    }
+    std::move(this->data() + idx + 1, this->data() + this->count + 1, this->data() + idx);
 
     if (this->count * this->resizeFactor <= this->getCap() && this->getCap() >= this->resizeFactor)
     {
@@ -752,35 +957,67 @@ template <typename T, typename func> static void foreach (DynamicArray<T> arr, f
   }
 }
 
+/**
+   * Write the elements of `arr` into a (reusable) `FormatBuffer`
+   */
+template <typename T> void formatTo(FormatBuffer& out, const Array<T>& arr, const FormatOptions& opts = FormatOptions())
+{
+  Format::join(out, (const T *)arr, arr.getSize(), opts);
+}
+
+template <typename T>
+void formatTo(FormatBuffer& out, const DynamicArray<T>& arr, const FormatOptions& opts = FormatOptions())
+{
+  Format::join(out, arr.getData(), arr.getCount(), opts);
+}
+
+/**
+   * Write the elements of `arr` into a stream, without building the whole string in memory
+   */
+template <typename T> void formatTo(std::ostream& out, const Array<T>& arr, const FormatOptions& opts = FormatOptions())
+{
+  Format::join(out, (const T *)arr, arr.getSize(), opts);
+}
+
+template <typename T>
+void formatTo(std::ostream& out, const DynamicArray<T>& arr, const FormatOptions& opts = FormatOptions())
+{
+  Format::join(out, arr.getData(), arr.getCount(), opts);
+}
 }; // namespace CppUtil
 namespace std
 {
-template <typename T> string to_string(const CppUtil::Array<T> arr)
+template <typename T> string to_string(const CppUtil::Array<T>& arr, const CppUtil::FormatOptions& opts)
+{
+  CppUtil::FormatBuffer res;
+  CppUtil::formatTo(res, arr, opts);
+  return res.toString();
+}
+
+template <typename T> string to_string(const CppUtil::Array<T>& arr)
+{
+  return to_string(arr, CppUtil::FormatOptions());
+}
+
+/**
+   * Format only the first `n` elements of `arr`
+   */
+template <typename T> string to_string(const CppUtil::Array<T>& arr, size_t n)
 {
-  string res = "{";
-  arr.foreach ([&](const T& el) { res += to_string(el) + " "; });
-  res += "}";
-  return res;
+  CppUtil::FormatOptions opts;
+  opts.limit = n;
+  return to_string(arr, opts);
 }
 
-template <typename T> string to_string(const CppUtil::Array<T> arr, size_t n)
+template <typename T> string to_string(const CppUtil::DynamicArray<T>& arr, const CppUtil::FormatOptions& opts)
 {
-  string res = "{";
-  arr.foreach (
-    [&](const T& el, size_t i)
-    {
-      if (i < n)
-        res += to_string(el) + " ";
-    });
-  res += "}";
-  return res;
+  CppUtil::FormatBuffer res;
+  CppUtil::formatTo(res, arr, opts);
+  return res.toString();
 }
 
 template <typename T> string to_string(const CppUtil::DynamicArray<T>& arr)
 {
-  string res = "{";
-  arr.foreach ([&](const T& el) { res += to_string(el) + " "; });
-  res += "}";
-  return res;
+  return to_string(arr, CppUtil::FormatOptions());
 }
 } // namespace std
\ No newline at end of file
@@ -0,0 +1,541 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "Array.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BITS_POPCNT_X86 1
+#endif
+
+namespace CppUtil
+{
+/**
+  * Word level bit manipulation, using hardware instructions where available
+  */
+class Bits
+{
+private:
+#if defined(BITS_POPCNT_X86)
+  __attribute__((target("popcnt"))) static size_t countPopcnt(const uint64_t * words, size_t n)
+  {
+    size_t res = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      res += (size_t)__builtin_popcountll(words[i]);
+    }
+    return res;
+  }
+
+  static bool hasPopcnt()
+  {
+    static const bool has = []
+    {
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("popcnt");
+    }();
+    return has;
+  }
+#endif
+
+public:
+  /**
+    * Amount of set bits in `word`
+    */
+  static size_t popcount(uint64_t word)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (size_t)((word * 0x0101010101010101ull) >> 56);
+#endif
+  }
+
+  /**
+    * Index of the lowest set bit in `word`
+    *
+    * @warning `word` must not be 0.
+    */
+  static size_t countTrailingZeros(uint64_t word)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_ctzll(word);
+#else
+    size_t res = 0;
+    while ((word & 1) == 0)
+    {
+      word >>= 1;
+      res++;
+    }
+    return res;
+#endif
+  }
+
+  /**
+    * Amount of set bits in the `n` words at `words`, using the `popcnt` instruction if the CPU supports it
+    */
+  static size_t count(const uint64_t * words, size_t n)
+  {
+#if defined(BITS_POPCNT_X86)
+    if (hasPopcnt())
+      return countPopcnt(words, n);
+#endif
+    size_t res = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      res += popcount(words[i]);
+    }
+    return res;
+  }
+};
+
+/**
+  * Fixed size array of bits, packed into 64 bit words
+  *
+  * Uses one bit per element where `Array<bool>` uses a byte. Bulk operations (`count`, `&=`, `findNext`, ...)
+  * work on whole words. Bits behind `getSize()` in the last word are always kept 0.
+  */
+class BitArray
+{
+public:
+  static constexpr size_t npos = (size_t)-1;
+
+protected:
+  Array<uint64_t> words;
+  size_t          size = 0;
+
+  static size_t wordsFor(size_t bits)
+  {
+    return (bits + 63) / 64;
+  }
+
+  size_t getUsedWords() const
+  {
+    return wordsFor(this->size);
+  }
+
+  // Clear the bits behind `size` in the last word
+  void clearTail()
+  {
+    if (this->size % 64 != 0)
+      ((uint64_t *)this->words)[this->size / 64] &= ((uint64_t)1 << (this->size % 64)) - 1;
+  }
+
+  void checkIdx(size_t idx) const
+  {
+    if (idx >= this->size)
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for bit array of size " +
+                              std::to_string(this->size) + "!");
+    }
+  }
+
+  void checkSameSize(const BitArray& other) const
+  {
+    if (this->size != other.size)
+    {
+      throw std::invalid_argument("Cannot combine bit arrays of size " + std::to_string(this->size) + " and " +
+                                  std::to_string(other.size) + "!");
+    }
+  }
+
+  template <typename op> BitArray& combine(const BitArray& other, op&& f)
+  {
+    this->checkSameSize(other);
+
+    uint64_t *       dst = this->words;
+    const uint64_t * src = other.words;
+    for (size_t i = 0, n = this->getUsedWords(); i < n; i++)
+    {
+      dst[i] = f(dst[i], src[i]);
+    }
+    return *this;
+  }
+
+public:
+  BitArray() : words(0) {}
+
+  BitArray(size_t size, bool value = false) : words(wordsFor(size)), size(size)
+  {
+    if (value)
+      this->fill(true);
+  }
+
+  BitArray(const Array<bool>& arr) : BitArray(arr.getSize())
+  {
+    const bool * src = arr;
+    uint64_t *   dst = this->words;
+    for (size_t i = 0; i < this->size; i++)
+    {
+      dst[i / 64] |= (uint64_t)src[i] << (i % 64);
+    }
+  }
+
+  size_t getSize() const
+  {
+    return this->size;
+  }
+
+  bool isEmpty() const
+  {
+    return this->size == 0;
+  }
+
+  /**
+    * Amount of words holding the bits, the last one only partially used if the size is no multiple of 64
+    */
+  size_t getWordCount() const
+  {
+    return this->getUsedWords();
+  }
+
+  /**
+    * Get a pointer to the first word, bit `i` is bit `i % 64` of word `i / 64`
+    */
+  const uint64_t * getData() const
+  {
+    return this->words;
+  }
+
+  /**
+    * Get a pointer to the first word, for filling the array word by word
+    *
+    * @warning Bits behind `getSize()` in the last word must be left 0.
+    */
+  uint64_t * getData()
+  {
+    return this->words;
+  }
+
+  /**
+    * @throws `out_of_range` if `idx` is out of bounds
+    */
+  bool get(size_t idx) const
+  {
+    this->checkIdx(idx);
+    return (((const uint64_t *)this->words)[idx / 64] >> (idx % 64)) & 1;
+  }
+
+  bool operator[](size_t idx) const
+  {
+    return this->get(idx);
+  }
+
+  /**
+    * @throws `out_of_range` if `idx` is out of bounds
+    */
+  void set(size_t idx, bool value = true)
+  {
+    this->checkIdx(idx);
+
+    uint64_t& word = ((uint64_t *)this->words)[idx / 64];
+    uint64_t  bit  = (uint64_t)1 << (idx % 64);
+    word           = value ? (word | bit) : (word & ~bit);
+  }
+
+  void reset(size_t idx)
+  {
+    this->set(idx, false);
+  }
+
+  void flip(size_t idx)
+  {
+    this->checkIdx(idx);
+    ((uint64_t *)this->words)[idx / 64] ^= (uint64_t)1 << (idx % 64);
+  }
+
+  /**
+    * Set all bits to `value`
+    */
+  void fill(bool value)
+  {
+    memset((uint64_t *)this->words, value ? 0xFF : 0, this->getUsedWords() * sizeof(uint64_t));
+    this->clearTail();
+  }
+
+  /**
+    * Flip all bits
+    */
+  void flip()
+  {
+    uint64_t * w = this->words;
+    for (size_t i = 0, n = this->getUsedWords(); i < n; i++)
+    {
+      w[i] = ~w[i];
+    }
+    this->clearTail();
+  }
+
+  /**
+    * Amount of set bits
+    */
+  size_t count() const
+  {
+    return Bits::count(this->words, this->getUsedWords());
+  }
+
+  bool any() const
+  {
+    return this->findFirst() != npos;
+  }
+
+  bool none() const
+  {
+    return !this->any();
+  }
+
+  bool all() const
+  {
+    const uint64_t * w    = this->words;
+    size_t           full = this->size / 64;
+    for (size_t i = 0; i < full; i++)
+    {
+      if (w[i] != ~(uint64_t)0)
+        return false;
+    }
+    return (this->size % 64 == 0) || (w[full] == ((uint64_t)1 << (this->size % 64)) - 1);
+  }
+
+  /**
+    * Index of the first set bit, or `npos`
+    */
+  size_t findFirst() const
+  {
+    const uint64_t * w = this->words;
+    for (size_t i = 0, n = this->getUsedWords(); i < n; i++)
+    {
+      if (w[i] != 0)
+        return i * 64 + Bits::countTrailingZeros(w[i]);
+    }
+    return npos;
+  }
+
+  /**
+    * Index of the first set bit behind `idx`, or `npos`
+    *
+    * Together with `findFirst()` visits all set bits: `for (i = findFirst(); i != npos; i = findNext(i))`.
+    */
+  size_t findNext(size_t idx) const
+  {
+    if (idx + 1 >= this->size)
+      return npos;
+    idx++;
+
+    const uint64_t * w    = this->words;
+    size_t           i    = idx / 64;
+    uint64_t         word = w[i] & (~(uint64_t)0 << (idx % 64));
+    for (size_t n = this->getUsedWords();;)
+    {
+      if (word != 0)
+        return i * 64 + Bits::countTrailingZeros(word);
+      if (++i == n)
+        return npos;
+      word = w[i];
+    }
+  }
+
+  /**
+    * Call `f(idx)` for the index of every set bit, in ascending order
+    */
+  template <typename func> void foreach (func&& f) const
+  {
+    const uint64_t * w = this->words;
+    for (size_t i = 0, n = this->getUsedWords(); i < n; i++)
+    {
+      for (uint64_t word = w[i]; word != 0; word &= word - 1)
+      {
+        f(i * 64 + Bits::countTrailingZeros(word));
+      }
+    }
+  }
+
+  /**
+    * @throws `invalid_argument` if the sizes differ
+    */
+  BitArray& operator&=(const BitArray& other)
+  {
+    return this->combine(other, [](uint64_t a, uint64_t b) { return a & b; });
+  }
+
+  /**
+    * @throws `invalid_argument` if the sizes differ
+    */
+  BitArray& operator|=(const BitArray& other)
+  {
+    return this->combine(other, [](uint64_t a, uint64_t b) { return a | b; });
+  }
+
+  /**
+    * @throws `invalid_argument` if the sizes differ
+    */
+  BitArray& operator^=(const BitArray& other)
+  {
+    return this->combine(other, [](uint64_t a, uint64_t b) { return a ^ b; });
+  }
+
+  /**
+    * Clear all bits set in `other`
+    *
+    * @throws `invalid_argument` if the sizes differ
+    */
+  BitArray& andNot(const BitArray& other)
+  {
+    return this->combine(other, [](uint64_t a, uint64_t b) { return a & ~b; });
+  }
+
+  BitArray operator~() const
+  {
+    BitArray res(*this);
+    res.flip();
+    return res;
+  }
+
+  friend BitArray operator&(BitArray a, const BitArray& b)
+  {
+    return a &= b;
+  }
+
+  friend BitArray operator|(BitArray a, const BitArray& b)
+  {
+    return a |= b;
+  }
+
+  friend BitArray operator^(BitArray a, const BitArray& b)
+  {
+    return a ^= b;
+  }
+
+  bool operator==(const BitArray& other) const
+  {
+    return this->size == other.size && memcmp((const uint64_t *)this->words, (const uint64_t *)other.words,
+                                              this->getUsedWords() * sizeof(uint64_t)) == 0;
+  }
+
+  bool operator!=(const BitArray& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+/**
+  * `BitArray` that grows when bits are added, like `DynamicArray`
+  */
+class DynamicBitArray : public BitArray
+{
+protected:
+  size_t resizeFactor = 2;
+
+  void grow(size_t minBits)
+  {
+    size_t newWords = std::max(wordsFor(minBits), this->words.getSize() * this->resizeFactor);
+
+    Array<uint64_t> tmp(newWords);
+    memcpy((uint64_t *)tmp, (const uint64_t *)this->words, this->getUsedWords() * sizeof(uint64_t));
+    this->words = std::move(tmp);
+  }
+
+public:
+  DynamicBitArray(size_t cap = 64)
+  {
+    this->words = Array<uint64_t>(wordsFor(cap));
+  }
+
+  DynamicBitArray(size_t cap, size_t resizeFactor) : DynamicBitArray(cap)
+  {
+    if (resizeFactor < 2)
+    {
+      throw std::invalid_argument("Dynamic scaling factor must be bigger than 1!");
+    }
+    this->resizeFactor = resizeFactor;
+  }
+
+  /**
+    * Amount of bits that fit without growing
+    */
+  size_t getCap() const
+  {
+    return this->words.getSize() * 64;
+  }
+
+  size_t getResizeFactor() const
+  {
+    return this->resizeFactor;
+  }
+
+  /**
+    * Append a bit
+    */
+  void add(bool value)
+  {
+    if (this->size >= this->getCap())
+      this->grow(this->size + 1);
+
+    ((uint64_t *)this->words)[this->size / 64] |= (uint64_t)value << (this->size % 64);
+    this->size++;
+  }
+
+  /**
+    * Remove the last bit
+    *
+    * @throws `length_error` if the array is already empty.
+    */
+  void remove()
+  {
+    if (this->size == 0)
+    {
+      throw std::length_error("Cannot remove element from empty dynamic bit array!");
+    }
+    this->size--;
+    ((uint64_t *)this->words)[this->size / 64] &= ~((uint64_t)1 << (this->size % 64));
+  }
+
+  /**
+    * Change the size to `newSize` bits, new bits are set to `value`
+    */
+  void resize(size_t newSize, bool value = false)
+  {
+    if (newSize > this->getCap())
+      this->grow(newSize);
+
+    if (newSize <= this->size)
+    {
+      // Unused words must stay 0, so `add` and growing can just set bits
+      size_t oldWords = this->getUsedWords();
+      this->size      = newSize;
+      this->clearTail();
+      memset((uint64_t *)this->words + this->getUsedWords(), 0, (oldWords - this->getUsedWords()) * sizeof(uint64_t));
+      return;
+    }
+
+    size_t oldSize = this->size;
+    this->size     = newSize;
+    if (!value)
+      return;
+
+    uint64_t * w = this->words;
+    size_t     i = oldSize;
+    for (; i % 64 != 0 && i < newSize; i++)
+    {
+      w[i / 64] |= (uint64_t)1 << (i % 64);
+    }
+    if (i < newSize)
+    {
+      memset(w + i / 64, 0xFF, (wordsFor(newSize) - i / 64) * sizeof(uint64_t));
+      this->clearTail();
+    }
+  }
+
+  void clear()
+  {
+    this->resize(0);
+  }
+};
+} // namespace CppUtil
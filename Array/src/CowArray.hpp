@@ -0,0 +1,286 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Array.hpp"
+
+namespace CppUtil
+{
+/**
+  * Fixed size array whose copies share one buffer until one of them is modified
+  *
+  * Copying takes O(1): the copy only increments an atomic reference count of the shared buffer. The first access
+  * through a non-const function (`operator[]`, `getMutableData`) of a shared array detaches it by copying the buffer,
+  * so modifications are never visible in other copies. Const access never copies, so pass `const CowArray&` or use
+  * `std::as_const` where no modification is intended.
+  *
+  * Like `std::shared_ptr`, different `CowArray` objects sharing a buffer may be used from different threads at the
+  * same time, while a single object must not be modified by one thread while another one accesses it.
+  *
+  * @warning References and pointers obtained through non-const access are invalidated by copying the array: writes
+  * through them afterwards would be visible in the copy.
+  */
+template <typename T> class CowArray
+{
+private:
+  struct Buffer
+  {
+    std::atomic<size_t> refs;
+    size_t              size;
+  };
+
+  static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned element types are not supported!");
+
+  // Elements follow the header in the same allocation
+  static constexpr size_t Offset = (sizeof(Buffer) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+  Buffer * buf = nullptr; // nullptr for empty arrays
+
+  static T * items(Buffer * b)
+  {
+    return (T *)((char *)b + Offset);
+  }
+
+  // New unshared buffer for `size` elements, initialized by `init(items)`
+  template <typename Init> static Buffer * allocate(size_t size, Init&& init)
+  {
+    if (size > ARRAY_MAX_SIZE)
+    {
+      throw std::length_error("Size " + std::to_string(size) + " is not a valid array size!");
+    }
+
+    char * mem = new char[Offset + size * sizeof(T)];
+    try
+    {
+      init((T *)(mem + Offset));
+    }
+    catch (...)
+    {
+      delete[] mem;
+      throw;
+    }
+    return new (mem) Buffer{{1}, size};
+  }
+
+  static Buffer * copyOf(const T * items, size_t size)
+  {
+    if (size == 0)
+      return nullptr;
+    return allocate(size, [&](T * dst) { std::uninitialized_copy_n(items, size, dst); });
+  }
+
+  static void release(Buffer * b)
+  {
+    if (b != nullptr && b->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      std::destroy_n(items(b), b->size);
+      b->~Buffer();
+      delete[](char *) b;
+    }
+  }
+
+  // Give this array a buffer of its own before it is modified
+  void detach()
+  {
+    if (this->buf != nullptr && this->buf->refs.load(std::memory_order_acquire) != 1)
+    {
+      Buffer * copy = copyOf(items(this->buf), this->buf->size);
+      release(this->buf);
+      this->buf = copy;
+    }
+  }
+
+  void checkIdx(size_t idx) const
+  {
+    if (idx >= this->getSize())
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for array of size " +
+                              std::to_string(this->getSize()) + "!");
+    }
+  }
+
+public:
+  CowArray() = default;
+
+  /**
+    * Array of `size` value initialized elements
+    *
+    * @throws `length_error` for invalid sizes
+    */
+  explicit CowArray(size_t size)
+  {
+    if (size > 0)
+      this->buf = allocate(size, [&](T * dst) { std::uninitialized_value_construct_n(dst, size); });
+  }
+
+  /**
+    * @throws `length_error` for invalid sizes
+    * @throws `invalid_argument` if `items` is a nullpointer
+    */
+  CowArray(const T * items, size_t size)
+  {
+    if (items == nullptr && size > 0)
+    {
+      throw std::invalid_argument("Buffer must not be a nullpointer!");
+    }
+    this->buf = copyOf(items, size);
+  }
+
+  CowArray(std::initializer_list<T> init) : CowArray(init.begin(), init.size()) {}
+
+  explicit CowArray(const Array<T>& arr) : CowArray((const T *)arr, arr.getSize()) {}
+
+  CowArray(const CowArray<T>& other) noexcept : buf(other.buf)
+  {
+    if (this->buf != nullptr)
+      this->buf->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  CowArray(CowArray<T>&& other) noexcept : buf(other.buf)
+  {
+    other.buf = nullptr;
+  }
+
+  CowArray<T>& operator=(const CowArray<T>& other) noexcept
+  {
+    if (other.buf != nullptr)
+      other.buf->refs.fetch_add(1, std::memory_order_relaxed);
+    release(this->buf);
+    this->buf = other.buf;
+    return *this;
+  }
+
+  CowArray<T>& operator=(CowArray<T>&& other) noexcept
+  {
+    std::swap(this->buf, other.buf);
+    return *this;
+  }
+
+  ~CowArray()
+  {
+    release(this->buf);
+  }
+
+  /**
+    * Element at `idx`, copying the buffer first if it is shared
+    *
+    * @throws `out_of_range` if @param idx is out of bounds
+    */
+  T& operator[](size_t idx)
+  {
+    this->checkIdx(idx);
+    this->detach();
+    return items(this->buf)[idx];
+  }
+
+  /**
+    * @throws `out_of_range` if @param idx is out of bounds
+    */
+  const T& operator[](size_t idx) const
+  {
+    this->checkIdx(idx);
+    return items(this->buf)[idx];
+  }
+
+  size_t getSize() const
+  {
+    return this->buf == nullptr ? 0 : this->buf->size;
+  }
+
+  bool isEmpty() const
+  {
+    return this->buf == nullptr;
+  }
+
+  /**
+    * Pointer to the first element, `nullptr` if empty
+    */
+  const T * getData() const
+  {
+    return this->buf == nullptr ? nullptr : items(this->buf);
+  }
+
+  /**
+    * Pointer to the first element for modifications, copying the buffer first if it is shared
+    */
+  T * getMutableData()
+  {
+    this->detach();
+    return this->buf == nullptr ? nullptr : items(this->buf);
+  }
+
+  /**
+    * Amount of arrays sharing the buffer of this one, 0 if empty
+    */
+  size_t getUseCount() const
+  {
+    return this->buf == nullptr ? 0 : this->buf->refs.load(std::memory_order_relaxed);
+  }
+
+  bool isShared() const
+  {
+    return this->getUseCount() > 1;
+  }
+
+  /**
+    * Whether both arrays share one buffer, so they are equal without comparing elements
+    */
+  bool sharesWith(const CowArray<T>& other) const
+  {
+    return this->buf == other.buf;
+  }
+
+  bool operator==(const CowArray<T>& other) const
+  {
+    if (this->buf == other.buf)
+      return true;
+    if (this->getSize() != other.getSize())
+      return false;
+
+    const T * a = this->getData();
+    const T * b = other.getData();
+    for (size_t i = 0; i < this->getSize(); i++)
+    {
+      if (a[i] != b[i])
+        return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const CowArray<T>& other) const
+  {
+    return !(this->operator==(other));
+  }
+
+  /**
+    * Deep copy into an `Array`
+    */
+  Array<T> toArray() const
+  {
+    Array<T> res(this->getSize());
+    std::copy(this->getData(), this->getData() + this->getSize(), (T *)res);
+    return res;
+  }
+
+  template <typename func> void foreach (const func&& f) const
+  {
+    const T * data = this->getData();
+    for (size_t i = 0; i < this->getSize(); i++)
+    {
+      if constexpr (std::is_invocable_v<func, const T&>)
+        f(data[i]);
+      else if constexpr (std::is_invocable_v<func, const T&, size_t>)
+        f(data[i], i);
+      else
+        static_assert(std::is_invocable_v<func, const T&> || std::is_invocable_v<func, const T&, size_t>,
+                      "Function must have signature 'void(const T&)' or 'void(const T&, size_t)'!");
+    }
+  }
+};
+} // namespace CppUtil
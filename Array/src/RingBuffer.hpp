@@ -0,0 +1,293 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "Array.hpp"
+
+namespace CppUtil
+{
+/**
+  * Double ended queue stored in a circular `Array`
+  *
+  * Adding and removing at both ends is O(1), where `DynamicArray::remove(0)` shifts all following elements. The
+  * capacity is always a power of two and doubles when full, so indices wrap with a mask.
+  */
+template <typename T> class RingBuffer
+{
+protected:
+  Array<T> arr;
+  size_t   head  = 0;
+  size_t   count = 0;
+
+  static size_t roundUpPow2(size_t n)
+  {
+    size_t res = 1;
+    while (res < n)
+    {
+      res *= 2;
+    }
+    return res;
+  }
+
+  size_t mask() const
+  {
+    return this->arr.getSize() - 1;
+  }
+
+  T& at(size_t idx)
+  {
+    return ((T *)this->arr)[(this->head + idx) & this->mask()];
+  }
+
+  const T& at(size_t idx) const
+  {
+    return ((const T *)this->arr)[(this->head + idx) & this->mask()];
+  }
+
+  void checkIdx(size_t idx) const
+  {
+    if (idx >= this->count)
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for ring buffer with " +
+                              std::to_string(this->count) + " elements!");
+    }
+  }
+
+  void checkNotEmpty() const
+  {
+    if (this->count == 0)
+    {
+      throw std::length_error("Cannot access element of empty ring buffer!");
+    }
+  }
+
+  void relocate(size_t newCap)
+  {
+    Array<T> tmp(newCap);
+    T *      dst = tmp;
+    for (size_t i = 0; i < this->count; i++)
+    {
+      dst[i] = std::move(this->at(i));
+    }
+    this->arr  = std::move(tmp);
+    this->head = 0;
+  }
+
+  void growIfFull()
+  {
+    if (this->count == this->arr.getSize())
+      this->relocate(this->arr.getSize() < 2 ? 2 : this->arr.getSize() * 2);
+  }
+
+  // Take the element out of a slot, leaving a default constructed one so resources are released right away
+  static T take(T& slot)
+  {
+    T res = std::move(slot);
+    slot  = T();
+    return res;
+  }
+
+public:
+  RingBuffer<T>(size_t cap = 8)
+  {
+    if (cap > ARRAY_MAX_SIZE)
+    {
+      throw std::length_error("Size " + std::to_string(cap) + " is not a valid array size!");
+    }
+
+    this->arr = Array<T>(roundUpPow2(cap < 2 ? 2 : cap));
+  }
+
+  RingBuffer<T>(const RingBuffer<T>& other)            = default;
+  RingBuffer<T>& operator=(const RingBuffer<T>& other) = default;
+
+  /**
+    * Take over the elements of `other`, leaving it empty with a capacity of 0
+    */
+  RingBuffer<T>(RingBuffer<T>&& other) noexcept : arr(std::move(other.arr)), head(other.head), count(other.count)
+  {
+    other.head  = 0;
+    other.count = 0;
+  }
+
+  RingBuffer<T>& operator=(RingBuffer<T>&& other) noexcept
+  {
+    if (&other != this)
+    {
+      this->arr   = std::move(other.arr);
+      this->head  = other.head;
+      this->count = other.count;
+      other.head  = 0;
+      other.count = 0;
+    }
+    return *this;
+  }
+
+  size_t getCount() const
+  {
+    return this->count;
+  }
+
+  size_t getCap() const
+  {
+    return this->arr.getSize();
+  }
+
+  bool isEmpty() const
+  {
+    return this->count == 0;
+  }
+
+  /**
+    * Grow the capacity to at least `cap` elements
+    *
+    * @throws `length_error` for invalid sizes
+    */
+  void reserve(size_t cap)
+  {
+    if (cap > ARRAY_MAX_SIZE)
+    {
+      throw std::length_error("Size " + std::to_string(cap) + " is not a valid array size!");
+    }
+
+    if (cap > this->arr.getSize())
+      this->relocate(roundUpPow2(cap));
+  }
+
+  void pushBack(T item)
+  {
+    this->growIfFull();
+    this->at(this->count) = std::move(item);
+    this->count++;
+  }
+
+  void pushFront(T item)
+  {
+    this->growIfFull();
+    this->head  = (this->head - 1) & this->mask();
+    this->at(0) = std::move(item);
+    this->count++;
+  }
+
+  /**
+    * Remove and return the last element
+    *
+    * @throws `length_error` if the buffer is empty.
+    */
+  T popBack()
+  {
+    this->checkNotEmpty();
+    this->count--;
+    return take(this->at(this->count));
+  }
+
+  /**
+    * Remove and return the first element
+    *
+    * @throws `length_error` if the buffer is empty.
+    */
+  T popFront()
+  {
+    this->checkNotEmpty();
+    T res      = take(this->at(0));
+    this->head = (this->head + 1) & this->mask();
+    this->count--;
+    return res;
+  }
+
+  /**
+    * @throws `length_error` if the buffer is empty.
+    */
+  T& front()
+  {
+    this->checkNotEmpty();
+    return this->at(0);
+  }
+
+  const T& front() const
+  {
+    this->checkNotEmpty();
+    return this->at(0);
+  }
+
+  /**
+    * @throws `length_error` if the buffer is empty.
+    */
+  T& back()
+  {
+    this->checkNotEmpty();
+    return this->at(this->count - 1);
+  }
+
+  const T& back() const
+  {
+    this->checkNotEmpty();
+    return this->at(this->count - 1);
+  }
+
+  /**
+    * Element `idx` counted from the front
+    *
+    * @throws `out_of_range` if `idx` is out of bounds
+    */
+  T& operator[](size_t idx)
+  {
+    this->checkIdx(idx);
+    return this->at(idx);
+  }
+
+  const T& operator[](size_t idx) const
+  {
+    this->checkIdx(idx);
+    return this->at(idx);
+  }
+
+  /**
+    * Remove all elements, keeping the capacity
+    */
+  void clear()
+  {
+    while (this->count > 0)
+    {
+      this->popBack();
+    }
+    this->head = 0;
+  }
+
+  /**
+    * Call `f` for every element from front to back, as `f(item)` or `f(item, idx)`
+    */
+  template <typename func> void foreach (func&& f)
+  {
+    for (size_t i = 0; i < this->count; i++)
+    {
+      if constexpr (std::is_invocable_v<func, T&>)
+        f(this->at(i));
+      else if constexpr (std::is_invocable_v<func, T&, size_t>)
+        f(this->at(i), i);
+      else
+        static_assert(std::is_invocable_v<func, T&> || std::is_invocable_v<func, T&, size_t>,
+                      "Function must have signature 'void(T&)' or 'void(T&, size_t)'!");
+    }
+  }
+
+  Array<T> toArray() const
+  {
+    Array<T> res(this->count);
+    T *      dst = res;
+    for (size_t i = 0; i < this->count; i++)
+    {
+      dst[i] = this->at(i);
+    }
+    return res;
+  }
+};
+
+/**
+  * `RingBuffer` used as double ended queue
+  */
+template <typename T> using Deque = RingBuffer<T>;
+} // namespace CppUtil
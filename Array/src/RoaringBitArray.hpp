@@ -0,0 +1,490 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BitArray.hpp"
+
+namespace CppUtil
+{
+/**
+  * Compressed set of 32 bit values, for sparse bit arrays (Roaring bitmap)
+  *
+  * Values are grouped by their upper 16 bits into containers. A container holds its lower 16 bits as sorted array
+  * while it has at most `ArrayLimit` values, and as bitmap of 2^16 bits (8 KiB) beyond that, so sparse ranges cost
+  * 2 bytes per value and dense ones a bit per possible value. Set operations combine matching containers only.
+  */
+class RoaringBitArray
+{
+public:
+  static constexpr size_t npos = BitArray::npos;
+
+  // Containers with more values than this are stored as bitmap
+  static constexpr size_t ArrayLimit = 4096;
+
+protected:
+  static constexpr size_t BitmapWords = (1 << 16) / 64;
+
+  enum class Op
+  {
+    And,
+    Or,
+    Xor
+  };
+
+  struct Container
+  {
+    uint16_t              key   = 0;
+    uint32_t              count = 0;
+    std::vector<uint16_t> values; // Sorted, used as long as `bits` is empty
+    std::vector<uint64_t> bits;
+
+    bool isBitmap() const
+    {
+      return !this->bits.empty();
+    }
+
+    bool contains(uint16_t v) const
+    {
+      if (this->isBitmap())
+        return (this->bits[v / 64] >> (v % 64)) & 1;
+      return std::binary_search(this->values.begin(), this->values.end(), v);
+    }
+
+    void add(uint16_t v)
+    {
+      if (this->isBitmap())
+      {
+        uint64_t bit = (uint64_t)1 << (v % 64);
+        this->count += (this->bits[v / 64] & bit) ? 0 : 1;
+        this->bits[v / 64] |= bit;
+        return;
+      }
+
+      // Values are commonly added in ascending order, which appends
+      if (this->values.empty() || this->values.back() < v)
+      {
+        this->values.push_back(v);
+      }
+      else
+      {
+        auto it = std::lower_bound(this->values.begin(), this->values.end(), v);
+        if (*it == v)
+          return;
+        this->values.insert(it, v);
+      }
+      this->count++;
+      this->normalize();
+    }
+
+    void remove(uint16_t v)
+    {
+      if (this->isBitmap())
+      {
+        uint64_t bit = (uint64_t)1 << (v % 64);
+        this->count -= (this->bits[v / 64] & bit) ? 1 : 0;
+        this->bits[v / 64] &= ~bit;
+        this->normalize();
+        return;
+      }
+
+      auto it = std::lower_bound(this->values.begin(), this->values.end(), v);
+      if (it == this->values.end() || *it != v)
+        return;
+      this->values.erase(it);
+      this->count--;
+    }
+
+    // Switch the representation if the count crossed `ArrayLimit`
+    void normalize()
+    {
+      if (this->isBitmap() && this->count <= ArrayLimit)
+      {
+        std::vector<uint16_t> tmp;
+        tmp.reserve(this->count);
+        this->foreach ([&](uint16_t v) { tmp.push_back(v); });
+        this->values = std::move(tmp);
+        this->bits   = std::vector<uint64_t>();
+      }
+      else if (!this->isBitmap() && this->count > ArrayLimit)
+      {
+        this->fillBits(this->bits);
+        this->values = std::vector<uint16_t>();
+      }
+    }
+
+    void fillBits(std::vector<uint64_t>& out) const
+    {
+      if (this->isBitmap())
+      {
+        out = this->bits;
+        return;
+      }
+
+      out.assign(BitmapWords, 0);
+      for (uint16_t v : this->values)
+      {
+        out[v / 64] |= (uint64_t)1 << (v % 64);
+      }
+    }
+
+    // First value >= `from`, or `npos`
+    size_t findFrom(uint32_t from) const
+    {
+      if (from > 0xFFFF)
+        return npos;
+
+      if (!this->isBitmap())
+      {
+        auto it = std::lower_bound(this->values.begin(), this->values.end(), from);
+        return (it == this->values.end()) ? npos : *it;
+      }
+
+      size_t   i    = from / 64;
+      uint64_t word = this->bits[i] & (~(uint64_t)0 << (from % 64));
+      while (true)
+      {
+        if (word != 0)
+          return i * 64 + Bits::countTrailingZeros(word);
+        if (++i == BitmapWords)
+          return npos;
+        word = this->bits[i];
+      }
+    }
+
+    template <typename func> void foreach (func&& f) const
+    {
+      if (!this->isBitmap())
+      {
+        for (uint16_t v : this->values)
+        {
+          f(v);
+        }
+        return;
+      }
+
+      for (size_t i = 0; i < BitmapWords; i++)
+      {
+        for (uint64_t word = this->bits[i]; word != 0; word &= word - 1)
+        {
+          f((uint16_t)(i * 64 + Bits::countTrailingZeros(word)));
+        }
+      }
+    }
+
+    bool operator==(const Container& other) const
+    {
+      return this->key == other.key && this->count == other.count && this->values == other.values &&
+             this->bits == other.bits;
+    }
+  };
+
+  std::vector<Container> containers; // Sorted by key
+
+  size_t lowerBound(uint16_t key) const
+  {
+    auto it = std::lower_bound(this->containers.begin(), this->containers.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    return (size_t)(it - this->containers.begin());
+  }
+
+  static Container combineArrays(const Container& a, const Container& b, Op op)
+  {
+    Container res;
+    res.key = a.key;
+
+    auto& out = res.values;
+    out.reserve((op == Op::And) ? std::min(a.count, b.count) : (size_t)a.count + b.count);
+
+    size_t i = 0, j = 0;
+    while (i < a.values.size() && j < b.values.size())
+    {
+      uint16_t x = a.values[i], y = b.values[j];
+      if (x == y)
+      {
+        if (op != Op::Xor)
+          out.push_back(x);
+        i++;
+        j++;
+      }
+      else if (x < y)
+      {
+        if (op != Op::And)
+          out.push_back(x);
+        i++;
+      }
+      else
+      {
+        if (op != Op::And)
+          out.push_back(y);
+        j++;
+      }
+    }
+    if (op != Op::And)
+    {
+      out.insert(out.end(), a.values.begin() + i, a.values.end());
+      out.insert(out.end(), b.values.begin() + j, b.values.end());
+    }
+
+    res.count = (uint32_t)out.size();
+    res.normalize();
+    return res;
+  }
+
+  static Container combine(const Container& a, const Container& b, Op op)
+  {
+    if (!a.isBitmap() && !b.isBitmap())
+      return combineArrays(a, b, op);
+
+    Container res;
+    res.key = a.key;
+
+    // Intersecting with an array only has to probe the array's values
+    if (op == Op::And && (!a.isBitmap() || !b.isBitmap()))
+    {
+      const Container& arr = a.isBitmap() ? b : a;
+      const Container& map = a.isBitmap() ? a : b;
+      for (uint16_t v : arr.values)
+      {
+        if (map.contains(v))
+          res.values.push_back(v);
+      }
+      res.count = (uint32_t)res.values.size();
+      return res;
+    }
+
+    std::vector<uint64_t> other;
+    a.fillBits(res.bits);
+    b.fillBits(other);
+    for (size_t i = 0; i < BitmapWords; i++)
+    {
+      if (op == Op::And)
+        res.bits[i] &= other[i];
+      else if (op == Op::Or)
+        res.bits[i] |= other[i];
+      else
+        res.bits[i] ^= other[i];
+    }
+    res.count = (uint32_t)Bits::count(res.bits.data(), BitmapWords);
+    res.normalize();
+    return res;
+  }
+
+  static RoaringBitArray combine(const RoaringBitArray& a, const RoaringBitArray& b, Op op)
+  {
+    RoaringBitArray res;
+
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() && j < b.containers.size())
+    {
+      const Container& x = a.containers[i];
+      const Container& y = b.containers[j];
+      if (x.key == y.key)
+      {
+        Container c = combine(x, y, op);
+        if (c.count > 0)
+          res.containers.push_back(std::move(c));
+        i++;
+        j++;
+      }
+      else if (x.key < y.key)
+      {
+        if (op != Op::And)
+          res.containers.push_back(x);
+        i++;
+      }
+      else
+      {
+        if (op != Op::And)
+          res.containers.push_back(y);
+        j++;
+      }
+    }
+    if (op != Op::And)
+    {
+      res.containers.insert(res.containers.end(), a.containers.begin() + i, a.containers.end());
+      res.containers.insert(res.containers.end(), b.containers.begin() + j, b.containers.end());
+    }
+    return res;
+  }
+
+public:
+  RoaringBitArray() {}
+
+  /**
+    * Set holding the indices of all set bits of `bits`
+    *
+    * @throws `length_error` if `bits` has indices not representable in 32 bits
+    */
+  RoaringBitArray(const BitArray& bits)
+  {
+    if (bits.getSize() > ((size_t)1 << 32))
+    {
+      throw std::length_error("Bit array of size " + std::to_string(bits.getSize()) +
+                              " does not fit into 32 bit values!");
+    }
+    bits.foreach ([&](size_t idx) { this->add((uint32_t)idx); });
+  }
+
+  /**
+    * Amount of values in the set
+    */
+  size_t getCount() const
+  {
+    size_t res = 0;
+    for (auto& c : this->containers)
+    {
+      res += c.count;
+    }
+    return res;
+  }
+
+  bool isEmpty() const
+  {
+    return this->containers.empty();
+  }
+
+  /**
+    * Approximate amount of heap memory used, in bytes
+    */
+  size_t getMemoryUsage() const
+  {
+    size_t res = this->containers.capacity() * sizeof(Container);
+    for (auto& c : this->containers)
+    {
+      res += c.values.capacity() * sizeof(uint16_t) + c.bits.capacity() * sizeof(uint64_t);
+    }
+    return res;
+  }
+
+  bool contains(uint32_t value) const
+  {
+    size_t i = this->lowerBound((uint16_t)(value >> 16));
+    return i < this->containers.size() && this->containers[i].key == (value >> 16) &&
+           this->containers[i].contains((uint16_t)value);
+  }
+
+  void add(uint32_t value)
+  {
+    uint16_t key = (uint16_t)(value >> 16);
+
+    // Ascending insertion only ever touches the last container
+    size_t i = (!this->containers.empty() && this->containers.back().key <= key) ? this->containers.size() - 1 :
+                                                                                   this->lowerBound(key);
+    if (i == this->containers.size() || this->containers[i].key != key)
+    {
+      if (i < this->containers.size() && this->containers[i].key < key)
+        i++;
+
+      Container c;
+      c.key = key;
+      this->containers.insert(this->containers.begin() + i, std::move(c));
+    }
+    this->containers[i].add((uint16_t)value);
+  }
+
+  /**
+    * Remove `value` from the set, does nothing if it is not contained
+    */
+  void remove(uint32_t value)
+  {
+    size_t i = this->lowerBound((uint16_t)(value >> 16));
+    if (i == this->containers.size() || this->containers[i].key != (value >> 16))
+      return;
+
+    this->containers[i].remove((uint16_t)value);
+    if (this->containers[i].count == 0)
+      this->containers.erase(this->containers.begin() + i);
+  }
+
+  void clear()
+  {
+    this->containers.clear();
+  }
+
+  /**
+    * Smallest value in the set, or `npos`
+    */
+  size_t findFirst() const
+  {
+    if (this->containers.empty())
+      return npos;
+    return ((size_t)this->containers[0].key << 16) | this->containers[0].findFrom(0);
+  }
+
+  /**
+    * Smallest value in the set bigger than `value`, or `npos`
+    */
+  size_t findNext(uint32_t value) const
+  {
+    uint16_t key = (uint16_t)(value >> 16);
+    size_t   i   = this->lowerBound(key);
+    if (i < this->containers.size() && this->containers[i].key == key)
+    {
+      size_t low = this->containers[i].findFrom((value & 0xFFFF) + 1);
+      if (low != npos)
+        return ((size_t)key << 16) | low;
+      i++;
+    }
+
+    if (i == this->containers.size())
+      return npos;
+    return ((size_t)this->containers[i].key << 16) | this->containers[i].findFrom(0);
+  }
+
+  /**
+    * Call `f(value)` for every value in the set, in ascending order
+    */
+  template <typename func> void foreach (func&& f) const
+  {
+    for (auto& c : this->containers)
+    {
+      uint32_t high = (uint32_t)c.key << 16;
+      c.foreach ([&](uint16_t low) { f(high | low); });
+    }
+  }
+
+  RoaringBitArray& operator&=(const RoaringBitArray& other)
+  {
+    return *this = combine(*this, other, Op::And);
+  }
+
+  RoaringBitArray& operator|=(const RoaringBitArray& other)
+  {
+    return *this = combine(*this, other, Op::Or);
+  }
+
+  RoaringBitArray& operator^=(const RoaringBitArray& other)
+  {
+    return *this = combine(*this, other, Op::Xor);
+  }
+
+  friend RoaringBitArray operator&(const RoaringBitArray& a, const RoaringBitArray& b)
+  {
+    return combine(a, b, Op::And);
+  }
+
+  friend RoaringBitArray operator|(const RoaringBitArray& a, const RoaringBitArray& b)
+  {
+    return combine(a, b, Op::Or);
+  }
+
+  friend RoaringBitArray operator^(const RoaringBitArray& a, const RoaringBitArray& b)
+  {
+    return combine(a, b, Op::Xor);
+  }
+
+  bool operator==(const RoaringBitArray& other) const
+  {
+    return this->containers == other.containers;
+  }
+
+  bool operator!=(const RoaringBitArray& other) const
+  {
+    return !(*this == other);
+  }
+};
+} // namespace CppUtil
@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "Array.hpp"
+
+namespace CppUtil
+{
+/**
+  * Dynamic array storing up to `N` elements inline before spilling to the heap
+  *
+  * Short lists, like the temporary results of parsers, never allocate. Unlike `DynamicArray`, elements are only
+  * constructed when added, and the capacity does not shrink when removing; `shrinkToFit` moves the elements back
+  * inline once they fit. Offers the `foreach` / `all` / `any` / `find` API of `DynamicArray`.
+  *
+  * @warning Moving an array with inline elements moves the elements one by one, so pointers to them are invalidated.
+  */
+template <typename T, size_t N> class SmallDynamicArray
+{
+  static_assert(N > 0, "Inline capacity must be at least 1, use DynamicArray otherwise!");
+
+private:
+  alignas(T) unsigned char storage[N * sizeof(T)];
+  T *    items = (T *)storage;
+  size_t count = 0;
+  size_t cap   = N;
+
+  bool isOwnElement(const T * item) const
+  {
+    return item >= this->items && item < this->items + this->count;
+  }
+
+  // Move the elements into a buffer for `newCap` elements, inline if they fit
+  void reallocate(size_t newCap)
+  {
+    if (newCap > ARRAY_MAX_SIZE)
+    {
+      throw std::length_error("Size " + std::to_string(newCap) + " is not a valid array size!");
+    }
+
+    T * buf = newCap <= N ? (T *)this->storage : (T *)new unsigned char[newCap * sizeof(T)];
+    if (buf == this->items)
+      return;
+
+    try
+    {
+      std::uninitialized_move_n(this->items, this->count, buf);
+    }
+    catch (...)
+    {
+      if (buf != (T *)this->storage)
+        delete[](unsigned char *) buf;
+      throw;
+    }
+    std::destroy_n(this->items, this->count);
+    this->freeHeap();
+    this->items = buf;
+    this->cap   = std::max(newCap, N);
+  }
+
+  void reserveFor(size_t needed)
+  {
+    if (needed > this->cap)
+      this->reallocate(std::max(needed, this->cap * 2));
+  }
+
+  void freeHeap()
+  {
+    if (!this->isInline())
+      delete[](unsigned char *) this->items;
+  }
+
+  // Take the elements of `other` while this array is empty and inline, leaving `other` empty and inline
+  void takeFrom(SmallDynamicArray<T, N>& other)
+  {
+    if (other.isInline())
+    {
+      std::uninitialized_move_n(other.items, other.count, this->items);
+      this->count = other.count;
+      other.clear();
+    }
+    else
+    {
+      this->items = other.items;
+      this->count = other.count;
+      this->cap   = other.cap;
+
+      other.items = (T *)other.storage;
+      other.count = 0;
+      other.cap   = N;
+    }
+  }
+
+  void checkIdx(size_t idx) const
+  {
+    if (idx >= this->count)
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for dynamic array with " +
+                              std::to_string(this->count) + " elements!");
+    }
+  }
+
+public:
+  SmallDynamicArray() = default;
+
+  SmallDynamicArray(std::initializer_list<T> init)
+  {
+    this->addRange(init.begin(), init.size());
+  }
+
+  SmallDynamicArray(const SmallDynamicArray<T, N>& other)
+  {
+    this->addRange(other.items, other.count);
+  }
+
+  SmallDynamicArray(SmallDynamicArray<T, N>&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+  {
+    this->takeFrom(other);
+  }
+
+  SmallDynamicArray<T, N>& operator=(const SmallDynamicArray<T, N>& other)
+  {
+    if (&other != this)
+    {
+      this->clear();
+      this->addRange(other.items, other.count);
+    }
+    return *this;
+  }
+
+  SmallDynamicArray<T, N>& operator=(SmallDynamicArray<T, N>&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+  {
+    if (&other != this)
+    {
+      this->clear();
+      this->freeHeap();
+      this->items = (T *)this->storage;
+      this->cap   = N;
+      this->takeFrom(other);
+    }
+    return *this;
+  }
+
+  ~SmallDynamicArray()
+  {
+    this->clear();
+    this->freeHeap();
+  }
+
+  /**
+    * @throws `out_of_range` if @param idx is out of bounds
+    */
+  T& operator[](size_t idx)
+  {
+    this->checkIdx(idx);
+    return this->items[idx];
+  }
+
+  const T& operator[](size_t idx) const
+  {
+    this->checkIdx(idx);
+    return this->items[idx];
+  }
+
+  size_t getCount() const
+  {
+    return this->count;
+  }
+
+  size_t getCap() const
+  {
+    return this->cap;
+  }
+
+  static constexpr size_t getInlineCap()
+  {
+    return N;
+  }
+
+  bool isEmpty() const
+  {
+    return this->count == 0;
+  }
+
+  /**
+    * Whether the elements are stored inline, i.e. the array never spilled to the heap or was shrunk back
+    */
+  bool isInline() const
+  {
+    return this->items == (const T *)this->storage;
+  }
+
+  /**
+    * Get a pointer to the first element
+    *
+    * @warning The pointer is invalidated by any operation changing the capacity.
+    */
+  const T * getData() const
+  {
+    return this->items;
+  }
+
+  T * begin()
+  {
+    return this->items;
+  }
+
+  T * end()
+  {
+    return this->items + this->count;
+  }
+
+  const T * begin() const
+  {
+    return this->items;
+  }
+
+  const T * end() const
+  {
+    return this->items + this->count;
+  }
+
+  /**
+    * Make room for at least `cap` elements
+    *
+    * @throws `length_error` for invalid sizes
+    */
+  void reserve(size_t cap)
+  {
+    if (cap > this->cap)
+      this->reallocate(cap);
+  }
+
+  void add(T item)
+  {
+    this->reserveFor(this->count + 1);
+    new (this->items + this->count) T(std::move(item));
+    this->count++;
+  }
+
+  /**
+    * Insert `item` before index @param idx
+    *
+    * @throws `out_of_range` if @param idx is behind the last element
+    */
+  void add(T item, size_t idx)
+  {
+    if (idx > this->count)
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for dynamic array with " +
+                              std::to_string(this->count) + " elements!");
+    }
+
+    this->add(std::move(item));
+    std::rotate(this->items + idx, this->items + this->count - 1, this->items + this->count);
+  }
+
+  /**
+    * Append the `n` elements at `items`, growing at most once
+    *
+    * @throws `invalid_argument` if `items` is a nullpointer
+    */
+  void addRange(const T * items, size_t n)
+  {
+    if (items == nullptr)
+    {
+      if (n == 0)
+        return;
+      throw std::invalid_argument("Buffer must not be a nullpointer!");
+    }
+
+    // Growing would invalidate a range inside the array itself
+    if (n > 0 && this->isOwnElement(items) && this->count + n > this->cap)
+    {
+      SmallDynamicArray<T, N> copy;
+      copy.addRange(items, n);
+      return this->addRange(copy.items, n);
+    }
+
+    this->reserveFor(this->count + n);
+    std::uninitialized_copy_n(items, n, this->items + this->count);
+    this->count += n;
+  }
+
+  void append(const Array<T>& items)
+  {
+    this->addRange(items, items.getSize());
+  }
+
+  template <size_t M> void append(const SmallDynamicArray<T, M>& items)
+  {
+    this->addRange(items.getData(), items.getCount());
+  }
+
+  /**
+    * Remove the last element
+    *
+    * @throws `length_error` if the array is already empty.
+    */
+  void remove()
+  {
+    if (this->count == 0)
+    {
+      throw std::length_error("Cannot remove element from empty dynamic array!");
+    }
+
+    this->items[--this->count].~T();
+  }
+
+  /**
+    * Remove the element at index @param idx, shifting all following elements to the left
+    *
+    * @throws `out_of_range` if @param idx is out of bounds
+    */
+  void remove(size_t idx)
+  {
+    this->checkIdx(idx);
+    std::move(this->items + idx + 1, this->items + this->count, this->items + idx);
+    this->remove();
+  }
+
+  /**
+    * Remove all elements for which `pred` returns true, keeping the order of the others
+    *
+    * @return The amount of removed elements
+    */
+  template <typename func> size_t eraseIf(func&& pred)
+  {
+    T *    end  = std::remove_if(this->items, this->items + this->count, pred);
+    size_t kept = (size_t)(end - this->items);
+
+    size_t removed = this->count - kept;
+    std::destroy(end, this->items + this->count);
+    this->count = kept;
+    return removed;
+  }
+
+  /**
+    * Remove all elements, keeping the capacity
+    */
+  void clear()
+  {
+    std::destroy_n(this->items, this->count);
+    this->count = 0;
+  }
+
+  /**
+    * Release unused heap capacity, moving the elements back inline if they fit
+    */
+  void shrinkToFit()
+  {
+    if (!this->isInline() && this->count < this->cap)
+      this->reallocate(this->count);
+  }
+
+  Array<size_t> find(const T& el) const
+  {
+    DynamicArray<size_t> res;
+    for (size_t i = 0; i < this->count; i++)
+    {
+      if (this->items[i] == el)
+        res.add(i);
+    }
+    return res.toArray();
+  }
+
+  bool has(const T& el) const
+  {
+    return std::find(this->items, this->items + this->count, el) != this->items + this->count;
+  }
+
+  template <typename func> void foreach (func&& f)
+  {
+    for (size_t i = 0; i < this->count; i++)
+    {
+      if constexpr (std::is_invocable_v<func, T&>)
+        f(this->items[i]);
+      else if constexpr (std::is_invocable_v<func, T&, size_t>)
+        f(this->items[i], i);
+      else
+        static_assert(std::is_invocable_v<func, T&> || std::is_invocable_v<func, T&, size_t>,
+                      "Function must have signature 'void(T&)' or 'void(T&, size_t)'!");
+    }
+  }
+
+  template <typename func> void foreach (func&& f) const
+  {
+    for (size_t i = 0; i < this->count; i++)
+    {
+      if constexpr (std::is_invocable_v<func, const T&>)
+        f(this->items[i]);
+      else if constexpr (std::is_invocable_v<func, const T&, size_t>)
+        f(this->items[i], i);
+      else
+        static_assert(std::is_invocable_v<func, const T&> || std::is_invocable_v<func, const T&, size_t>,
+                      "Function must have signature 'void(const T&)' or 'void(const T&, size_t)'!");
+    }
+  }
+
+  template <typename func> bool all(func&& f) const
+  {
+    for (size_t i = 0; i < this->count; i++)
+    {
+      if constexpr (std::is_invocable_r_v<bool, func, const T&>)
+      {
+        if (!f(this->items[i]))
+          return false;
+      }
+      else if constexpr (std::is_invocable_r_v<bool, func, const T&, size_t>)
+      {
+        if (!f(this->items[i], i))
+          return false;
+      }
+      else
+      {
+        static_assert(std::is_invocable_r_v<bool, func, const T&> ||
+                        std::is_invocable_r_v<bool, func, const T&, size_t>,
+                      "Function must have signature 'bool(const T&)' or 'bool(const T&, size_t)'!");
+      }
+    }
+    return true;
+  }
+
+  template <typename func> bool any(func&& f) const
+  {
+    for (size_t i = 0; i < this->count; i++)
+    {
+      if constexpr (std::is_invocable_r_v<bool, func, const T&>)
+      {
+        if (f(this->items[i]))
+          return true;
+      }
+      else if constexpr (std::is_invocable_r_v<bool, func, const T&, size_t>)
+      {
+        if (f(this->items[i], i))
+          return true;
+      }
+      else
+      {
+        static_assert(std::is_invocable_r_v<bool, func, const T&> ||
+                        std::is_invocable_r_v<bool, func, const T&, size_t>,
+                      "Function must have signature 'bool(const T&)' or 'bool(const T&, size_t)'!");
+      }
+    }
+    return false;
+  }
+
+  Array<T> toArray() const
+  {
+    Array<T> res(this->count);
+    std::copy(this->items, this->items + this->count, (T *)res);
+    return res;
+  }
+};
+} // namespace CppUtil
@@ -0,0 +1,486 @@
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Array.hpp"
+#include "Async.hpp"
+
+namespace CppUtil
+{
+/**
+  * Growable table storing every field in its own contiguous `Array` column (structure of arrays)
+  *
+  * Scanning one field only touches the memory of that field, where `DynamicArray<Record>` drags whole records
+  * through the cache. Rows are appended with a single `add` and read back as tuples of references, so
+  * `auto [id, qty] = table[i];` binds to the stored values.
+  */
+template <typename... Fields> class SoAArray
+{
+  static_assert(sizeof...(Fields) > 0, "SoAArray needs at least one field!");
+
+public:
+  using Row      = std::tuple<Fields&...>;
+  using ConstRow = std::tuple<const Fields&...>;
+
+  template <size_t I> using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+  // Parallel scans do not split below this amount of rows per job
+  static constexpr size_t MinChunkSize = 1 << 16;
+
+protected:
+  std::tuple<Array<Fields>...> columns;
+
+  size_t count        = 0;
+  size_t cap          = 0;
+  size_t resizeFactor = 2;
+
+  template <size_t I> FieldType<I> * column() const
+  {
+    return std::get<I>(this->columns);
+  }
+
+  void checkIdx(size_t idx) const
+  {
+    if (idx >= this->count)
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for table with " +
+                              std::to_string(this->count) + " rows!");
+    }
+  }
+
+  template <size_t I> void moveColumn(size_t newCap)
+  {
+    Array<FieldType<I>> tmp(newCap);
+    std::move(this->column<I>(), this->column<I>() + this->count, (FieldType<I> *)tmp);
+    std::get<I>(this->columns) = std::move(tmp);
+  }
+
+  template <size_t... I> void moveColumns(size_t newCap, std::index_sequence<I...>)
+  {
+    (this->moveColumn<I>(newCap), ...);
+  }
+
+  template <size_t... I> void setRow(size_t idx, std::index_sequence<I...>, Fields&&... values)
+  {
+    ((this->column<I>()[idx] = std::move(values)), ...);
+  }
+
+  template <size_t... I> void eraseRow(size_t idx, std::index_sequence<I...>)
+  {
+    (std::move(this->column<I>() + idx + 1, this->column<I>() + this->count, this->column<I>() + idx), ...);
+  }
+
+  template <size_t... I> Row rowAt(size_t idx, std::index_sequence<I...>)
+  {
+    return Row(this->column<I>()[idx]...);
+  }
+
+  template <size_t... I> ConstRow rowAt(size_t idx, std::index_sequence<I...>) const
+  {
+    return ConstRow(this->column<I>()[idx]...);
+  }
+
+  template <typename func, size_t... I> void callRow(func& f, size_t idx, std::index_sequence<I...>)
+  {
+    if constexpr (std::is_invocable_v<func&, Fields&...>)
+      f(this->column<I>()[idx]...);
+    else if constexpr (std::is_invocable_v<func&, Fields&..., size_t>)
+      f(this->column<I>()[idx]..., idx);
+    else
+      static_assert(std::is_invocable_v<func&, Fields&...> || std::is_invocable_v<func&, Fields&..., size_t>,
+                    "Function must have signature 'void(Fields&...)' or 'void(Fields&..., size_t)'!");
+  }
+
+  /**
+    * Append the indices in [begin, end) whose value in `col` satisfies `pred` to `out`
+    *
+    * Indices are written unconditionally and only counted when they match, so the loop does not branch on `pred`.
+    */
+  template <typename T, typename func>
+  static void collectIf(const T * col, size_t begin, size_t end, func& pred, std::vector<size_t>& out)
+  {
+    size_t   n   = out.size();
+    size_t   cap = out.size();
+    size_t * buf = out.data();
+    for (size_t i = begin; i < end; i++)
+    {
+      // Work on locals, stores through `buf` could otherwise alias the vector's own members
+      if (n == cap)
+      {
+        out.resize(std::max<size_t>(1'024, cap * 2));
+        cap = out.size();
+        buf = out.data();
+      }
+      buf[n] = i;
+      n += pred(col[i]) ? 1 : 0;
+    }
+    out.resize(n);
+  }
+
+  /**
+    * Split the rows into chunks and call `f(begin, end, chunk)` for each of them, using `pool` and the calling thread
+    *
+    * Waits for all chunks, then rethrows the first exception thrown by any of them.
+    *
+    * @return The amount of chunks
+    */
+  template <typename func> size_t runChunks(ThreadPool& pool, const func& f) const
+  {
+    size_t rows   = this->count;
+    size_t chunks = std::max<size_t>(1, std::min(pool.getSize() * 4, (rows + MinChunkSize - 1) / MinChunkSize));
+
+    std::vector<Promise<void>> pending;
+    pending.reserve(chunks);
+    for (size_t c = 1; c < chunks; c++)
+    {
+      Future<void> done;
+      pending.push_back(done.asPromise());
+      pool.submit(
+        [&f, done, c, chunks, rows](bool) mutable
+        {
+          try
+          {
+            f(rows * c / chunks, rows * (c + 1) / chunks, c);
+          }
+          catch (...)
+          {
+            done.setThrow(std::current_exception());
+          }
+          done.finish();
+        });
+    }
+
+    std::exception_ptr exc;
+    try
+    {
+      f(0, rows / chunks, 0);
+    }
+    catch (...)
+    {
+      exc = std::current_exception();
+    }
+
+    // Chunks reference `f`, so all of them have to be done before anything is rethrown
+    for (auto& p : pending)
+    {
+      p.wait();
+    }
+    if (exc)
+      std::rethrow_exception(exc);
+    for (auto& p : pending)
+    {
+      p.get();
+    }
+    return chunks;
+  }
+
+public:
+  SoAArray<Fields...>(size_t cap = 2, size_t resizeFactor = 2) : columns(Array<Fields>(cap)...)
+  {
+    if (resizeFactor < 2)
+    {
+      throw std::invalid_argument("Dynamic scaling factor must be bigger than 1!");
+    }
+
+    this->cap          = cap;
+    this->resizeFactor = resizeFactor;
+  }
+
+  size_t getCount() const
+  {
+    return this->count;
+  }
+
+  size_t getCap() const
+  {
+    return this->cap;
+  }
+
+  size_t getResizeFactor() const
+  {
+    return this->resizeFactor;
+  }
+
+  bool isEmpty() const
+  {
+    return this->count == 0;
+  }
+
+  /**
+    * Grow the capacity of all columns to at least `newCap` rows
+    *
+    * @throws `length_error` for invalid sizes
+    */
+  void reserve(size_t newCap)
+  {
+    if (newCap > ARRAY_MAX_SIZE)
+    {
+      throw std::length_error("Size " + std::to_string(newCap) + " is not a valid array size!");
+    }
+
+    if (newCap <= this->cap)
+      return;
+
+    this->moveColumns(newCap, std::index_sequence_for<Fields...>());
+    this->cap = newCap;
+  }
+
+  /**
+    * Append a row, one value per field
+    */
+  void add(Fields... values)
+  {
+    if (this->count >= this->cap)
+    {
+      this->reserve(std::max<size_t>(2, this->cap * this->resizeFactor));
+    }
+
+    this->setRow(this->count, std::index_sequence_for<Fields...>(), std::move(values)...);
+    this->count++;
+  }
+
+  /**
+    * Remove the last row
+    *
+    * @throws `length_error` if the table is already empty.
+    */
+  void remove()
+  {
+    if (this->count == 0)
+    {
+      throw std::length_error("Cannot remove row from empty table!");
+    }
+    this->count--;
+  }
+
+  /**
+    * Remove the row at `idx`, shifting all following rows to the left
+    *
+    * @throws `out_of_range` if there is no row at `idx`
+    */
+  void remove(size_t idx)
+  {
+    this->checkIdx(idx);
+    this->eraseRow(idx, std::index_sequence_for<Fields...>());
+    this->count--;
+  }
+
+  /**
+    * Remove all rows, keeping the capacity
+    */
+  void clear()
+  {
+    this->count = 0;
+  }
+
+  /**
+    * View of the row at `idx` as tuple of references to its fields
+    *
+    * @throws `out_of_range` if there is no row at `idx`
+    * @warning The references are invalidated by any operation changing the capacity.
+    */
+  Row operator[](size_t idx)
+  {
+    this->checkIdx(idx);
+    return this->rowAt(idx, std::index_sequence_for<Fields...>());
+  }
+
+  ConstRow operator[](size_t idx) const
+  {
+    this->checkIdx(idx);
+    return this->rowAt(idx, std::index_sequence_for<Fields...>());
+  }
+
+  /**
+    * Field `I` of the row at `idx`
+    *
+    * @throws `out_of_range` if there is no row at `idx`
+    */
+  template <size_t I> FieldType<I>& get(size_t idx)
+  {
+    this->checkIdx(idx);
+    return this->column<I>()[idx];
+  }
+
+  template <size_t I> const FieldType<I>& get(size_t idx) const
+  {
+    this->checkIdx(idx);
+    return this->column<I>()[idx];
+  }
+
+  /**
+    * Get a pointer to the first element of column `I`, holding `getCount()` contiguous values
+    *
+    * @warning The pointer is invalidated by any operation changing the capacity.
+    */
+  template <size_t I> FieldType<I> * getColumn()
+  {
+    return this->column<I>();
+  }
+
+  template <size_t I> const FieldType<I> * getColumn() const
+  {
+    return this->column<I>();
+  }
+
+  /**
+    * Call `f` with the fields of every row, as `f(fields...)` or `f(fields..., idx)`
+    */
+  template <typename func> void foreach (func&& f)
+  {
+    for (size_t i = 0; i < this->count; i++)
+    {
+      this->callRow(f, i, std::index_sequence_for<Fields...>());
+    }
+  }
+
+  /**
+    * Call `f` for every value of column `I`, as `f(value)` or `f(value, idx)`
+    */
+  template <size_t I, typename func> void foreach (func&& f)
+  {
+    using T = FieldType<I>;
+
+    T * col = this->column<I>();
+    for (size_t i = 0; i < this->count; i++)
+    {
+      if constexpr (std::is_invocable_v<func&, T&>)
+        f(col[i]);
+      else if constexpr (std::is_invocable_v<func&, T&, size_t>)
+        f(col[i], i);
+      else
+        static_assert(std::is_invocable_v<func&, T&> || std::is_invocable_v<func&, T&, size_t>,
+                      "Function must have signature 'void(T&)' or 'void(T&, size_t)'!");
+    }
+  }
+
+  /**
+    * Indices of all rows whose field `I` satisfies `pred`, in ascending order
+    */
+  template <size_t I, typename func> Array<size_t> findIf(func&& pred) const
+  {
+    const FieldType<I> * col = this->column<I>();
+
+    DynamicArray<size_t> res;
+    for (size_t i = 0; i < this->count; i++)
+    {
+      if (pred(col[i]))
+        res.add(i);
+    }
+    return res.toArray();
+  }
+
+  /**
+    * Indices of all rows whose field `I` equals `el`, in ascending order
+    */
+  template <size_t I> Array<size_t> find(const FieldType<I>& el) const
+  {
+    return this->findIf<I>([&](const FieldType<I>& v) { return v == el; });
+  }
+
+  /**
+    * Amount of rows whose field `I` satisfies `pred`
+    */
+  template <size_t I, typename func> size_t countIf(func&& pred) const
+  {
+    const FieldType<I> * col = this->column<I>();
+
+    size_t res = 0;
+    for (size_t i = 0; i < this->count; i++)
+    {
+      res += pred(col[i]) ? 1 : 0;
+    }
+    return res;
+  }
+
+  /**
+    * Like `foreach<I>(f)`, but splits the column into chunks processed concurrently on `pool` and the calling thread
+    *
+    * @warning `f` is called concurrently and must not be called from a job of `pool`, which could deadlock.
+    */
+  template <size_t I, typename func> void foreachParallel(ThreadPool& pool, func&& f)
+  {
+    using T = FieldType<I>;
+
+    T * col = this->column<I>();
+    this->runChunks(pool,
+                    [&](size_t begin, size_t end, size_t)
+                    {
+                      for (size_t i = begin; i < end; i++)
+                      {
+                        if constexpr (std::is_invocable_v<func&, T&>)
+                          f(col[i]);
+                        else if constexpr (std::is_invocable_v<func&, T&, size_t>)
+                          f(col[i], i);
+                        else
+                          static_assert(std::is_invocable_v<func&, T&> || std::is_invocable_v<func&, T&, size_t>,
+                                        "Function must have signature 'void(T&)' or 'void(T&, size_t)'!");
+                      }
+                    });
+  }
+
+  /**
+    * Like `findIf<I>(pred)`, but scans chunks of the column concurrently on `pool` and the calling thread
+    *
+    * @warning `pred` is called concurrently and must not be called from a job of `pool`, which could deadlock.
+    */
+  template <size_t I, typename func> Array<size_t> findIfParallel(ThreadPool& pool, func&& pred) const
+  {
+    const FieldType<I> * col = this->column<I>();
+
+    std::vector<std::vector<size_t>> found(std::max<size_t>(1, pool.getSize() * 4));
+    size_t                           chunks = this->runChunks(pool, [&](size_t begin, size_t end, size_t chunk)
+                                                              { collectIf(col, begin, end, pred, found[chunk]); });
+
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; c++)
+    {
+      total += found[c].size();
+    }
+
+    Array<size_t> res(total);
+    size_t *      out = res;
+    for (size_t c = 0; c < chunks; c++)
+    {
+      out = std::copy(found[c].begin(), found[c].end(), out);
+    }
+    return res;
+  }
+
+  /**
+    * Like `countIf<I>(pred)`, but scans chunks of the column concurrently on `pool` and the calling thread
+    *
+    * @warning `pred` is called concurrently and must not be called from a job of `pool`, which could deadlock.
+    */
+  template <size_t I, typename func> size_t countIfParallel(ThreadPool& pool, func&& pred) const
+  {
+    const FieldType<I> * col = this->column<I>();
+
+    std::vector<size_t> counts(std::max<size_t>(1, pool.getSize() * 4));
+    size_t              chunks = this->runChunks(pool,
+                                                 [&](size_t begin, size_t end, size_t chunk)
+                                                 {
+                                      size_t res = 0;
+                                      for (size_t i = begin; i < end; i++)
+                                      {
+                                        res += pred(col[i]) ? 1 : 0;
+                                      }
+                                      counts[chunk] = res;
+                                    });
+
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; c++)
+    {
+      total += counts[c];
+    }
+    return total;
+  }
+};
+} // namespace CppUtil
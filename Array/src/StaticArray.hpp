@@ -0,0 +1,266 @@
+#pragma once
+
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "Array.hpp"
+
+namespace CppUtil
+{
+/**
+  * Array of `N` elements stored inline, without heap allocation
+  *
+  * The size is a compile time constant and all non-throwing operations are `constexpr`, so tables can be built and
+  * searched at compile time. Offers the `foreach` / `all` / `any` / `find` API of `Array`.
+  */
+template <typename T, size_t N> class StaticArray
+{
+private:
+  T arr[N == 0 ? 1 : N] = {};
+
+  static constexpr void checkIdx(size_t idx)
+  {
+    if (idx >= N)
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for array of size " + std::to_string(N) +
+                              "!");
+    }
+  }
+
+public:
+  static constexpr size_t npos = (size_t)-1;
+
+  constexpr StaticArray() = default;
+
+  /**
+    * @throws `length_error` if `init` has more than `N` elements; missing elements are value initialized
+    */
+  constexpr StaticArray(std::initializer_list<T> init)
+  {
+    if (init.size() > N)
+    {
+      throw std::length_error("Cannot initialize array of size " + std::to_string(N) + " with " +
+                              std::to_string(init.size()) + " elements!");
+    }
+
+    size_t i = 0;
+    for (const T& x : init)
+    {
+      this->arr[i++] = x;
+    }
+  }
+
+  /**
+    * @throws `out_of_range` if @param idx is out of bounds
+    */
+  constexpr T& operator[](size_t idx)
+  {
+    checkIdx(idx);
+    return this->arr[idx];
+  }
+
+  constexpr const T& operator[](size_t idx) const
+  {
+    checkIdx(idx);
+    return this->arr[idx];
+  }
+
+  static constexpr size_t getSize()
+  {
+    return N;
+  }
+
+  static constexpr bool isEmpty()
+  {
+    return N == 0;
+  }
+
+  constexpr T * getData()
+  {
+    return this->arr;
+  }
+
+  constexpr const T * getData() const
+  {
+    return this->arr;
+  }
+
+  constexpr T * begin()
+  {
+    return this->arr;
+  }
+
+  constexpr T * end()
+  {
+    return this->arr + N;
+  }
+
+  constexpr const T * begin() const
+  {
+    return this->arr;
+  }
+
+  constexpr const T * end() const
+  {
+    return this->arr + N;
+  }
+
+  constexpr void fill(const T& value)
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      this->arr[i] = value;
+    }
+  }
+
+  /**
+    * Index of the first element equal to `el`, or `npos`
+    */
+  constexpr size_t indexOf(const T& el) const
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      if (this->arr[i] == el)
+        return i;
+    }
+    return npos;
+  }
+
+  /**
+    * Indices of all elements equal to `el`
+    */
+  Array<size_t> find(const T& el) const
+  {
+    DynamicArray<size_t> res;
+    for (size_t i = 0; i < N; i++)
+    {
+      if (this->arr[i] == el)
+        res.add(i);
+    }
+    return res.toArray();
+  }
+
+  constexpr bool has(const T& el) const
+  {
+    return this->indexOf(el) != npos;
+  }
+
+  template <size_t M> constexpr bool hasAny(const StaticArray<T, M>& el) const
+  {
+    for (size_t i = 0; i < M; i++)
+    {
+      if (this->has(el[i]))
+        return true;
+    }
+    return false;
+  }
+
+  template <size_t M> constexpr bool hasAll(const StaticArray<T, M>& el) const
+  {
+    for (size_t i = 0; i < M; i++)
+    {
+      if (!this->has(el[i]))
+        return false;
+    }
+    return true;
+  }
+
+  constexpr bool operator==(const StaticArray<T, N>& other) const
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      if (this->arr[i] != other.arr[i])
+        return false;
+    }
+    return true;
+  }
+
+  constexpr bool operator!=(const StaticArray<T, N>& other) const
+  {
+    return !(this->operator==(other));
+  }
+
+  Array<T> toArray() const
+  {
+    return N == 0 ? Array<T>() : Array<T>(this->arr, N);
+  }
+
+  template <typename func> constexpr void foreach (func&& f)
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      if constexpr (std::is_invocable_v<func, T&>)
+        f(this->arr[i]);
+      else if constexpr (std::is_invocable_v<func, T&, size_t>)
+        f(this->arr[i], i);
+      else
+        static_assert(std::is_invocable_v<func, T&> || std::is_invocable_v<func, T&, size_t>,
+                      "Function must have signature 'void(T&)' or 'void(T&, size_t)'!");
+    }
+  }
+
+  template <typename func> constexpr void foreach (func&& f) const
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      if constexpr (std::is_invocable_v<func, const T&>)
+        f(this->arr[i]);
+      else if constexpr (std::is_invocable_v<func, const T&, size_t>)
+        f(this->arr[i], i);
+      else
+        static_assert(std::is_invocable_v<func, const T&> || std::is_invocable_v<func, const T&, size_t>,
+                      "Function must have signature 'void(const T&)' or 'void(const T&, size_t)'!");
+    }
+  }
+
+  template <typename func> constexpr bool all(func&& f) const
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      if constexpr (std::is_invocable_r_v<bool, func, const T&>)
+      {
+        if (!f(this->arr[i]))
+          return false;
+      }
+      else if constexpr (std::is_invocable_r_v<bool, func, const T&, size_t>)
+      {
+        if (!f(this->arr[i], i))
+          return false;
+      }
+      else
+      {
+        static_assert(std::is_invocable_r_v<bool, func, const T&> ||
+                        std::is_invocable_r_v<bool, func, const T&, size_t>,
+                      "Function must have signature 'bool(const T&)' or 'bool(const T&, size_t)'!");
+      }
+    }
+    return true;
+  }
+
+  template <typename func> constexpr bool any(func&& f) const
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      if constexpr (std::is_invocable_r_v<bool, func, const T&>)
+      {
+        if (f(this->arr[i]))
+          return true;
+      }
+      else if constexpr (std::is_invocable_r_v<bool, func, const T&, size_t>)
+      {
+        if (f(this->arr[i], i))
+          return true;
+      }
+      else
+      {
+        static_assert(std::is_invocable_r_v<bool, func, const T&> ||
+                        std::is_invocable_r_v<bool, func, const T&, size_t>,
+                      "Function must have signature 'bool(const T&)' or 'bool(const T&, size_t)'!");
+      }
+    }
+    return false;
+  }
+};
+} // namespace CppUtil
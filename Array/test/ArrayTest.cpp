@@ -265,4 +265,85 @@ TEST_CASE("Array Loop", "[array][loop]")
   {
     REQUIRE(!arr.all([](int& x) { return x < 5; }));
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Array Shift", "[array][shift]")
+{
+  Array<int> arr = {1, 2, 3, 4, 5};
+
+  SECTION("Elements can be shifted to the left")
+  {
+    arr.shiftLeft(2);
+
+    REQUIRE(3 == arr[0]);
+    REQUIRE(4 == arr[1]);
+    REQUIRE(5 == arr[2]);
+  }
+
+  SECTION("Elements can be shifted to the right")
+  {
+    arr.shiftRight(2);
+
+    REQUIRE(1 == arr[2]);
+    REQUIRE(2 == arr[3]);
+    REQUIRE(3 == arr[4]);
+  }
+
+  SECTION("Shifting left by the size or more drops all elements")
+  {
+    REQUIRE_NOTHROW(arr.shiftLeft(100));
+    REQUIRE(5 == arr.getSize());
+    REQUIRE(arr.all([](int& x) { return x == 0; }));
+  }
+
+  SECTION("Shifting right by the size or more drops all elements")
+  {
+    REQUIRE_NOTHROW(arr.shiftRight(5));
+    REQUIRE(5 == arr.getSize());
+    REQUIRE(arr.all([](int& x) { return x == 0; }));
+  }
+}
+
+TEST_CASE("Array can be converted to string", "[array][to_string]")
+{
+  Array<int> arr = {1, 2, 3, 4, 5};
+
+  SECTION("All elements are written")
+  {
+    REQUIRE(std::to_string(arr) == "{1 2 3 4 5 }");
+  }
+
+  SECTION("Only the first n elements are written")
+  {
+    REQUIRE(std::to_string(arr, 2) == "{1 2 }");
+    REQUIRE(std::to_string(arr, 10) == "{1 2 3 4 5 }");
+  }
+
+  SECTION("Empty arrays can be written")
+  {
+    REQUIRE(std::to_string(Array<int>()) == "{}");
+  }
+
+  SECTION("Formatting can be configured")
+  {
+    FormatOptions opts;
+    opts.prefix            = "[";
+    opts.separator         = ",";
+    opts.suffix            = "]";
+    opts.limit             = 3;
+    opts.truncation        = ",...";
+    opts.trailingSeparator = false;
+
+    REQUIRE(std::to_string(arr, opts) == "[1,2,3,...]");
+  }
+
+  SECTION("Arrays can be written into a reusable buffer")
+  {
+    FormatBuffer buf;
+    formatTo(buf, arr);
+    buf.clear();
+    formatTo(buf, Array<double>{0.5});
+
+    REQUIRE(buf.toString() == "{0.500000 }");
+  }
+}
@@ -0,0 +1,222 @@
+#include "../src/BitArray.hpp"
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("Bits", "[bit_array][bits]")
+{
+  SECTION("Words can be counted")
+  {
+    REQUIRE(0 == Bits::popcount(0));
+    REQUIRE(64 == Bits::popcount(~(uint64_t)0));
+    REQUIRE(3 == Bits::popcount(0b1011000));
+    REQUIRE(3 == Bits::countTrailingZeros(0b1011000));
+    REQUIRE(63 == Bits::countTrailingZeros((uint64_t)1 << 63));
+
+    uint64_t words[] = {1, 3, 7, ~(uint64_t)0};
+    REQUIRE(70 == Bits::count(words, 4));
+  }
+}
+
+TEST_CASE("BitArray Access", "[bit_array][access]")
+{
+  BitArray bits(130);
+
+  SECTION("BitArray starts cleared")
+  {
+    REQUIRE(130 == bits.getSize());
+    REQUIRE(3 == bits.getWordCount());
+    REQUIRE(bits.none());
+    REQUIRE(0 == bits.count());
+  }
+
+  SECTION("Bits can be set, reset and flipped")
+  {
+    bits.set(0);
+    bits.set(64);
+    bits.set(129);
+    REQUIRE(bits[0]);
+    REQUIRE(bits.get(64));
+    REQUIRE(bits[129]);
+    REQUIRE_FALSE(bits[1]);
+    REQUIRE(3 == bits.count());
+
+    bits.reset(64);
+    bits.flip(1);
+    REQUIRE_FALSE(bits[64]);
+    REQUIRE(bits[1]);
+    REQUIRE(3 == bits.count());
+  }
+
+  SECTION("BitArray cannot be accessed out of bounds")
+  {
+    REQUIRE_THROWS_AS(bits.get(130), std::out_of_range);
+    REQUIRE_THROWS_AS(bits.set(130), std::out_of_range);
+    REQUIRE_THROWS_AS(bits.flip(1'000), std::out_of_range);
+  }
+
+  SECTION("Filling and flipping all bits leaves the tail clear")
+  {
+    bits.fill(true);
+    REQUIRE(bits.all());
+    REQUIRE(130 == bits.count());
+
+    bits.flip();
+    REQUIRE(bits.none());
+
+    REQUIRE((~bits).all());
+    REQUIRE(130 == BitArray(130, true).count());
+  }
+
+  SECTION("BitArray can be built from Array<bool>")
+  {
+    Array<bool> arr(100);
+    arr[3]  = true;
+    arr[99] = true;
+
+    BitArray res(arr);
+    REQUIRE(100 == res.getSize());
+    REQUIRE(2 == res.count());
+    REQUIRE(res[3]);
+    REQUIRE(res[99]);
+  }
+}
+
+TEST_CASE("BitArray Search", "[bit_array][search]")
+{
+  std::mt19937        rng(7);
+  BitArray            bits(10'000);
+  std::vector<size_t> expected;
+  for (size_t i = 0; i < bits.getSize(); i++)
+  {
+    if (rng() % 37 == 0)
+    {
+      bits.set(i);
+      expected.push_back(i);
+    }
+  }
+
+  SECTION("findFirst and findNext visit all set bits in order")
+  {
+    std::vector<size_t> found;
+    for (size_t i = bits.findFirst(); i != BitArray::npos; i = bits.findNext(i))
+    {
+      found.push_back(i);
+    }
+    REQUIRE(expected == found);
+    REQUIRE(expected.size() == bits.count());
+  }
+
+  SECTION("foreach visits all set bits in order")
+  {
+    std::vector<size_t> found;
+    bits.foreach ([&](size_t i) { found.push_back(i); });
+    REQUIRE(expected == found);
+  }
+
+  SECTION("Searching empty arrays finds nothing")
+  {
+    BitArray empty(200);
+    REQUIRE(BitArray::npos == empty.findFirst());
+    REQUIRE(BitArray::npos == empty.findNext(5));
+    REQUIRE(BitArray::npos == bits.findNext(9'999));
+    REQUIRE(BitArray::npos == BitArray().findFirst());
+  }
+}
+
+TEST_CASE("BitArray Operators", "[bit_array][operators]")
+{
+  BitArray a(100), b(100);
+  for (size_t i = 0; i < 100; i += 2)
+    a.set(i);
+  for (size_t i = 0; i < 100; i += 3)
+    b.set(i);
+
+  SECTION("Word-wise operators combine all bits")
+  {
+    REQUIRE(17 == (a & b).count());
+    REQUIRE(50 + 34 - 17 == (a | b).count());
+    REQUIRE(50 + 34 - 2 * 17 == (a ^ b).count());
+
+    BitArray c = a;
+    c.andNot(b);
+    REQUIRE(50 - 17 == c.count());
+  }
+
+  SECTION("Operators require equal sizes")
+  {
+    BitArray other(101);
+    REQUIRE_THROWS_AS(a &= other, std::invalid_argument);
+    REQUIRE_THROWS_AS(a | other, std::invalid_argument);
+  }
+
+  SECTION("Bit arrays can be compared")
+  {
+    BitArray c = a;
+    REQUIRE(c == a);
+    c.flip(99);
+    REQUIRE(c != a);
+    REQUIRE(a != BitArray(101));
+  }
+}
+
+TEST_CASE("DynamicBitArray", "[bit_array][dynamic]")
+{
+  DynamicBitArray bits(8);
+
+  SECTION("DynamicBitArray grows when adding bits")
+  {
+    for (size_t i = 0; i < 1'000; i++)
+    {
+      bits.add(i % 3 == 0);
+    }
+
+    REQUIRE(1'000 == bits.getSize());
+    REQUIRE(bits.getCap() >= 1'000);
+    REQUIRE(334 == bits.count());
+    REQUIRE(bits[999]);
+  }
+
+  SECTION("Removed bits do not reappear")
+  {
+    for (size_t i = 0; i < 65; i++)
+    {
+      bits.add(true);
+    }
+    bits.remove();
+    bits.remove();
+    REQUIRE(63 == bits.count());
+
+    bits.add(false);
+    bits.add(false);
+    REQUIRE(63 == bits.count());
+    REQUIRE(BitArray::npos == bits.findNext(62));
+  }
+
+  SECTION("DynamicBitArray can be resized")
+  {
+    bits.resize(100, true);
+    REQUIRE(100 == bits.count());
+
+    bits.resize(10);
+    REQUIRE(10 == bits.count());
+
+    bits.resize(300);
+    REQUIRE(10 == bits.count());
+    REQUIRE(300 == bits.getSize());
+
+    bits.clear();
+    REQUIRE(bits.isEmpty());
+    REQUIRE_THROWS_AS(bits.remove(), std::length_error);
+  }
+
+  SECTION("Invalid resize factors are rejected")
+  {
+    REQUIRE_THROWS_AS(DynamicBitArray(8, 1), std::invalid_argument);
+  }
+}
@@ -0,0 +1,146 @@
+#include "../src/CowArray.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("CowArray Init", "[cow_array][init]")
+{
+  SECTION("Empty arrays have no buffer")
+  {
+    CowArray<int> arr;
+    REQUIRE(arr.isEmpty());
+    REQUIRE(0 == arr.getSize());
+    REQUIRE(nullptr == arr.getData());
+    REQUIRE(0 == arr.getUseCount());
+    REQUIRE(CowArray<int>(0).isEmpty());
+  }
+
+  SECTION("Elements are value initialized or copied")
+  {
+    CowArray<int> zeros(3);
+    REQUIRE(3 == zeros.getSize());
+    REQUIRE(0 == zeros[2]);
+
+    int           buf[] = {1, 2, 3};
+    CowArray<int> fromBuf(buf, 3);
+    buf[0] = 7;
+    REQUIRE(1 == fromBuf[0]);
+
+    REQUIRE(CowArray<int>{1, 2, 3} == fromBuf);
+    REQUIRE(CowArray<int>(Array<int>{1, 2, 3}) == fromBuf);
+    REQUIRE(fromBuf.toArray() == Array<int>{1, 2, 3});
+  }
+
+  SECTION("Invalid arguments are rejected")
+  {
+    REQUIRE_THROWS_AS(CowArray<int>(ARRAY_MAX_SIZE + 1), std::length_error);
+    REQUIRE_THROWS_AS(CowArray<int>(nullptr, 3), std::invalid_argument);
+    CowArray<int> arr(2);
+    REQUIRE_THROWS_AS(std::as_const(arr)[2], std::out_of_range);
+    REQUIRE_THROWS_AS(arr[2], std::out_of_range);
+  }
+}
+
+TEST_CASE("CowArray copies share until modified", "[cow_array][share]")
+{
+  CowArray<std::string> a{"a", "b", "c"};
+  CowArray<std::string> b = a;
+
+  SECTION("Copies share one buffer")
+  {
+    REQUIRE(a.sharesWith(b));
+    REQUIRE(2 == a.getUseCount());
+    REQUIRE(a.isShared());
+    REQUIRE(a.getData() == b.getData());
+
+    // Const access does not detach
+    REQUIRE("b" == std::as_const(b)[1]);
+    REQUIRE(a.sharesWith(b));
+  }
+
+  SECTION("Modifying a copy detaches it")
+  {
+    b[1] = "x";
+    REQUIRE_FALSE(a.sharesWith(b));
+    REQUIRE_FALSE(a.isShared());
+    REQUIRE(1 == b.getUseCount());
+    REQUIRE("b" == std::as_const(a)[1]);
+    REQUIRE("x" == std::as_const(b)[1]);
+
+    // Unshared arrays are modified in place
+    const std::string * data = b.getData();
+    b[0]                     = "y";
+    REQUIRE(data == b.getData());
+  }
+
+  SECTION("getMutableData detaches")
+  {
+    std::string * data = a.getMutableData();
+    data[0]            = "z";
+    REQUIRE("a" == std::as_const(b)[0]);
+    REQUIRE(a != b);
+  }
+
+  SECTION("Assignment and destruction release references")
+  {
+    CowArray<std::string> c;
+    c = a;
+    REQUIRE(3 == a.getUseCount());
+    c = CowArray<std::string>{"q"};
+    REQUIRE(2 == a.getUseCount());
+    {
+      CowArray<std::string> d = std::move(b);
+      REQUIRE(b.isEmpty());
+      REQUIRE(2 == d.getUseCount());
+    }
+    REQUIRE(1 == a.getUseCount());
+    a = a;
+    REQUIRE(1 == a.getUseCount());
+    REQUIRE("c" == std::as_const(a)[2]);
+  }
+}
+
+TEST_CASE("CowArray copies are independent across threads", "[cow_array][thread]")
+{
+  CowArray<int> original(1'000);
+  for (size_t i = 0; i < original.getSize(); i++)
+  {
+    original[i] = (int)i;
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<long>        sums(8);
+  for (size_t t = 0; t < sums.size(); t++)
+  {
+    threads.emplace_back(
+      [&, t]
+      {
+        for (int round = 0; round < 100; round++)
+        {
+          CowArray<int> copy = original;
+          if (round % 2 == 0)
+            copy[t] = -1;
+          copy.foreach ([&](int x) { sums[t] += x; });
+        }
+      });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  long expected = 100 * (999 * 1'000 / 2);
+  for (size_t t = 0; t < sums.size(); t++)
+  {
+    REQUIRE(expected - 50 * ((long)t + 1) == sums[t]);
+  }
+  REQUIRE(1 == original.getUseCount());
+  REQUIRE(3 == std::as_const(original)[3]);
+}
@@ -140,6 +140,145 @@ TEST_CASE("DynamicArray Remove", "[dynamic_arary][remove]")
   }
 }
 
+TEST_CASE("DynamicArray Bulk", "[dynamic_array][bulk]")
+{
+  DynamicArray<int> arr(4);
+  arr.add(1);
+  arr.add(2);
+  arr.add(3);
+
+  SECTION("Ranges can be appended with a single reallocation", "[append]")
+  {
+    int items[] = {4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+    REQUIRE_NOTHROW(arr.addRange(items, 10));
+
+    REQUIRE(13 == arr.getCount());
+    REQUIRE(13 == arr.getCap());
+    for (int i = 0; i < 13; i++)
+    {
+      REQUIRE(i + 1 == arr[i]);
+    }
+
+    Array<int> more = {14, 15};
+    arr.append(more);
+    arr.append(arr);
+    REQUIRE(30 == arr.getCount());
+    REQUIRE(15 == arr[29]);
+    REQUIRE(1 == arr[15]);
+  }
+
+  SECTION("Ranges can be inserted", "[insert]")
+  {
+    Array<int> items = {10, 11};
+    arr.insertRange(1, items);
+    REQUIRE(5 == arr.getCount());
+    REQUIRE(1 == arr[0]);
+    REQUIRE(10 == arr[1]);
+    REQUIRE(11 == arr[2]);
+    REQUIRE(2 == arr[3]);
+    REQUIRE(3 == arr[4]);
+
+    arr.insertRange(5, items);
+    REQUIRE(11 == arr[6]);
+
+    // Ranges taken from the array itself stay valid while it grows
+    arr.insertRange(0, arr.getData() + 1, 2);
+    REQUIRE(10 == arr[0]);
+    REQUIRE(11 == arr[1]);
+    REQUIRE(1 == arr[2]);
+
+    REQUIRE_THROWS_AS(arr.insertRange(100, items), std::out_of_range);
+    REQUIRE_THROWS_AS(arr.insertRange(0, nullptr, 1), std::invalid_argument);
+  }
+
+  SECTION("Ranges can be erased", "[erase]")
+  {
+    arr.eraseRange(0, 2);
+    REQUIRE(1 == arr.getCount());
+    REQUIRE(3 == arr[0]);
+
+    REQUIRE_THROWS_AS(arr.eraseRange(1, 1), std::out_of_range);
+    REQUIRE_NOTHROW(arr.eraseRange(1, 0));
+  }
+
+  SECTION("Erasing many elements shrinks the capacity like single removes", "[erase]")
+  {
+    DynamicArray<int> single, bulk;
+    for (int i = 0; i < 1'000; i++)
+    {
+      single.add(i);
+      bulk.add(i);
+    }
+    for (int i = 0; i < 900; i++)
+    {
+      single.remove(100);
+    }
+    bulk.eraseRange(100, 900);
+
+    REQUIRE(single.getCap() == bulk.getCap());
+    REQUIRE(100 == bulk.getCount());
+    REQUIRE(99 == bulk[99]);
+  }
+
+  SECTION("Elements can be erased by predicate", "[erase]")
+  {
+    for (int i = 4; i <= 100; i++)
+    {
+      arr.add(i);
+    }
+
+    REQUIRE(50 == arr.eraseIf([](int& x) { return x % 2 == 0; }));
+    REQUIRE(50 == arr.getCount());
+    REQUIRE(arr.all([](int& x, size_t i) { return x == (int)(2 * i + 1); }));
+    REQUIRE(0 == arr.eraseIf([](int&) { return false; }));
+  }
+
+  SECTION("Inserting a single element only shifts the existing elements", "[insert]")
+  {
+    DynamicArray<int> small(16);
+    small.add(1);
+    small.add(2, 0);
+    REQUIRE(2 == small.getCount());
+    REQUIRE(2 == small[0]);
+    REQUIRE(1 == small[1]);
+    REQUIRE(16 == small.getCap());
+  }
+}
+
+TEST_CASE("DynamicArray Clear", "[dynamic_array][clear]")
+{
+  DynamicArray<int> arr(4);
+  arr.add(1);
+  arr.add(2);
+
+  SECTION("Clearing keeps the capacity")
+  {
+    arr.clear();
+    REQUIRE(0 == arr.getCount());
+    REQUIRE(4 == arr.getCap());
+
+    arr.add(3);
+    REQUIRE(3 == arr[0]);
+  }
+
+  SECTION("DynamicArray can be moved")
+  {
+    DynamicArray<int> other = std::move(arr);
+    REQUIRE(2 == other.getCount());
+    REQUIRE(2 == other[1]);
+
+    REQUIRE(0 == arr.getCount());
+    REQUIRE("{}" == std::to_string(arr));
+    arr.add(3);
+    REQUIRE(1 == arr.getCount());
+    REQUIRE("{3 }" == std::to_string(arr));
+
+    arr = std::move(other);
+    REQUIRE(2 == arr.getCount());
+    REQUIRE(0 == other.getCount());
+  }
+}
+
 TEST_CASE("DynamicArray loops", "[dynamic_array][loop]")
 {
   DynamicArray<int> arr;
@@ -192,4 +331,16 @@ TEST_CASE("DynamicArray loops", "[dynamic_array][loop]")
   {
     REQUIRE_FALSE(arr.any([](int& x) { return x > 9'999; }));
   }
-}
\ No newline at end of file
+}
+TEST_CASE("DynamicArray can be converted to string", "[dynamic_array][to_string]")
+{
+  DynamicArray<int> arr;
+  arr.add(1);
+  arr.add(2);
+  arr.add(3);
+
+  REQUIRE(std::to_string(arr) == "{1 2 3 }");
+
+  const DynamicArray<int>& ref = arr;
+  REQUIRE(std::to_string(ref) == "{1 2 3 }");
+}
@@ -0,0 +1,143 @@
+#include "../src/RingBuffer.hpp"
+
+#include <deque>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("RingBuffer Init", "[ring_buffer][init]")
+{
+  SECTION("Capacity is rounded up to a power of two")
+  {
+    REQUIRE(8 == RingBuffer<int>().getCap());
+    REQUIRE(16 == RingBuffer<int>(9).getCap());
+    REQUIRE(2 == RingBuffer<int>(0).getCap());
+  }
+
+  SECTION("Invalid capacities are rejected")
+  {
+    REQUIRE_THROWS_AS(RingBuffer<int>(ARRAY_MAX_SIZE + 1), std::length_error);
+  }
+}
+
+TEST_CASE("RingBuffer Queue", "[ring_buffer][queue]")
+{
+  RingBuffer<std::string> buf(4);
+
+  SECTION("Elements leave in FIFO order and wrap around")
+  {
+    for (int round = 0; round < 10; round++)
+    {
+      buf.pushBack(std::to_string(round));
+      buf.pushBack(std::to_string(round) + "b");
+      REQUIRE(std::to_string(round) == buf.popFront());
+      REQUIRE(std::to_string(round) + "b" == buf.popFront());
+    }
+    REQUIRE(buf.isEmpty());
+    REQUIRE(4 == buf.getCap());
+  }
+
+  SECTION("Elements can be added and removed at both ends")
+  {
+    buf.pushBack("b");
+    buf.pushFront("a");
+    buf.pushBack("c");
+
+    REQUIRE("a" == buf.front());
+    REQUIRE("c" == buf.back());
+    REQUIRE("b" == buf[1]);
+    REQUIRE("c" == buf.popBack());
+    REQUIRE("a" == buf.popFront());
+    REQUIRE("b" == buf.popBack());
+  }
+
+  SECTION("Growing keeps the order of wrapped elements")
+  {
+    buf.pushBack("x");
+    buf.pushBack("y");
+    buf.popFront();
+    buf.popFront();
+    for (int i = 0; i < 100; i++)
+    {
+      buf.pushBack(std::to_string(i));
+    }
+
+    REQUIRE(100 == buf.getCount());
+    REQUIRE(128 == buf.getCap());
+    for (int i = 0; i < 100; i++)
+    {
+      REQUIRE(std::to_string(i) == buf[i]);
+    }
+  }
+
+  SECTION("Empty buffers cannot be accessed")
+  {
+    REQUIRE_THROWS_AS(buf.popFront(), std::length_error);
+    REQUIRE_THROWS_AS(buf.popBack(), std::length_error);
+    REQUIRE_THROWS_AS(buf.front(), std::length_error);
+    REQUIRE_THROWS_AS(buf[0], std::out_of_range);
+  }
+
+  SECTION("A moved-from buffer is empty and usable")
+  {
+    buf.pushBack("a");
+    buf.pushBack("b");
+    RingBuffer<std::string> other = std::move(buf);
+    REQUIRE(2 == other.getCount());
+    REQUIRE(0 == buf.getCount());
+
+    buf.pushFront("c");
+    buf.pushBack("d");
+    REQUIRE("c" == buf.popFront());
+    REQUIRE("d" == buf.popFront());
+  }
+}
+
+TEST_CASE("RingBuffer behaves like std::deque", "[ring_buffer][random]")
+{
+  std::mt19937    rng(5);
+  Deque<int>      buf;
+  std::deque<int> ref;
+
+  for (int i = 0; i < 100'000; i++)
+  {
+    switch (rng() % 4)
+    {
+      case 0:
+        buf.pushBack(i);
+        ref.push_back(i);
+        break;
+      case 1:
+        buf.pushFront(i);
+        ref.push_front(i);
+        break;
+      case 2:
+        if (!ref.empty())
+        {
+          REQUIRE(ref.front() == buf.popFront());
+          ref.pop_front();
+        }
+        break;
+      default:
+        if (!ref.empty())
+        {
+          REQUIRE(ref.back() == buf.popBack());
+          ref.pop_back();
+        }
+        break;
+    }
+  }
+
+  REQUIRE(ref.size() == buf.getCount());
+  buf.foreach ([&](int& x, size_t idx) { REQUIRE(ref[idx] == x); });
+
+  auto arr = buf.toArray();
+  REQUIRE(ref.size() == arr.getSize());
+
+  buf.clear();
+  REQUIRE(buf.isEmpty());
+}
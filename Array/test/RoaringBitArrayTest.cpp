@@ -0,0 +1,178 @@
+#include "../src/RoaringBitArray.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+static std::vector<uint32_t> toVector(const RoaringBitArray& set)
+{
+  std::vector<uint32_t> res;
+  set.foreach ([&](uint32_t v) { res.push_back(v); });
+  return res;
+}
+
+TEST_CASE("RoaringBitArray Access", "[roaring_bit_array][access]")
+{
+  RoaringBitArray set;
+
+  SECTION("Values can be added and removed")
+  {
+    set.add(5);
+    set.add(70'000);
+    set.add(5);
+    set.add(0xFFFFFFFF);
+
+    REQUIRE(3 == set.getCount());
+    REQUIRE(set.contains(5));
+    REQUIRE(set.contains(70'000));
+    REQUIRE(set.contains(0xFFFFFFFF));
+    REQUIRE_FALSE(set.contains(6));
+
+    set.remove(70'000);
+    set.remove(12);
+    REQUIRE(2 == set.getCount());
+    REQUIRE_FALSE(set.contains(70'000));
+
+    set.clear();
+    REQUIRE(set.isEmpty());
+  }
+
+  SECTION("Dense containers switch to bitmaps and back")
+  {
+    for (uint32_t i = 0; i < 10'000; i++)
+    {
+      set.add(i * 2);
+    }
+    REQUIRE(10'000 == set.getCount());
+    REQUIRE(set.contains(19'998));
+    REQUIRE_FALSE(set.contains(19'999));
+
+    for (uint32_t i = 0; i < 8'000; i++)
+    {
+      set.remove(i * 2);
+    }
+    REQUIRE(2'000 == set.getCount());
+    REQUIRE(set.contains(16'000));
+    REQUIRE_FALSE(set.contains(15'998));
+  }
+
+  SECTION("Sparse sets use little memory")
+  {
+    for (uint32_t i = 0; i < 1'000; i++)
+    {
+      set.add(i * 1'000'003);
+    }
+    REQUIRE(1'000 == set.getCount());
+    REQUIRE(set.getMemoryUsage() < 100'000);
+  }
+}
+
+TEST_CASE("RoaringBitArray Search", "[roaring_bit_array][search]")
+{
+  std::mt19937       rng(3);
+  RoaringBitArray    set;
+  std::set<uint32_t> expected;
+  for (size_t i = 0; i < 50'000; i++)
+  {
+    // Mix of a dense and a sparse region, inserted out of order
+    uint32_t v = (i % 2 == 0) ? (uint32_t)(rng() % 100'000) : (uint32_t)rng();
+    set.add(v);
+    expected.insert(v);
+  }
+
+  SECTION("Values are visited in ascending order")
+  {
+    REQUIRE(expected.size() == set.getCount());
+    REQUIRE(std::vector<uint32_t>(expected.begin(), expected.end()) == toVector(set));
+  }
+
+  SECTION("findFirst and findNext visit all values in order")
+  {
+    std::vector<uint32_t> found;
+    for (size_t v = set.findFirst(); v != RoaringBitArray::npos; v = set.findNext((uint32_t)v))
+    {
+      found.push_back((uint32_t)v);
+    }
+    REQUIRE(std::vector<uint32_t>(expected.begin(), expected.end()) == found);
+    REQUIRE(RoaringBitArray::npos == RoaringBitArray().findFirst());
+  }
+}
+
+TEST_CASE("RoaringBitArray Operators", "[roaring_bit_array][operators]")
+{
+  std::mt19937       rng(11);
+  RoaringBitArray    a, b;
+  std::set<uint32_t> sa, sb;
+  for (size_t i = 0; i < 30'000; i++)
+  {
+    uint32_t x = (uint32_t)(rng() % 300'000);
+    uint32_t y = (uint32_t)(rng() % 300'000);
+    a.add(x);
+    sa.insert(x);
+    b.add(y);
+    sb.insert(y);
+  }
+  // A container only in one of the sets
+  a.add(0xFFFF0001);
+  sa.insert(0xFFFF0001);
+
+  auto expect = [&](auto op)
+  {
+    std::vector<uint32_t> res;
+    for (uint32_t v : sa)
+    {
+      if (op(true, sb.count(v) > 0))
+        res.push_back(v);
+    }
+    for (uint32_t v : sb)
+    {
+      if (sa.count(v) == 0 && op(false, true))
+        res.push_back(v);
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+  };
+
+  SECTION("Sets can be combined")
+  {
+    REQUIRE(expect([](bool x, bool y) { return x && y; }) == toVector(a & b));
+    REQUIRE(expect([](bool x, bool y) { return x || y; }) == toVector(a | b));
+    REQUIRE(expect([](bool x, bool y) { return x != y; }) == toVector(a ^ b));
+  }
+
+  SECTION("Combined sets compare equal to sets built directly")
+  {
+    RoaringBitArray c = a;
+    c |= b;
+
+    RoaringBitArray d;
+    for (uint32_t v : toVector(b))
+      d.add(v);
+    for (uint32_t v : toVector(a))
+      d.add(v);
+
+    REQUIRE(c == d);
+    c ^= b;
+    c ^= b;
+    REQUIRE(c == d);
+    REQUIRE((a ^ a).isEmpty());
+  }
+
+  SECTION("Sets can be built from bit arrays")
+  {
+    BitArray bits(200'000);
+    for (size_t i = 0; i < bits.getSize(); i += 7)
+      bits.set(i);
+
+    RoaringBitArray set(bits);
+    REQUIRE(bits.count() == set.getCount());
+    REQUIRE(set.contains(199'997));
+    REQUIRE_FALSE(set.contains(199'998));
+  }
+}
@@ -0,0 +1,132 @@
+#include "../src/SmallDynamicArray.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("SmallDynamicArray stays inline until full", "[small_dynamic_array][inline]")
+{
+  SmallDynamicArray<std::string, 4> arr;
+  REQUIRE(arr.isEmpty());
+  REQUIRE(arr.isInline());
+  REQUIRE(4 == arr.getCap());
+
+  for (int i = 0; i < 4; i++)
+  {
+    arr.add(std::to_string(i));
+  }
+  REQUIRE(arr.isInline());
+  REQUIRE(4 == arr.getCount());
+
+  SECTION("Spills to the heap when growing beyond the inline capacity")
+  {
+    arr.add("4");
+    REQUIRE_FALSE(arr.isInline());
+    REQUIRE(8 == arr.getCap());
+    for (int i = 0; i < 5; i++)
+    {
+      REQUIRE(std::to_string(i) == arr[i]);
+    }
+
+    arr.remove();
+    arr.remove(0);
+    REQUIRE(8 == arr.getCap());
+    arr.shrinkToFit();
+    REQUIRE(arr.isInline());
+    REQUIRE(arr[0] == "1");
+    REQUIRE(arr[2] == "3");
+  }
+
+  SECTION("Elements can be inserted and removed anywhere")
+  {
+    arr.add("x", 1);
+    arr.add("y", 0);
+    arr.add("z", 6);
+    REQUIRE(arr.toArray() == Array<std::string>{"y", "0", "x", "1", "2", "3", "z"});
+
+    REQUIRE(3 == arr.eraseIf([](const std::string& s) { return s.size() == 1 && isalpha(s[0]); }));
+    REQUIRE(arr.toArray() == Array<std::string>{"0", "1", "2", "3"});
+
+    arr.clear();
+    REQUIRE(arr.isEmpty());
+    REQUIRE_THROWS_AS(arr.remove(), std::length_error);
+  }
+
+  SECTION("Invalid indices are rejected")
+  {
+    REQUIRE_THROWS_AS(arr[4], std::out_of_range);
+    REQUIRE_THROWS_AS(arr.remove(4), std::out_of_range);
+    REQUIRE_THROWS_AS(arr.add("x", 5), std::out_of_range);
+    REQUIRE_THROWS_AS(arr.addRange(nullptr, 1), std::invalid_argument);
+  }
+}
+
+TEST_CASE("SmallDynamicArray copies and moves", "[small_dynamic_array][copy]")
+{
+  for (size_t n : {2, 6})
+  {
+    SmallDynamicArray<std::string, 4> arr;
+    for (size_t i = 0; i < n; i++)
+    {
+      arr.add(std::string(20, (char)('a' + i)));
+    }
+
+    SmallDynamicArray<std::string, 4> copy = arr;
+    REQUIRE(copy.toArray() == arr.toArray());
+
+    SmallDynamicArray<std::string, 4> moved = std::move(copy);
+    REQUIRE(copy.isEmpty());
+    REQUIRE(copy.isInline());
+    REQUIRE(moved.toArray() == arr.toArray());
+
+    SmallDynamicArray<std::string, 4> assigned{"x"};
+    assigned = std::move(moved);
+    REQUIRE(assigned.toArray() == arr.toArray());
+    assigned = arr;
+    REQUIRE(assigned.toArray() == arr.toArray());
+    REQUIRE((n <= 4) == assigned.isInline());
+  }
+
+  SECTION("Own elements can be appended")
+  {
+    SmallDynamicArray<int, 2> arr{1, 2};
+    arr.append(arr);
+    arr.addRange(arr.getData(), 1);
+    REQUIRE(arr.toArray() == Array<int>{1, 2, 1, 2, 1});
+  }
+
+  SECTION("Move-only elements are supported")
+  {
+    SmallDynamicArray<std::unique_ptr<int>, 2> arr;
+    for (int i = 0; i < 5; i++)
+    {
+      arr.add(std::make_unique<int>(i));
+    }
+    auto moved = std::move(arr);
+    REQUIRE(4 == *moved[4]);
+  }
+}
+
+TEST_CASE("SmallDynamicArray Algorithms", "[small_dynamic_array][algorithms]")
+{
+  SmallDynamicArray<int, 8> arr{3, 1, 3, 7};
+
+  REQUIRE(arr.find(3) == Array<size_t>{0, 2});
+  REQUIRE(arr.has(7));
+  REQUIRE_FALSE(arr.has(2));
+  REQUIRE(arr.all([](int x) { return x % 2 == 1; }));
+  REQUIRE(arr.any([](int x, size_t i) { return x == 7 && i == 3; }));
+
+  arr.foreach ([](int& x) { x *= 2; });
+  int sum = 0;
+  for (int x : arr)
+  {
+    sum += x;
+  }
+  REQUIRE(28 == sum);
+}
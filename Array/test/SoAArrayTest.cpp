@@ -0,0 +1,189 @@
+#include "../src/SoAArray.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("SoAArray Add", "[soa_array][add]")
+{
+  SoAArray<int, double, std::string> table;
+
+  SECTION("Rows are stored column by column")
+  {
+    for (int i = 0; i < 100; i++)
+    {
+      table.add(i, i * 0.5, std::to_string(i));
+    }
+
+    REQUIRE(100 == table.getCount());
+    REQUIRE(table.getCap() >= 100);
+
+    const int *         ids   = table.getColumn<0>();
+    const double *      half  = table.getColumn<1>();
+    const std::string * names = table.getColumn<2>();
+    for (int i = 0; i < 100; i++)
+    {
+      REQUIRE(i == ids[i]);
+      REQUIRE(i * 0.5 == half[i]);
+      REQUIRE(std::to_string(i) == names[i]);
+    }
+  }
+
+  SECTION("Rows can be accessed as tuples of references")
+  {
+    table.add(1, 1.5, "one");
+    table.add(2, 2.5, "two");
+
+    auto [id, val, name] = table[1];
+    REQUIRE(2 == id);
+    REQUIRE(2.5 == val);
+    REQUIRE("two" == name);
+
+    name = "zwei";
+    REQUIRE("zwei" == table.get<2>(1));
+    REQUIRE_THROWS_AS(table[2], std::out_of_range);
+    REQUIRE_THROWS_AS(table.get<0>(2), std::out_of_range);
+  }
+
+  SECTION("Reserving keeps all rows")
+  {
+    table.add(7, 7.0, "seven");
+    table.reserve(1'000);
+
+    REQUIRE(1'000 == table.getCap());
+    REQUIRE(1 == table.getCount());
+    REQUIRE(7 == table.get<0>(0));
+    REQUIRE("seven" == table.get<2>(0));
+  }
+
+  SECTION("Invalid resize factors are rejected")
+  {
+    REQUIRE_THROWS_AS((SoAArray<int, int>(2, 1)), std::invalid_argument);
+  }
+}
+
+TEST_CASE("SoAArray Remove", "[soa_array][remove]")
+{
+  SoAArray<int, std::string> table;
+  for (int i = 0; i < 5; i++)
+  {
+    table.add(i, std::to_string(i));
+  }
+
+  SECTION("Removing a row shifts all following rows")
+  {
+    table.remove(1);
+
+    REQUIRE(4 == table.getCount());
+    REQUIRE(0 == table.get<0>(0));
+    REQUIRE(2 == table.get<0>(1));
+    REQUIRE("4" == table.get<1>(3));
+    REQUIRE_THROWS_AS(table.remove(4), std::out_of_range);
+  }
+
+  SECTION("The last row can be removed until the table is empty")
+  {
+    for (int i = 0; i < 5; i++)
+    {
+      table.remove();
+    }
+
+    REQUIRE(table.isEmpty());
+    REQUIRE_THROWS_AS(table.remove(), std::length_error);
+  }
+}
+
+TEST_CASE("SoAArray Scan", "[soa_array][scan]")
+{
+  SoAArray<int, double> table;
+  for (int i = 0; i < 1'000; i++)
+  {
+    table.add(i % 10, i);
+  }
+
+  SECTION("Columns can be iterated with and without index")
+  {
+    long sum = 0;
+    table.foreach<0>([&](int v) { sum += v; });
+    REQUIRE(4'500 == sum);
+
+    table.foreach<1>([](double& v, size_t idx) { v = (double)idx * 2; });
+    REQUIRE(1'998 == table.get<1>(999));
+  }
+
+  SECTION("Rows can be iterated with and without index")
+  {
+    double sum = 0;
+    table.foreach ([&](int& key, double& val) { sum += key * val; });
+    REQUIRE(sum > 0);
+
+    size_t rows = 0;
+    table.foreach ([&](int&, double&, size_t idx) { rows = idx + 1; });
+    REQUIRE(1'000 == rows);
+  }
+
+  SECTION("Values can be found in a column")
+  {
+    auto found = table.find<0>(3);
+    REQUIRE(100 == found.getSize());
+    for (size_t i = 0; i < found.getSize(); i++)
+    {
+      REQUIRE(3 + 10 * i == found[i]);
+    }
+
+    REQUIRE(0 == table.find<0>(10).getSize());
+    REQUIRE(500 == table.countIf<1>([](double v) { return v >= 500; }));
+    REQUIRE(table.findIf<1>([](double v) { return v < 10; }).getSize() == 10);
+  }
+}
+
+TEST_CASE("SoAArray Parallel Scan", "[soa_array][parallel]")
+{
+  ThreadPool pool(4);
+
+  SoAArray<int, long> table;
+  constexpr size_t    Rows = 1'000'003;
+  for (size_t i = 0; i < Rows; i++)
+  {
+    table.add((int)(i % 97), (long)i);
+  }
+
+  SECTION("Parallel scans agree with sequential ones")
+  {
+    auto pred = [](int v) { return v < 13; };
+
+    REQUIRE(table.countIf<0>(pred) == table.countIfParallel<0>(pool, pred));
+    REQUIRE(table.findIf<0>(pred) == table.findIfParallel<0>(pool, pred));
+  }
+
+  SECTION("Parallel foreach visits every value once")
+  {
+    table.foreachParallel<1>(pool, [](long& v, size_t idx) { v = (long)idx * 3; });
+    for (size_t i = 0; i < Rows; i += 997)
+    {
+      REQUIRE((long)i * 3 == table.get<1>(i));
+    }
+  }
+
+  SECTION("Exceptions thrown by scans are rethrown")
+  {
+    auto pred = [](long v)
+    {
+      if (v == 777'777)
+        throw std::runtime_error("Oops");
+      return true;
+    };
+
+    REQUIRE_THROWS_AS(table.countIfParallel<1>(pool, pred), std::runtime_error);
+  }
+
+  SECTION("Empty tables can be scanned")
+  {
+    SoAArray<int> empty;
+    REQUIRE(0 == empty.countIfParallel<0>(pool, [](int) { return true; }));
+    REQUIRE(0 == empty.findIfParallel<0>(pool, [](int) { return true; }).getSize());
+  }
+}
@@ -0,0 +1,71 @@
+#include "../src/StaticArray.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+// Table built and searched at compile time
+static constexpr StaticArray<int, 8> squares()
+{
+  StaticArray<int, 8> res;
+  res.foreach ([](int& x, size_t i) { x = (int)(i * i); });
+  return res;
+}
+
+static_assert(StaticArray<int, 8>::getSize() == 8);
+static_assert(squares()[3] == 9);
+static_assert(squares().indexOf(49) == 7);
+static_assert(squares().has(16) && !squares().has(15));
+static_assert(squares().all([](int x) { return x >= 0; }));
+static_assert(squares().any([](int x, size_t i) { return x == 25 && i == 5; }));
+static_assert(StaticArray<int, 3>{1, 2} == StaticArray<int, 3>{1, 2, 0});
+static_assert(sizeof(StaticArray<int, 8>) == 8 * sizeof(int));
+
+TEST_CASE("StaticArray Init", "[static_array][init]")
+{
+  SECTION("Elements are value initialized")
+  {
+    StaticArray<std::string, 3> arr;
+    REQUIRE(3 == arr.getSize());
+    REQUIRE(arr[2].empty());
+    REQUIRE(StaticArray<int, 0>::isEmpty());
+    REQUIRE(StaticArray<int, 0>().toArray().isEmpty());
+  }
+
+  SECTION("Too many initializers are rejected")
+  {
+    REQUIRE_THROWS_AS((StaticArray<int, 2>{1, 2, 3}), std::length_error);
+  }
+
+  SECTION("Indices are bounds checked")
+  {
+    StaticArray<int, 2> arr{1, 2};
+    REQUIRE_THROWS_AS(arr[2], std::out_of_range);
+    REQUIRE_THROWS_AS(std::as_const(arr)[2], std::out_of_range);
+  }
+}
+
+TEST_CASE("StaticArray Algorithms", "[static_array][algorithms]")
+{
+  StaticArray<std::string, 4> arr{"a", "b", "a", "c"};
+
+  REQUIRE(arr.find("a") == Array<size_t>{0, 2});
+  REQUIRE(arr.find("x").isEmpty());
+  REQUIRE(arr.hasAny(StaticArray<std::string, 2>{"x", "c"}));
+  REQUIRE_FALSE(arr.hasAll(StaticArray<std::string, 2>{"x", "c"}));
+  REQUIRE(arr.toArray() == Array<std::string>{"a", "b", "a", "c"});
+
+  std::string joined;
+  for (const std::string& s : arr)
+  {
+    joined += s;
+  }
+  REQUIRE("abac" == joined);
+
+  arr.fill("z");
+  REQUIRE(arr.all([](const std::string& s) { return s == "z"; }));
+  REQUIRE(arr != StaticArray<std::string, 4>());
+}
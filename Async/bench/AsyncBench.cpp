@@ -0,0 +1,221 @@
+#include "Async.hpp"
+#include "Benchmark.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace CppUtil;
+
+// Count all heap allocations, to check that pool tasks do not allocate once everything is warmed up
+static std::atomic<size_t> allocations{0};
+
+void * operator new(size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void * p = malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+  free(p);
+}
+
+// Completion state as it was before the atomic state word: mutex + condition variable per future
+struct LegacyFuture
+{
+  struct State
+  {
+    int                     value    = 0;
+    bool                    finished = false;
+    std::mutex              mtx;
+    std::condition_variable cv;
+  };
+
+  std::shared_ptr<State> state = std::make_shared<State>();
+
+  void setValue(int v)
+  {
+    state->value = v;
+  }
+
+  void finish()
+  {
+    {
+      std::lock_guard<std::mutex> lock(state->mtx);
+      state->finished = true;
+    }
+    state->cv.notify_all();
+  }
+
+  int get()
+  {
+    std::unique_lock<std::mutex> lock(state->mtx);
+    state->cv.wait(lock, [this] { return state->finished; });
+    return state->value;
+  }
+};
+
+struct AtomicFuture
+{
+  Future<int>  future;
+  Promise<int> promise = future.asPromise();
+
+  void setValue(int v)
+  {
+    future.setValue(v);
+  }
+
+  void finish()
+  {
+    future.finish();
+  }
+
+  int get()
+  {
+    return promise.get();
+  }
+};
+
+static constexpr size_t Count   = 1'000'000;
+static constexpr size_t Threads = 4;
+
+// Get all futures after they are finished: the fast path
+template <typename F> double benchReady()
+{
+  std::vector<F> futures(Count);
+  for (auto& f : futures)
+  {
+    f.setValue(1);
+    f.finish();
+  }
+
+  long long sum = 0;
+  double    sec = Benchmark::measure(
+    [&]
+    {
+      for (auto& f : futures)
+        sum += f.get();
+    });
+  Benchmark::doNotOptimize(sum);
+  return sec;
+}
+
+// One thread completes all futures, `Threads` threads wait for a slice each
+template <typename F> double benchFanOut()
+{
+  std::vector<F> futures;
+
+  return Benchmark::measure([&] { futures = std::vector<F>(Count); },
+                            [&]
+                            {
+                              std::vector<std::thread> waiters;
+                              std::atomic<long long>   sum{0};
+
+                              for (size_t t = 0; t < Threads; t++)
+                              {
+                                waiters.emplace_back(
+                                  [&, t]
+                                  {
+                                    long long local = 0;
+                                    for (size_t i = t; i < Count; i += Threads)
+                                      local += futures[i].get();
+                                    sum += local;
+                                  });
+                              }
+
+                              for (auto& f : futures)
+                              {
+                                f.setValue(1);
+                                f.finish();
+                              }
+
+                              for (auto& w : waiters)
+                                w.join();
+                              Benchmark::doNotOptimize(sum);
+                            },
+                            3);
+}
+
+// `Threads` threads complete a slice of futures each, one thread waits for all of them
+template <typename F> double benchFanIn()
+{
+  std::vector<F> futures;
+
+  return Benchmark::measure([&] { futures = std::vector<F>(Count); },
+                            [&]
+                            {
+                              std::vector<std::thread> producers;
+
+                              for (size_t t = 0; t < Threads; t++)
+                              {
+                                producers.emplace_back(
+                                  [&, t]
+                                  {
+                                    for (size_t i = t; i < Count; i += Threads)
+                                    {
+                                      futures[i].setValue(1);
+                                      futures[i].finish();
+                                    }
+                                  });
+                              }
+
+                              long long sum = 0;
+                              for (auto& f : futures)
+                                sum += f.get();
+
+                              for (auto& p : producers)
+                                p.join();
+                              Benchmark::doNotOptimize(sum);
+                            },
+                            3);
+}
+
+int main()
+{
+  Benchmark::report("ready get, mutex + condvar", benchReady<LegacyFuture>(), Count);
+  Benchmark::report("ready get, atomic state word", benchReady<AtomicFuture>(), Count);
+  printf("\n");
+
+  Benchmark::report("fan-out 1 -> 4 waiters, mutex + condvar", benchFanOut<LegacyFuture>(), Count);
+  Benchmark::report("fan-out 1 -> 4 waiters, atomic state word", benchFanOut<AtomicFuture>(), Count);
+  printf("\n");
+
+  Benchmark::report("fan-in 4 -> 1 waiter, mutex + condvar", benchFanIn<LegacyFuture>(), Count);
+  Benchmark::report("fan-in 4 -> 1 waiter, atomic state word", benchFanIn<AtomicFuture>(), Count);
+  printf("\n");
+
+  ThreadPool                pool(Threads);
+  std::vector<Promise<int>> promises;
+  promises.reserve(Count);
+
+  auto roundTrip = [&]
+  {
+    for (size_t i = 0; i < Count; i++)
+      promises.push_back(Async::async<int>(pool, [] { return 1; }));
+
+    long long sum = 0;
+    for (auto& p : promises)
+      sum += p.get();
+    Benchmark::doNotOptimize(sum);
+    promises.clear();
+  };
+
+  double sec = Benchmark::measure(roundTrip, 3);
+  Benchmark::report("Async::async(pool) round trip", sec, Count);
+
+  // Everything is warmed up by now, so this run should not allocate at all
+  size_t before = allocations.load();
+  roundTrip();
+  size_t allocs = allocations.load() - before;
+  printf("Async::async(pool) heap allocations per task: %.4f\n", (double)allocs / Count);
+  return 0;
+}
@@ -1,47 +1,732 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <climits>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <thread>
 #include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#include "Exception.hpp"
 
 namespace CppUtil
 {
-struct AsyncState
+struct CancellationState
+{
+  std::atomic<bool> cancelled{false};
+
+  std::mutex                                            mtx;
+  std::vector<std::pair<size_t, std::function<void()>>> callbacks;
+  size_t                                                nextId = 1;
+
+  // Set when this state is linked to a parent, so the callback can be removed again
+  std::shared_ptr<CancellationState> parent;
+  size_t                             parentCallbackId = 0;
+
+  ~CancellationState()
+  {
+    if (this->parent)
+      this->parent->removeCallback(this->parentCallbackId);
+  }
+
+  size_t addCallback(std::function<void()> f)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mtx);
+      if (!this->cancelled.load(std::memory_order_acquire))
+      {
+        this->callbacks.emplace_back(this->nextId, std::move(f));
+        return this->nextId++;
+      }
+    }
+    f();
+    return 0;
+  }
+
+  void removeCallback(size_t id)
+  {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    for (size_t i = 0; i < this->callbacks.size(); i++)
+    {
+      if (this->callbacks[i].first == id)
+      {
+        this->callbacks.erase(this->callbacks.begin() + i);
+        return;
+      }
+    }
+  }
+
+  void cancel()
+  {
+    std::vector<std::pair<size_t, std::function<void()>>> tmp;
+    {
+      std::lock_guard<std::mutex> lock(this->mtx);
+      if (this->cancelled.exchange(true, std::memory_order_acq_rel))
+        return;
+      tmp.swap(this->callbacks);
+    }
+
+    // Callbacks run outside the lock, so they may register or cancel other tokens
+    for (auto& cb : tmp)
+    {
+      cb.second();
+    }
+  }
+};
+
+/**
+  * Read-only view of a cancellation request, passed into tasks
+  *
+  * Cancellation is cooperative: A task has to check `isCancelled()` (or call `throwIfCancelled()`) itself.
+  * A default constructed token can never be cancelled.
+  */
+class CancellationToken
+{
+private:
+  std::shared_ptr<CancellationState> state;
+
+  friend class CancellationSource;
+
+public:
+  CancellationToken() {}
+
+  CancellationToken(std::shared_ptr<CancellationState> state) : state(state) {}
+
+  bool isCancelled() const
+  {
+    return this->state && this->state->cancelled.load(std::memory_order_acquire);
+  }
+
+  bool canBeCancelled() const
+  {
+    return (bool)this->state;
+  }
+
+  /**
+    * @throws `cancelled` if cancellation was requested
+    */
+  void throwIfCancelled() const
+  {
+    if (this->isCancelled())
+      throw cancelled("Task was cancelled!");
+  }
+
+  /**
+    * Register a callback that is invoked once cancellation is requested
+    *
+    * Invokes `f` immediately if cancellation was already requested.
+    *
+    * @return An id to remove the callback with, 0 if `f` was invoked immediately or the token cannot be cancelled
+    */
+  size_t onCancel(std::function<void()> f) const
+  {
+    if (!this->state)
+      return 0;
+    return this->state->addCallback(std::move(f));
+  }
+
+  void removeCallback(size_t id) const
+  {
+    if (this->state && id != 0)
+      this->state->removeCallback(id);
+  }
+};
+
+/**
+  * Owner of a cancellation request
+  *
+  * A source constructed from a parent token is cancelled together with its parent,
+  * so cancelling the root of a task chain cancels every task below it.
+  */
+class CancellationSource
 {
+private:
+  std::shared_ptr<CancellationState> state;
+
+public:
+  CancellationSource() : state(std::make_shared<CancellationState>()) {}
+
+  CancellationSource(const CancellationToken& parent) : state(std::make_shared<CancellationState>())
+  {
+    if (!parent.state)
+      return;
+
+    std::weak_ptr<CancellationState> weak = this->state;
+
+    size_t id = parent.state->addCallback(
+      [weak]
+      {
+        if (auto s = weak.lock())
+          s->cancel();
+      });
+
+    if (id != 0)
+    {
+      this->state->parent           = parent.state;
+      this->state->parentCallbackId = id;
+    }
+  }
+
+  CancellationToken token() const
+  {
+    return CancellationToken(this->state);
+  }
+
+  void cancel()
+  {
+    this->state->cancel();
+  }
+
+  bool isCancelled() const
+  {
+    return this->state->cancelled.load(std::memory_order_acquire);
+  }
+};
+
+/**
+  * Blocks threads on a 32 bit atomic word, like C++20's `atomic::wait`/`notify_all`
+  *
+  * Uses a futex on Linux. Everywhere else waiters park on one of a fixed set of mutex/condition variable
+  * buckets, selected by the address of the word, so no per-word synchronization objects are needed.
+  */
+class AtomicWait
+{
+private:
+#if !defined(__linux__)
+  struct Bucket
+  {
+    std::mutex              mtx;
+    std::condition_variable cv;
+  };
+
+  static Bucket& bucket(const std::atomic<uint32_t>& word)
+  {
+    // Never destroyed, detached task threads may still finish while the process exits
+    static Bucket * buckets = new Bucket[64];
+    return buckets[((uintptr_t)&word >> 4) % 64];
+  }
+#endif
+
+public:
+  /**
+    * Block while `word` holds `expected`
+    *
+    * @note May return spuriously; callers have to check their condition again.
+    */
+  static void wait(std::atomic<uint32_t>& word, uint32_t expected)
+  {
+#if defined(__linux__)
+    syscall(SYS_futex, (uint32_t *)&word, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    Bucket&                      b = bucket(word);
+    std::unique_lock<std::mutex> lock(b.mtx);
+    while (word.load(std::memory_order_acquire) == expected)
+      b.cv.wait(lock);
+#endif
+  }
+
+  /**
+    * Block while `word` holds `expected`, at most until `deadline`
+    *
+    * @return false if the deadline passed
+    * @note May return spuriously; callers have to check their condition again.
+    */
+  static bool waitUntil(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::steady_clock::time_point deadline)
+  {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline)
+      return false;
+
+#if defined(__linux__)
+    auto            ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(ns / 1'000'000'000);
+    ts.tv_nsec = (long)(ns % 1'000'000'000);
+    syscall(SYS_futex, (uint32_t *)&word, FUTEX_WAIT_PRIVATE, expected, &ts, nullptr, 0);
+#else
+    Bucket&                      b = bucket(word);
+    std::unique_lock<std::mutex> lock(b.mtx);
+    while (word.load(std::memory_order_acquire) == expected)
+    {
+      if (b.cv.wait_until(lock, deadline) == std::cv_status::timeout)
+        break;
+    }
+#endif
+    return std::chrono::steady_clock::now() < deadline;
+  }
+
+  /**
+    * Wake all threads blocked on `word`; must be called after `word` changed
+    */
+  static void notifyAll(std::atomic<uint32_t>& word)
+  {
+#if defined(__linux__)
+    syscall(SYS_futex, (uint32_t *)&word, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+    Bucket& b = bucket(word);
+    {
+      // Waiters check the word while holding the lock, so taking it here prevents lost wakeups
+      std::lock_guard<std::mutex> lock(b.mtx);
+    }
+    b.cv.notify_all();
+#endif
+  }
+
+  /**
+    * Hint to the CPU that the calling thread is spinning
+    */
+  static void relax()
+  {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+  }
+};
+
+/**
+  * Per-thread free-list of fixed size memory blocks
+  *
+  * Freed blocks are cached by the freeing thread. Threads caching too many blocks hand a batch over to a
+  * shared list, from which threads running dry take a batch, so producer/consumer setups reach a steady state
+  * without calls to `operator new`.
+  */
+template <size_t Size> class BlockPool
+{
+private:
+  static_assert(Size >= 2 * sizeof(void *), "Blocks must be able to hold two pointers!");
+
+  // Amount of blocks moved between a thread and the shared list at once
+  static constexpr size_t Batch = 64;
+
+  struct Block
+  {
+    Block * next;
+    Block * nextBatch;
+  };
+
+  struct Local
+  {
+    Block * head  = nullptr;
+    size_t  count = 0;
+
+    ~Local()
+    {
+      while (this->head != nullptr)
+      {
+        Block * b  = this->head;
+        this->head = b->next;
+        ::operator delete(b);
+      }
+    }
+  };
+
+  struct Shared
+  {
+    std::mutex mtx;
+    Block *    batches = nullptr;
+  };
+
+  static Local& local()
+  {
+    thread_local Local l;
+    return l;
+  }
+
+  static Shared& shared()
+  {
+    // Never destroyed, threads may still return blocks while the process exits
+    static Shared * s = new Shared();
+    return *s;
+  }
+
+public:
+  static void * allocate()
+  {
+    Local& l = local();
+
+    if (l.head == nullptr)
+    {
+      Shared&                     s = shared();
+      std::lock_guard<std::mutex> lock(s.mtx);
+      if (s.batches != nullptr)
+      {
+        l.head    = s.batches;
+        s.batches = s.batches->nextBatch;
+        l.count   = Batch;
+      }
+    }
+
+    if (l.head == nullptr)
+      return ::operator new(Size);
+
+    Block * b = l.head;
+    l.head    = b->next;
+    l.count--;
+    return b;
+  }
+
+  static void deallocate(void * ptr)
+  {
+    Local&  l = local();
+    Block * b = (Block *)ptr;
+
+    b->next = l.head;
+    l.head  = b;
+    l.count++;
+
+    if (l.count >= 2 * Batch)
+    {
+      // Detach the first `Batch` blocks and hand them over
+      Block * first = l.head;
+      Block * last  = first;
+      for (size_t i = 1; i < Batch; i++)
+        last = last->next;
+
+      l.head = last->next;
+      l.count -= Batch;
+      last->next = nullptr;
+
+      Shared&                     s = shared();
+      std::lock_guard<std::mutex> lock(s.mtx);
+      first->nextBatch = s.batches;
+      s.batches        = first;
+    }
+  }
+};
+
+/**
+  * Completion state shared between a `Future` and its `Promise`s
+  *
+  * The whole state lives in a single atomic word, so checking a finished state costs one acquire load.
+  * Waiters spin for a short while and then park via `AtomicWait`; `finish()` only issues a wakeup
+  * if a waiter announced itself by setting the `Waiting` bit.
+  */
+class AsyncState
+{
+private:
+  static constexpr uint32_t Finished = 1;
+  static constexpr uint32_t Threw    = 2;
+  static constexpr uint32_t Waiting  = 4;
+
+  // Amount of spin iterations before a waiter parks
+  static constexpr int SpinCount = 128;
+
+  std::atomic<uint32_t> word{0};
+  std::atomic<uint32_t> refs{1};
+
+  // Only written before `finish()`, only read after observing `Finished`
   std::exception_ptr exc;
 
-  bool threw;
-  bool finished;
+  // Try to wait without parking; returns the last observed state
+  uint32_t spin() const
+  {
+    // Spinning on a single core only delays the thread that would finish the state
+    static const int spins = (std::thread::hardware_concurrency() > 1) ? SpinCount : 0;
+
+    uint32_t s = this->word.load(std::memory_order_acquire);
+    for (int i = 0; i < spins && !(s & Finished); i++)
+    {
+      AtomicWait::relax();
+      s = this->word.load(std::memory_order_acquire);
+    }
+    return s;
+  }
+
+  // Set the `Waiting` bit, so `finish()` knows to wake us; returns false if the state finished meanwhile
+  bool announce(uint32_t& s)
+  {
+    while (!(s & Waiting))
+    {
+      if (s & Finished)
+        return false;
+      if (this->word.compare_exchange_weak(s, s | Waiting, std::memory_order_acq_rel, std::memory_order_acquire))
+        s |= Waiting;
+    }
+    return !(s & Finished);
+  }
+
+public:
+  void retain()
+  {
+    this->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+    * @return Whether the last reference was released
+    */
+  bool release()
+  {
+    return this->refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+
+  bool isFinished() const
+  {
+    return this->word.load(std::memory_order_acquire) & Finished;
+  }
+
+  void wait()
+  {
+    uint32_t s = this->spin();
+
+    while (this->announce(s))
+    {
+      AtomicWait::wait(this->word, s);
+      s = this->word.load(std::memory_order_acquire);
+    }
+  }
+
+  /**
+    * @return Whether the state finished before `deadline`
+    */
+  template <typename Clock, typename Duration> bool waitUntil(const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    auto steadyDeadline = std::chrono::steady_clock::now() +
+                          std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline - Clock::now());
 
-  std::condition_variable cv;
-  std::mutex              mtx;
+    uint32_t s = this->spin();
+
+    while (this->announce(s))
+    {
+      if (!AtomicWait::waitUntil(this->word, s, steadyDeadline))
+        return this->isFinished();
+      s = this->word.load(std::memory_order_acquire);
+    }
+    return true;
+  }
+
+  void setThrow(std::exception_ptr v)
+  {
+    this->exc = v;
+  }
+
+  /**
+    * Rethrow the exception of the task, if it threw
+    *
+    * @note Must only be called once the state is finished.
+    */
+  void rethrow() const
+  {
+    if (this->word.load(std::memory_order_acquire) & Threw)
+      std::rethrow_exception(this->exc);
+  }
+
+  void finish()
+  {
+    uint32_t old = this->word.exchange(Finished | (this->exc ? Threw : 0), std::memory_order_acq_rel);
+    if (old & Waiting)
+      AtomicWait::notifyAll(this->word);
+  }
 };
 
-template <typename T> class Promise
+/**
+  * `AsyncState` with the result of type T stored inline
+  *
+  * Allocated from a `BlockPool` and reference counted by `StateRef`, so a task needs no heap allocation
+  * for its result once the pool is warmed up.
+  */
+template <typename T> class AsyncResult : public AsyncState
+{
+private:
+  alignas(T) unsigned char storage[sizeof(T)];
+  bool hasValue = false;
+
+  // Upper bound of the size, covering the padding before `storage`, the flag and the tail padding
+  static constexpr size_t PoolSize =
+    (sizeof(AsyncState) + alignof(T) + sizeof(T) + alignof(std::max_align_t) + 31) / 32 * 32;
+
+  using Pool = BlockPool<PoolSize>;
+
+  static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned result types are not supported!");
+
+public:
+  ~AsyncResult()
+  {
+    if (this->hasValue)
+      this->value().~T();
+  }
+
+  T& value()
+  {
+    return *std::launder((T *)this->storage);
+  }
+
+  template <typename U> void setValue(U&& v)
+  {
+    if (this->hasValue)
+    {
+      this->value() = std::forward<U>(v);
+    }
+    else
+    {
+      new (this->storage) T(std::forward<U>(v));
+      this->hasValue = true;
+    }
+  }
+
+  static AsyncResult * create()
+  {
+    static_assert(sizeof(AsyncResult) <= PoolSize, "Result does not fit the pool blocks!");
+    return new (Pool::allocate()) AsyncResult();
+  }
+
+  static void destroy(AsyncResult * r)
+  {
+    r->~AsyncResult();
+    Pool::deallocate(r);
+  }
+};
+
+template <> class AsyncResult<void> : public AsyncState
+{
+private:
+  static constexpr size_t PoolSize = (sizeof(AsyncState) + 31) / 32 * 32;
+
+  using Pool = BlockPool<PoolSize>;
+
+public:
+  static AsyncResult * create()
+  {
+    static_assert(sizeof(AsyncResult) <= PoolSize, "Result does not fit the pool blocks!");
+    return new (Pool::allocate()) AsyncResult();
+  }
+
+  static void destroy(AsyncResult * r)
+  {
+    r->~AsyncResult();
+    Pool::deallocate(r);
+  }
+};
+
+/**
+  * Intrusive reference to an `AsyncResult`
+  */
+template <typename T> class StateRef
 {
 private:
-  std::shared_ptr<AsyncState> state;
+  AsyncResult<T> * ptr = nullptr;
+
+public:
+  StateRef() {}
 
-  std::shared_ptr<T> value;
+  // Adopts the initial reference of `ptr`
+  explicit StateRef(AsyncResult<T> * ptr) : ptr(ptr) {}
+
+  StateRef(const StateRef& other) : ptr(other.ptr)
+  {
+    if (this->ptr)
+      this->ptr->retain();
+  }
+
+  StateRef(StateRef&& other) noexcept : ptr(other.ptr)
+  {
+    other.ptr = nullptr;
+  }
+
+  StateRef& operator=(StateRef other) noexcept
+  {
+    std::swap(this->ptr, other.ptr);
+    return *this;
+  }
+
+  ~StateRef()
+  {
+    if (this->ptr && this->ptr->release())
+      AsyncResult<T>::destroy(this->ptr);
+  }
+
+  AsyncResult<T> * operator->() const
+  {
+    return this->ptr;
+  }
+};
+
+template <typename T> class Promise
+{
+private:
+  StateRef<T> state;
 
 public:
-  Promise<T>(std::shared_ptr<AsyncState> state, std::shared_ptr<T> value) : state(state), value(value) {}
+  Promise<T>(StateRef<T> state) : state(std::move(state)) {}
 
   bool isFinished()
   {
-    return state->finished;
+    return state->isFinished();
+  }
+
+  void wait()
+  {
+    state->wait();
+  }
+
+  /**
+    * Wait for the task to finish, at most until `deadline`
+    *
+    * @return Whether the task finished in time
+    */
+  template <typename Clock, typename Duration> bool waitUntil(const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    return state->waitUntil(deadline);
+  }
+
+  /**
+    * Wait for the task to finish, at most for `timeout`
+    *
+    * @return Whether the task finished in time
+    */
+  template <typename Rep, typename Period> bool waitFor(const std::chrono::duration<Rep, Period>& timeout)
+  {
+    return state->waitUntil(std::chrono::steady_clock::now() + timeout);
   }
 
   T get()
   {
-    std::unique_lock<std::mutex> lock(state->mtx);
-    state->cv.wait(lock, [this] { return (state->finished); });
-    if (state->threw)
-      std::rethrow_exception(state->exc);
-    return *value;
+    state->wait();
+    state->rethrow();
+    return state->value();
+  }
+
+  /**
+    * Get the result, waiting at most until `deadline`
+    *
+    * @throws `timed_out` if the task did not finish in time
+    */
+  template <typename Clock, typename Duration> T getUntil(const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    if (!this->waitUntil(deadline))
+      throw timed_out("Task did not finish in time!");
+    return this->get();
+  }
+
+  /**
+    * Get the result, waiting at most for `timeout`
+    *
+    * @throws `timed_out` if the task did not finish in time
+    */
+  template <typename Rep, typename Period> T getFor(const std::chrono::duration<Rep, Period>& timeout)
+  {
+    return this->getUntil(std::chrono::steady_clock::now() + timeout);
   }
 
   operator T()
@@ -53,66 +738,87 @@ public:
 template <> class Promise<void>
 {
 private:
-  std::shared_ptr<AsyncState> state;
+  StateRef<void> state;
 
 public:
-  Promise<void>(std::shared_ptr<AsyncState> state) : state(state) {}
+  Promise<void>(StateRef<void> state) : state(std::move(state)) {}
 
   bool isFinished()
   {
-    return state->finished;
+    return state->isFinished();
+  }
+
+  void wait()
+  {
+    state->wait();
+  }
+
+  template <typename Clock, typename Duration> bool waitUntil(const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    return state->waitUntil(deadline);
+  }
+
+  template <typename Rep, typename Period> bool waitFor(const std::chrono::duration<Rep, Period>& timeout)
+  {
+    return state->waitUntil(std::chrono::steady_clock::now() + timeout);
   }
 
   void get()
   {
-    std::unique_lock<std::mutex> lock(state->mtx);
-    state->cv.wait(lock, [this] { return (state->finished); });
-    if (state->threw)
-      std::rethrow_exception(state->exc);
+    state->wait();
+    state->rethrow();
     return;
   }
+
+  template <typename Clock, typename Duration> void getUntil(const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    if (!this->waitUntil(deadline))
+      throw timed_out("Task did not finish in time!");
+    this->get();
+  }
+
+  template <typename Rep, typename Period> void getFor(const std::chrono::duration<Rep, Period>& timeout)
+  {
+    this->getUntil(std::chrono::steady_clock::now() + timeout);
+  }
 };
 
 template <typename T> class Future
 {
 private:
-  std::shared_ptr<AsyncState> state;
-
-  std::shared_ptr<T> value;
+  StateRef<T> state;
 
 public:
-  Future<T>() : state(std::make_shared<AsyncState>()), value(std::make_shared<T>()) {}
+  Future<T>() : state(AsyncResult<T>::create()) {}
 
   CppUtil::Promise<T> asPromise()
   {
-    return Promise<T>(state, value);
+    return Promise<T>(state);
   }
 
   void setValue(T v)
   {
-    *value = v;
+    state->setValue(std::move(v));
   }
 
   void finish()
   {
-    state->finished = true;
-    state->cv.notify_all();
+    state->finish();
   }
 
   void setThrow(std::exception_ptr v)
   {
-    state->exc   = v;
-    state->threw = true;
+    state->setThrow(v);
   }
 };
 
 template <> class Future<void>
 {
 private:
-  std::shared_ptr<AsyncState> state;
+  StateRef<void> state;
 
 public:
-  Future<void>() : state(std::make_shared<AsyncState>()) {}
+  Future<void>() : state(AsyncResult<void>::create()) {}
 
   CppUtil::Promise<void> asPromise()
   {
@@ -121,32 +827,394 @@ public:
 
   void finish()
   {
-    state->finished = true;
-    state->cv.notify_all();
+    state->finish();
   }
 
   void setThrow(std::exception_ptr v)
   {
-    state->exc   = v;
-    state->threw = true;
+    state->setThrow(v);
+  }
+};
+
+/**
+  * Move-only, type erased `void(bool dropped)` callable
+  *
+  * Callables up to `InlineSize` bytes are stored inside the task itself, bigger ones on the heap.
+  * `dropped` is true if the task is discarded instead of run, e.g. because it was cancelled.
+  */
+class Task
+{
+private:
+  static constexpr size_t InlineSize = 64;
+
+  struct Ops
+  {
+    void (*invoke)(void *, bool);
+    void (*move)(void * dst, void * src);
+    void (*destroy)(void *);
+  };
+
+  template <typename F>
+  static constexpr bool IsInline = sizeof(F) <= InlineSize &&
+                                   alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+  template <typename F> static const Ops * opsFor()
+  {
+    if constexpr (IsInline<F>)
+    {
+      static const Ops ops = {[](void * p, bool dropped) { (*(F *)p)(dropped); },
+                              [](void * dst, void * src)
+                              {
+                                new (dst) F(std::move(*(F *)src));
+                                ((F *)src)->~F();
+                              },
+                              [](void * p) { ((F *)p)->~F(); }};
+      return &ops;
+    }
+    else
+    {
+      static const Ops ops = {[](void * p, bool dropped) { (**(F **)p)(dropped); },
+                              [](void * dst, void * src) { *(F **)dst = *(F **)src; },
+                              [](void * p) { delete *(F **)p; }};
+      return &ops;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char buf[InlineSize];
+  const Ops * ops = nullptr;
+
+public:
+  Task() {}
+
+  template <typename F, typename Fn = std::decay_t<F>,
+            typename = std::enable_if_t<!std::is_same_v<Fn, Task> && std::is_invocable_v<Fn&, bool>>>
+  Task(F&& f)
+  {
+    if constexpr (IsInline<Fn>)
+      new (this->buf) Fn(std::forward<F>(f));
+    else
+      *(Fn **)this->buf = new Fn(std::forward<F>(f));
+    this->ops = opsFor<Fn>();
+  }
+
+  Task(Task&& other) noexcept : ops(other.ops)
+  {
+    if (this->ops)
+      this->ops->move(this->buf, other.buf);
+    other.ops = nullptr;
+  }
+
+  Task& operator=(Task&& other) noexcept
+  {
+    if (&other != this)
+    {
+      this->reset();
+      this->ops = other.ops;
+      if (this->ops)
+        this->ops->move(this->buf, other.buf);
+      other.ops = nullptr;
+    }
+    return *this;
+  }
+
+  Task(const Task&)            = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task()
+  {
+    this->reset();
+  }
+
+  void reset()
+  {
+    if (this->ops)
+      this->ops->destroy(this->buf);
+    this->ops = nullptr;
+  }
+
+  explicit operator bool() const
+  {
+    return this->ops != nullptr;
+  }
+
+  void operator()(bool dropped = false)
+  {
+    this->ops->invoke(this->buf, dropped);
+  }
+};
+
+/**
+  * Fixed size pool of worker threads executing submitted jobs in FIFO order
+  *
+  * Jobs submitted with a cancellation token are dropped without running once the token is cancelled
+  * before a worker picked them up. Destroying the pool finishes all remaining jobs.
+  */
+class ThreadPool
+{
+private:
+  struct Job
+  {
+    Task task;
+
+    CancellationToken token;
+    size_t            callbackId = 0;
+  };
+
+  // FIFO ring buffer of jobs, growing geometrically and never shrinking, so steady state use does not allocate
+  class JobQueue
+  {
+  private:
+    std::unique_ptr<Job[]> jobs;
+    size_t                 cap   = 0;
+    size_t                 head  = 0;
+    size_t                 count = 0;
+
+    void grow()
+    {
+      size_t                 newCap = (this->cap == 0) ? 64 : this->cap * 2;
+      std::unique_ptr<Job[]> tmp(new Job[newCap]);
+      for (size_t i = 0; i < this->count; i++)
+      {
+        tmp[i] = std::move(this->jobs[(this->head + i) % this->cap]);
+      }
+      this->jobs = std::move(tmp);
+      this->cap  = newCap;
+      this->head = 0;
+    }
+
+  public:
+    bool isEmpty() const
+    {
+      return this->count == 0;
+    }
+
+    size_t getCount() const
+    {
+      return this->count;
+    }
+
+    void push(Job&& job)
+    {
+      if (this->count == this->cap)
+        this->grow();
+      this->jobs[(this->head + this->count) % this->cap] = std::move(job);
+      this->count++;
+    }
+
+    Job pop()
+    {
+      Job res    = std::move(this->jobs[this->head]);
+      this->head = (this->head + 1) % this->cap;
+      this->count--;
+      return res;
+    }
+
+    // Move all jobs matching `pred` into `out`, keeping the order of the remaining ones
+    template <typename P> void extractIf(P&& pred, std::vector<Job>& out)
+    {
+      size_t kept = 0;
+      for (size_t i = 0; i < this->count; i++)
+      {
+        Job& job = this->jobs[(this->head + i) % this->cap];
+        if (pred(job))
+          out.push_back(std::move(job));
+        else
+          this->jobs[(this->head + kept++) % this->cap] = std::move(job);
+      }
+      this->count = kept;
+    }
+  };
+
+  struct Shared
+  {
+    JobQueue                queue;
+    std::mutex              mtx;
+    std::condition_variable cv;
+    bool                    stopping = false;
+
+    // Remove all cancelled jobs from the queue and drop them
+    void purgeCancelled()
+    {
+      std::vector<Job> dropped;
+      {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        this->queue.extractIf([](const Job& job) { return job.token.isCancelled(); }, dropped);
+      }
+
+      for (auto& job : dropped)
+      {
+        job.task(true);
+      }
+    }
+  };
+
+  std::shared_ptr<Shared>  shared;
+  std::vector<std::thread> workers;
+
+  static void work(std::shared_ptr<Shared> shared)
+  {
+    while (true)
+    {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(shared->mtx);
+        shared->cv.wait(lock, [&] { return shared->stopping || !shared->queue.isEmpty(); });
+
+        if (shared->queue.isEmpty())
+          return;
+
+        job = shared->queue.pop();
+      }
+
+      job.token.removeCallback(job.callbackId);
+      job.task(job.token.isCancelled());
+    }
+  }
+
+  void enqueue(Task task, const CancellationToken& token)
+  {
+    size_t id = 0;
+    if (token.canBeCancelled())
+    {
+      std::weak_ptr<Shared> weak = this->shared;
+
+      id = token.onCancel(
+        [weak]
+        {
+          if (auto s = weak.lock())
+            s->purgeCancelled();
+        });
+    }
+
+    if (token.isCancelled())
+    {
+      token.removeCallback(id);
+      task(true);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->shared->mtx);
+      this->shared->queue.push(Job{std::move(task), token, id});
+    }
+    this->shared->cv.notify_one();
+  }
+
+public:
+  ThreadPool(size_t threads = std::thread::hardware_concurrency()) : shared(std::make_shared<Shared>())
+  {
+    if (threads == 0)
+      threads = 1;
+
+    for (size_t i = 0; i < threads; i++)
+    {
+      this->workers.emplace_back(work, this->shared);
+    }
+  }
+
+  ThreadPool(const ThreadPool&)            = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->shared->mtx);
+      this->shared->stopping = true;
+    }
+    this->shared->cv.notify_all();
+
+    for (auto& w : this->workers)
+    {
+      w.join();
+    }
+  }
+
+  size_t getSize() const
+  {
+    return this->workers.size();
+  }
+
+  /**
+    * Amount of jobs waiting for a worker
+    */
+  size_t getQueued() const
+  {
+    std::lock_guard<std::mutex> lock(this->shared->mtx);
+    return this->shared->queue.getCount();
+  }
+
+  /**
+    * Queue `task` for execution
+    *
+    * `task` is called with `dropped == true` instead of running if `token` gets cancelled before a worker picked
+    * the job up.
+    */
+  void submit(Task task, const CancellationToken& token = CancellationToken())
+  {
+    this->enqueue(std::move(task), token);
+  }
+
+  /**
+    * Queue `run` for execution
+    *
+    * @param token Cancelling the token before a worker picked up the job drops it
+    * @param drop Invoked instead of `run` when the job is dropped
+    */
+  template <typename R, typename D>
+  std::enable_if_t<std::is_invocable_v<R&> && std::is_invocable_v<D&>> submit(R&& run, const CancellationToken& token,
+                                                                              D&& drop)
+  {
+    this->enqueue(
+      [run = std::forward<R>(run), drop = std::forward<D>(drop)](bool dropped) mutable
+      {
+        if (dropped)
+          drop();
+        else
+          run();
+      },
+      token);
+  }
+
+  template <typename R>
+  std::enable_if_t<std::is_invocable_v<R&>> submit(R&& run, const CancellationToken& token = CancellationToken())
+  {
+    this->submit(std::forward<R>(run), token, [] {});
   }
 };
 
 class Async
 {
 private:
-  template <typename T, typename F, typename... A> static void _async(Future<T> res, F f, A... a)
+  // Whether `F` wants the cancellation token of its task as first argument
+  template <typename F, typename Tup> struct TakesToken;
+
+  template <typename F, typename... A>
+  struct TakesToken<F, std::tuple<A...>> : std::is_invocable<F, const CancellationToken&, A...>
+  {
+  };
+
+  template <typename T, typename F, typename Tup>
+  static void _async(Future<T>& res, const CancellationToken& token, F& f, Tup& a)
   {
     try
     {
-      using ResultT = decltype(std::apply(f, a...));
-      if constexpr (std::is_void_v<ResultT>)
+      token.throwIfCancelled();
+
+      auto call = [&]() -> decltype(auto)
       {
-        std::apply(f, a...);
+        if constexpr (TakesToken<F, Tup>::value)
+          return std::apply([&](auto&... x) -> decltype(auto) { return f(token, x...); }, a);
+        else
+          return std::apply(f, a);
+      };
+
+      if constexpr (std::is_void_v<T>)
+      {
+        call();
       }
       else
       {
-        auto r = std::apply(f, a...);
+        auto r = call();
         res.setValue(std::move(r));
       }
     }
@@ -157,11 +1225,42 @@ private:
     res.finish();
   }
 
+  template <typename T> static void _cancel(Future<T>& res)
+  {
+    res.setThrow(std::make_exception_ptr(cancelled("Task was cancelled before it started!")));
+    res.finish();
+  }
+
+  template <typename T, typename Func, typename... Args> static void checkInvocable()
+  {
+    static_assert(std::is_invocable_r_v<T, Func, Args...> ||
+                    std::is_invocable_r_v<T, Func, const CancellationToken&, Args...>,
+                  "Async function must return T and accept the given arguments (optionally preceded by a "
+                  "CancellationToken)!");
+  }
+
+  template <typename F>
+  static constexpr bool IsOption =
+    std::is_same_v<std::decay_t<F>, CancellationToken> || std::is_same_v<std::decay_t<F>, ThreadPool>;
+
 public:
-  template <typename T, typename Func, typename... Args> static Promise<T> async(Func&& f, Args&&... a)
+  template <typename T, typename Func, typename... Args>
+  static std::enable_if_t<!IsOption<Func>, Promise<T>> async(Func&& f, Args&&... a)
   {
-    static_assert(std::is_invocable_r_v<T, Func, Args...>,
-                  "Async function must return T and accept the given arguments!");
+    return async<T>(CancellationToken(), std::forward<Func>(f), std::forward<Args>(a)...);
+  }
+
+  /**
+    * Run `f` on a new thread
+    *
+    * If `f` accepts a `CancellationToken` as first argument, `token` is passed along, so the task can check for
+    * cancellation and hand the token to the tasks it starts itself.
+    * The task does not run at all if `token` is already cancelled when the thread starts.
+    */
+  template <typename T, typename Func, typename... Args>
+  static Promise<T> async(const CancellationToken& token, Func&& f, Args&&... a)
+  {
+    checkInvocable<T, Func, Args...>();
 
     auto res = Future<T>();
 
@@ -171,11 +1270,48 @@ public:
     auto fn   = Fn(std::forward<Func>(f));
     auto args = Tup(std::forward<Args>(a)...);
 
-    std::thread([res, fn = std::move(fn), args = std::move(args)]() mutable
-                { _async<T>(res, std::move(fn), std::move(args)); })
+    std::thread([res, token, fn = std::move(fn), args = std::move(args)]() mutable { _async<T>(res, token, fn, args); })
       .detach();
     return res.asPromise();
   }
+
+  template <typename T, typename Func, typename... Args>
+  static std::enable_if_t<!IsOption<Func>, Promise<T>> async(ThreadPool& pool, Func&& f, Args&&... a)
+  {
+    return async<T>(pool, CancellationToken(), std::forward<Func>(f), std::forward<Args>(a)...);
+  }
+
+  /**
+    * Queue `f` on `pool`
+    *
+    * Cancelling `token` while the task is still queued drops it without running; its promise then throws `cancelled`.
+    */
+  template <typename T, typename Func, typename... Args>
+  static Promise<T> async(ThreadPool& pool, const CancellationToken& token, Func&& f, Args&&... a)
+  {
+    checkInvocable<T, Func, Args...>();
+
+    auto res = Future<T>();
+
+    using Fn  = std::decay_t<Func>;
+    using Tup = std::tuple<std::decay_t<Args>...>;
+
+    auto fn   = Fn(std::forward<Func>(f));
+    auto args = Tup(std::forward<Args>(a)...);
+
+    auto promise = res.asPromise();
+
+    pool.submit(Task(
+                  [res = std::move(res), token, fn = std::move(fn), args = std::move(args)](bool dropped) mutable
+                  {
+                    if (dropped)
+                      _cancel<T>(res);
+                    else
+                      _async<T>(res, token, fn, args);
+                  }),
+                token);
+    return promise;
+  }
 };
 
 // Declare and define an async function.
@@ -0,0 +1,774 @@
+#pragma once
+
+#include "Async.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace CppUtil
+{
+/**
+  * Hierarchical timer wheel with a resolution of one tick
+  *
+  * Each of the `Levels` levels has 64 slots; a slot of level `l` spans 64^l ticks. Timers are filed into the
+  * coarsest level that still separates them from the current tick and move down a level whenever the wheel passes
+  * the start of their slot, so adding, removing and expiring a timer is O(1) regardless of the amount of timers.
+  * Deadlines further away than 64^Levels ticks are parked in the last slot they fit and re-filed on the way.
+  *
+  * Nodes are intrusive and owned by the caller.
+  */
+class TimerWheel
+{
+public:
+  static constexpr size_t   Levels   = 4;
+  static constexpr size_t   Slots    = 64;
+  static constexpr unsigned SlotBits = 6;
+
+  struct Node
+  {
+    uint64_t deadline = 0;
+
+    Node *  prev = nullptr;
+    Node *  next = nullptr;
+    Node ** head = nullptr;
+  };
+
+private:
+  Node *   slots[Levels][Slots] = {};
+  uint64_t occupied[Levels]     = {};
+  uint64_t current              = 0;
+  size_t   count                = 0;
+
+  static uint64_t rotr(uint64_t v, unsigned n)
+  {
+    n &= 63;
+    return n == 0 ? v : (v >> n) | (v << (64 - n));
+  }
+
+  // File `node` by its deadline, treating deadlines before `earliest` as due at `earliest`
+  void link(Node * node, uint64_t earliest)
+  {
+    uint64_t d = std::max(node->deadline, earliest);
+
+    size_t level = 0;
+    while (level < Levels - 1 && d - this->current >= (uint64_t)1 << (SlotBits * (level + 1)))
+      level++;
+
+    // Clamp deadlines out of range to the furthest slot of the last level
+    uint64_t maxAhead = ((uint64_t)1 << (SlotBits * Levels)) - 1;
+    if (d - this->current > maxAhead)
+      d = this->current + maxAhead;
+
+    size_t slot = (d >> (SlotBits * level)) & (Slots - 1);
+
+    node->head = &this->slots[level][slot];
+    node->prev = nullptr;
+    node->next = *node->head;
+    if (node->next != nullptr)
+      node->next->prev = node;
+    *node->head = node;
+
+    this->occupied[level] |= (uint64_t)1 << slot;
+  }
+
+  void unlink(Node * node)
+  {
+    if (node->prev != nullptr)
+      node->prev->next = node->next;
+    else
+      *node->head = node->next;
+    if (node->next != nullptr)
+      node->next->prev = node->prev;
+
+    if (*node->head == nullptr)
+    {
+      size_t idx = node->head - &this->slots[0][0];
+      this->occupied[idx / Slots] &= ~((uint64_t)1 << (idx % Slots));
+    }
+    node->head = nullptr;
+  }
+
+  // Detach the whole list of a slot
+  Node * take(size_t level, size_t slot)
+  {
+    Node * list              = this->slots[level][slot];
+    this->slots[level][slot] = nullptr;
+    this->occupied[level] &= ~((uint64_t)1 << slot);
+    return list;
+  }
+
+public:
+  /**
+    * Create a wheel positioned at tick `now`
+    */
+  explicit TimerWheel(uint64_t now = 0) : current(now) {}
+
+  TimerWheel(const TimerWheel&)            = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  uint64_t getTick() const
+  {
+    return this->current;
+  }
+
+  size_t getCount() const
+  {
+    return this->count;
+  }
+
+  bool isEmpty() const
+  {
+    return this->count == 0;
+  }
+
+  bool contains(const Node * node) const
+  {
+    return node->head != nullptr;
+  }
+
+  /**
+    * Schedule `node` to expire at tick `node->deadline`; deadlines not after the current tick expire on the next one
+    */
+  void add(Node * node)
+  {
+    this->link(node, this->current + 1);
+    this->count++;
+  }
+
+  void remove(Node * node)
+  {
+    if (node->head == nullptr)
+      return;
+    this->unlink(node);
+    this->count--;
+  }
+
+  /**
+    * Earliest tick at which the wheel has work to do, i.e. a timer may expire or a slot needs to be re-filed
+    *
+    * No timer expires before that tick, so it is safe to sleep until then. `UINT64_MAX` if the wheel is empty.
+    */
+  uint64_t nextTick() const
+  {
+    uint64_t res = UINT64_MAX;
+    for (size_t l = 0; l < Levels; l++)
+    {
+      if (this->occupied[l] == 0)
+        continue;
+
+      unsigned shift = SlotBits * l;
+      uint64_t pos   = this->current >> shift;
+      uint64_t bits  = rotr(this->occupied[l], (unsigned)((pos + 1) & (Slots - 1)));
+      uint64_t ahead = (uint64_t)__builtin_ctzll(bits) + 1;
+
+      res = std::min(res, (pos + ahead) << shift);
+    }
+    return res;
+  }
+
+  /**
+    * Move the wheel forward to tick `now`, calling `expire(Node*)` for every timer due on the way
+    *
+    * Expired nodes are removed from the wheel before `expire` is called, so they may be re-added from within it.
+    */
+  template <typename F> void advance(uint64_t now, F&& expire)
+  {
+    while (this->current < now)
+    {
+      // Skip ticks without any work at once
+      uint64_t next = this->nextTick();
+      if (next > now)
+      {
+        this->current = now;
+        return;
+      }
+      this->current = next;
+
+      // Re-file the slots starting at this tick, coarsest level first, as they may fill finer slots due now
+      size_t top = 0;
+      while (top < Levels - 1 && (this->current & (((uint64_t)1 << (SlotBits * (top + 1))) - 1)) == 0)
+        top++;
+
+      for (size_t l = top; l >= 1; l--)
+      {
+        Node * list = this->take(l, (this->current >> (SlotBits * l)) & (Slots - 1));
+        while (list != nullptr)
+        {
+          Node * n = list;
+          list     = list->next;
+          this->link(n, this->current);
+        }
+      }
+
+      Node * list = this->take(0, this->current & (Slots - 1));
+      while (list != nullptr)
+      {
+        Node * n = list;
+        list     = list->next;
+        n->head  = nullptr;
+        this->count--;
+        expire(n);
+      }
+    }
+  }
+};
+
+#if defined(__linux__)
+/**
+  * Single threaded event loop waiting on file descriptors and timers
+  *
+  * The reactor owns one thread blocked in `epoll_wait`, which completes the promises handed out by `sleepFor`,
+  * `readable` and `writable`. Thousands of sockets and timers can thus be waited for without a thread per wait.
+  * Timers have a resolution of one millisecond and are kept in a `TimerWheel`.
+  *
+  * All methods are thread safe. Waits pending when the reactor is destroyed, or started while it is being destroyed,
+  * fail with `cancelled`; tasks passed to `post` at that time are not run. If `epoll_wait` fails, the reactor thread
+  * stops the same way, except that waits fail with a `std::system_error` carrying the error.
+  */
+class Reactor
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using Tick  = std::chrono::milliseconds;
+
+private:
+  struct Timer : TimerWheel::Node
+  {
+    uint64_t          id = 0;
+    Future<void>      future;
+    CancellationToken token;
+    size_t            callbackId = 0;
+  };
+
+  using TimerPool = BlockPool<sizeof(Timer)>;
+
+  struct Waiter
+  {
+    uint64_t          id;
+    Future<void>      future;
+    CancellationToken token;
+    size_t            callbackId;
+  };
+
+  struct FdEntry
+  {
+    std::vector<Waiter> readers;
+    std::vector<Waiter> writers;
+  };
+
+  // State reachable from cancellation callbacks, which may outlive the reactor
+  struct Shared
+  {
+    std::mutex        mtx;
+    std::vector<Task>  posted;
+    bool               stopping = false;
+    std::exception_ptr failure;
+    int                wakeFd = -1;
+
+    ~Shared()
+    {
+      if (this->wakeFd >= 0)
+        close(this->wakeFd);
+    }
+
+    // Tasks posted once the reactor is stopping are dropped right away on the calling thread
+    void post(Task task)
+    {
+      bool wake = false;
+      {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        if (!this->stopping)
+        {
+          wake = this->posted.empty();
+          this->posted.push_back(std::move(task));
+        }
+      }
+
+      if (task)
+        return task(true);
+      if (wake)
+        this->wake();
+    }
+
+    void stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        this->stopping = true;
+      }
+      this->wake();
+    }
+
+    // Stop because the event loop failed, returns the tasks that were still waiting to be run
+    std::vector<Task> fail(std::exception_ptr exc)
+    {
+      std::lock_guard<std::mutex> lock(this->mtx);
+      this->stopping = true;
+      this->failure  = exc;
+      return std::move(this->posted);
+    }
+
+    // Exception for waits that cannot be served anymore
+    std::exception_ptr stopped()
+    {
+      std::lock_guard<std::mutex> lock(this->mtx);
+      return this->failure ? this->failure : std::make_exception_ptr(cancelled("Reactor was destroyed!"));
+    }
+
+    void wake()
+    {
+      uint64_t one = 1;
+      while (::write(this->wakeFd, &one, sizeof(one)) < 0 && errno == EINTR)
+      {
+      }
+    }
+  };
+
+  std::shared_ptr<Shared> shared;
+  int                     epollFd = -1;
+  Clock::time_point       start;
+
+  // Only touched by the reactor thread
+  TimerWheel                            wheel;
+  std::atomic<size_t>                   timerCount{0};
+  std::unordered_map<uint64_t, Timer *> timers;
+  std::unordered_map<int, FdEntry>      fds;
+  std::unordered_map<uint64_t, int>     waiterFds;
+  uint64_t                              nextId = 1;
+
+  std::thread thread;
+
+  bool onReactor() const
+  {
+    return std::this_thread::get_id() == this->thread.get_id();
+  }
+
+  void run(Task task)
+  {
+    if (this->onReactor())
+      task(false);
+    else
+      this->shared->post(std::move(task));
+  }
+
+  uint64_t tickOf(Clock::time_point t) const
+  {
+    if (t <= this->start)
+      return 0;
+    // Round up, so timers never fire early
+    auto ticks = std::chrono::ceil<Tick>(t - this->start).count();
+    return (uint64_t)ticks;
+  }
+
+  uint64_t now() const
+  {
+    return (uint64_t)std::chrono::floor<Tick>(Clock::now() - this->start).count();
+  }
+
+  size_t watchCancel(const CancellationToken& token, uint64_t id)
+  {
+    if (!token.canBeCancelled())
+      return 0;
+
+    std::weak_ptr<Shared> weak = this->shared;
+    return token.onCancel(
+      [weak, this, id]
+      {
+        if (auto s = weak.lock())
+          s->post(
+            [this, id](bool dropped)
+            {
+              if (!dropped)
+                this->cancel(id);
+            });
+      });
+  }
+
+  static void complete(Future<void>& future, const CancellationToken& token, size_t callbackId,
+                       std::exception_ptr exc = nullptr)
+  {
+    token.removeCallback(callbackId);
+    if (exc)
+      future.setThrow(exc);
+    future.finish();
+  }
+
+  void addTimer(uint64_t id, uint64_t deadline, Future<void> future, CancellationToken token)
+  {
+    auto timer        = new (TimerPool::allocate()) Timer();
+    timer->deadline   = deadline;
+    timer->id         = id;
+    timer->future     = std::move(future);
+    timer->token      = std::move(token);
+    timer->callbackId = this->watchCancel(timer->token, id);
+
+    this->timers.emplace(id, timer);
+    this->wheel.add(timer);
+    this->timerCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void finishTimer(Timer * timer, std::exception_ptr exc = nullptr)
+  {
+    this->timers.erase(timer->id);
+    this->timerCount.fetch_sub(1, std::memory_order_relaxed);
+    complete(timer->future, timer->token, timer->callbackId, exc);
+    timer->~Timer();
+    TimerPool::deallocate(timer);
+  }
+
+  // Register interest in the current set of waiters of `fd`, or drop it if there are none
+  void updateInterest(int fd, FdEntry& entry, bool added)
+  {
+    uint32_t events = (entry.readers.empty() ? 0 : EPOLLIN) | (entry.writers.empty() ? 0 : EPOLLOUT);
+    if (events == 0)
+    {
+      epoll_ctl(this->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+      this->fds.erase(fd);
+      return;
+    }
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = events;
+    ev.data.fd = fd;
+
+    if (epoll_ctl(this->epollFd, added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev) != 0)
+    {
+      auto exc = std::make_exception_ptr(
+        std::system_error(errno, std::generic_category(), "Could not wait for fd " + std::to_string(fd)));
+
+      if (!added)
+        epoll_ctl(this->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+
+      FdEntry failed = std::move(entry);
+      this->fds.erase(fd);
+      completeAll(failed.readers, this->waiterFds, exc);
+      completeAll(failed.writers, this->waiterFds, exc);
+    }
+  }
+
+  void addWaiter(int fd, bool write, uint64_t id, Future<void> future, CancellationToken token)
+  {
+    auto it    = this->fds.find(fd);
+    bool added = it == this->fds.end();
+    if (added)
+      it = this->fds.emplace(fd, FdEntry()).first;
+
+    size_t cb   = this->watchCancel(token, id);
+    auto&  list = write ? it->second.writers : it->second.readers;
+
+    // Only the first waiter per direction changes the interest set
+    bool first = list.empty();
+    list.push_back(Waiter{id, std::move(future), std::move(token), cb});
+    this->waiterFds.emplace(id, fd);
+
+    if (first)
+      this->updateInterest(fd, it->second, added);
+  }
+
+  static void completeAll(std::vector<Waiter>& list, std::unordered_map<uint64_t, int>& waiterFds,
+                          std::exception_ptr exc = nullptr)
+  {
+    for (auto& w : list)
+    {
+      waiterFds.erase(w.id);
+      complete(w.future, w.token, w.callbackId, exc);
+    }
+    list.clear();
+  }
+
+  void cancel(uint64_t id)
+  {
+    auto exc = std::make_exception_ptr(cancelled("Wait was cancelled!"));
+
+    auto t = this->timers.find(id);
+    if (t != this->timers.end())
+    {
+      this->wheel.remove(t->second);
+      this->finishTimer(t->second, exc);
+      return;
+    }
+
+    auto w = this->waiterFds.find(id);
+    if (w == this->waiterFds.end())
+      return;
+
+    int   fd    = w->second;
+    auto& entry = this->fds[fd];
+    for (auto * list : {&entry.readers, &entry.writers})
+    {
+      for (size_t i = 0; i < list->size(); i++)
+      {
+        if ((*list)[i].id != id)
+          continue;
+
+        Waiter waiter = std::move((*list)[i]);
+        list->erase(list->begin() + i);
+        this->waiterFds.erase(id);
+
+        if (list->empty())
+          this->updateInterest(fd, entry, false);
+        complete(waiter.future, waiter.token, waiter.callbackId, exc);
+        return;
+      }
+    }
+  }
+
+  static int wait(int epollFd, epoll_event * events, int maxEvents, int timeout)
+  {
+    if (auto hook = waitHook.load(std::memory_order_acquire))
+      return hook(epollFd, events, maxEvents, timeout);
+    return epoll_wait(epollFd, events, maxEvents, timeout);
+  }
+
+  void loop()
+  {
+    std::vector<epoll_event> events(256);
+    std::vector<Task>        posted;
+    bool                     stopping = false;
+
+    while (true)
+    {
+      int timeout = -1;
+      if (!this->wheel.isEmpty())
+      {
+        uint64_t next = this->wheel.nextTick();
+        uint64_t now  = this->now();
+        timeout       = (next <= now) ? 0 : (int)std::min<uint64_t>(next - now, INT_MAX);
+      }
+
+      int n = wait(this->epollFd, events.data(), (int)events.size(), timeout);
+      if (n < 0 && errno != EINTR)
+      {
+        // Nothing can be waited for anymore, so stop like on destruction
+        for (auto& task : this->shared->fail(
+               std::make_exception_ptr(std::system_error(errno, std::generic_category(), "epoll_wait failed"))))
+        {
+          task(true);
+        }
+        break;
+      }
+
+      for (int i = 0; i < n; i++)
+      {
+        int fd = events[i].data.fd;
+        if (fd == this->shared->wakeFd)
+        {
+          uint64_t count;
+          while (::read(fd, &count, sizeof(count)) < 0 && errno == EINTR)
+          {
+          }
+          continue;
+        }
+
+        auto it = this->fds.find(fd);
+        if (it == this->fds.end())
+          continue;
+
+        // Errors and hangups wake both directions, the following read or write reports them. Interest is
+        // updated before completing, since a woken waiter may close the descriptor right away
+        uint32_t            ev = events[i].events;
+        std::vector<Waiter> ready;
+        if (ev & (EPOLLIN | EPOLLERR | EPOLLHUP))
+          ready.swap(it->second.readers);
+        if (ev & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+        {
+          ready.insert(ready.end(), std::make_move_iterator(it->second.writers.begin()),
+                       std::make_move_iterator(it->second.writers.end()));
+          it->second.writers.clear();
+        }
+        this->updateInterest(fd, it->second, false);
+        completeAll(ready, this->waiterFds);
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(this->shared->mtx);
+        posted.swap(this->shared->posted);
+        stopping = this->shared->stopping;
+      }
+      for (auto& task : posted)
+      {
+        task(false);
+      }
+      posted.clear();
+      if (stopping)
+        break;
+
+      this->wheel.advance(this->now(), [&](TimerWheel::Node * node) { this->finishTimer((Timer *)node); });
+    }
+
+    // Fail everything still waiting
+    auto exc = this->shared->stopped();
+    while (!this->timers.empty())
+    {
+      Timer * timer = this->timers.begin()->second;
+      this->wheel.remove(timer);
+      this->finishTimer(timer, exc);
+    }
+    for (auto& entry : this->fds)
+    {
+      epoll_ctl(this->epollFd, EPOLL_CTL_DEL, entry.first, nullptr);
+      completeAll(entry.second.readers, this->waiterFds, exc);
+      completeAll(entry.second.writers, this->waiterFds, exc);
+    }
+    this->fds.clear();
+  }
+
+public:
+  using WaitFn = int (*)(int epollFd, epoll_event * events, int maxEvents, int timeout);
+
+  /**
+    * Replacement for `epoll_wait` if set, so tests can inject failures
+    */
+  static inline std::atomic<WaitFn> waitHook{nullptr};
+
+  /**
+    * @throws std::system_error If epoll cannot be set up
+    */
+  Reactor() : shared(std::make_shared<Shared>()), start(Clock::now())
+  {
+    this->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (this->epollFd < 0)
+      throw std::system_error(errno, std::generic_category(), "Could not create epoll instance");
+
+    this->shared->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (this->shared->wakeFd < 0)
+    {
+      int err = errno;
+      close(this->epollFd);
+      throw std::system_error(err, std::generic_category(), "Could not create eventfd");
+    }
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = EPOLLIN;
+    ev.data.fd = this->shared->wakeFd;
+    epoll_ctl(this->epollFd, EPOLL_CTL_ADD, this->shared->wakeFd, &ev);
+
+    this->thread = std::thread([this] { this->loop(); });
+  }
+
+  Reactor(const Reactor&)            = delete;
+  Reactor& operator=(const Reactor&) = delete;
+
+  /**
+    * @note Must not be called from the reactor thread
+    */
+  ~Reactor()
+  {
+    this->shared->stop();
+    this->thread.join();
+    close(this->epollFd);
+  }
+
+  /**
+    * Run `f` on the reactor thread
+    *
+    * @note `f` is not run if the reactor is being destroyed
+    */
+  template <typename F> void post(F&& f)
+  {
+    this->shared->post(
+      [f = std::forward<F>(f)](bool dropped) mutable
+      {
+        if (!dropped)
+          f();
+      });
+  }
+
+  /**
+    * Promise finishing after `duration`
+    */
+  template <typename Rep, typename Period>
+  Promise<void> sleepFor(const std::chrono::duration<Rep, Period>& duration,
+                         const CancellationToken&                  token = CancellationToken())
+  {
+    return this->sleepUntil(Clock::now() + std::chrono::duration_cast<Clock::duration>(duration), token);
+  }
+
+  /**
+    * Promise finishing once `deadline` has passed
+    *
+    * @param token Cancelling the token fails the promise with `cancelled`
+    */
+  Promise<void> sleepUntil(Clock::time_point deadline, const CancellationToken& token = CancellationToken())
+  {
+    Future<void> future;
+    auto         res  = future.asPromise();
+    uint64_t     tick = this->tickOf(deadline);
+
+    this->run(
+      [this, tick, future = std::move(future), token](bool dropped) mutable
+      {
+        if (dropped)
+          return complete(future, token, 0, this->shared->stopped());
+        this->addTimer(this->nextId++, tick, std::move(future), std::move(token));
+      });
+    return res;
+  }
+
+  /**
+    * Promise finishing once `fd` has data to read, reached end of file or has an error pending
+    *
+    * @param token Cancelling the token fails the promise with `cancelled`
+    * @note `fd` must support epoll, e.g. a socket or pipe, and stay open until the promise is finished
+    */
+  Promise<void> readable(int fd, const CancellationToken& token = CancellationToken())
+  {
+    return this->waitFd(fd, false, token);
+  }
+
+  /**
+    * Promise finishing once data can be written to `fd` or it has an error pending
+    *
+    * @see readable
+    */
+  Promise<void> writable(int fd, const CancellationToken& token = CancellationToken())
+  {
+    return this->waitFd(fd, true, token);
+  }
+
+  /**
+    * Amount of pending timers
+    */
+  size_t getTimerCount() const
+  {
+    return this->timerCount.load(std::memory_order_relaxed);
+  }
+
+private:
+  Promise<void> waitFd(int fd, bool write, const CancellationToken& token)
+  {
+    Future<void> future;
+    auto         res = future.asPromise();
+
+    this->run(
+      [this, fd, write, future = std::move(future), token](bool dropped) mutable
+      {
+        if (dropped)
+          return complete(future, token, 0, this->shared->stopped());
+        this->addWaiter(fd, write, this->nextId++, std::move(future), std::move(token));
+      });
+    return res;
+  }
+};
+#endif
+} // namespace CppUtil
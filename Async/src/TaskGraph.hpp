@@ -0,0 +1,389 @@
+#pragma once
+
+#include "Array.hpp"
+#include "Async.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CppUtil
+{
+/**
+  * Directed acyclic graph of tasks executed on a `ThreadPool`
+  *
+  * A node is started as soon as all nodes it depends on are finished, so independent branches run in parallel.
+  * A worker finishing a node continues with one of the successors it made ready instead of queueing it.
+  */
+class TaskGraph
+{
+public:
+  using NodeId   = size_t;
+  using Duration = std::chrono::nanoseconds;
+
+  /**
+    * Timings of a single `run()`
+    */
+  struct Stats
+  {
+    // Run time of every node, indexed by NodeId
+    Array<Duration> durations;
+
+    // Chain of dependent nodes with the longest total run time, in execution order
+    Array<NodeId> criticalPath;
+    Duration      criticalPathTime{0};
+
+    Duration wallTime{0};
+  };
+
+private:
+  static constexpr NodeId None = SIZE_MAX;
+
+  struct Node
+  {
+    std::string           name;
+    std::function<void()> func;
+    std::vector<NodeId>   successors;
+    size_t                predecessors = 0;
+  };
+
+  struct RunState
+  {
+    const TaskGraph * graph;
+    ThreadPool *      pool;
+
+    std::unique_ptr<std::atomic<size_t>[]> pending;
+    std::atomic<size_t>                    remaining{0};
+    Array<Duration>                        durations;
+
+    // Once a node threw, the nodes not yet started are skipped
+    std::atomic<bool>  failed{false};
+    std::exception_ptr exc;
+
+    Future<void> done;
+  };
+
+  std::vector<Node> nodes;
+
+  void checkId(NodeId id) const
+  {
+    if (id >= this->nodes.size())
+      throw std::out_of_range("Node " + std::to_string(id) + " does not exist in TaskGraph of size " +
+                              std::to_string(this->nodes.size()) + "!");
+  }
+
+  // Kahn's algorithm
+  std::vector<NodeId> topologicalOrder() const
+  {
+    std::vector<size_t> indegree(this->nodes.size());
+    std::vector<NodeId> order;
+    order.reserve(this->nodes.size());
+
+    for (NodeId i = 0; i < this->nodes.size(); i++)
+    {
+      indegree[i] = this->nodes[i].predecessors;
+      if (indegree[i] == 0)
+        order.push_back(i);
+    }
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+      for (NodeId s : this->nodes[order[i]].successors)
+      {
+        if (--indegree[s] == 0)
+          order.push_back(s);
+      }
+    }
+
+    if (order.size() != this->nodes.size())
+      throw std::invalid_argument("TaskGraph contains a cycle!");
+    return order;
+  }
+
+  static void submit(const std::shared_ptr<RunState>& state, NodeId id)
+  {
+    state->pool->submit([state, id] { execute(state, id); });
+  }
+
+  static void execute(const std::shared_ptr<RunState>& state, NodeId id)
+  {
+    while (id != None)
+    {
+      const Node& node = state->graph->nodes[id];
+
+      if (!state->failed.load(std::memory_order_relaxed))
+      {
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+          node.func();
+        }
+        catch (...)
+        {
+          if (!state->failed.exchange(true))
+            state->exc = std::current_exception();
+        }
+        state->durations[id] = std::chrono::steady_clock::now() - start;
+      }
+
+      NodeId next = None;
+      for (NodeId s : node.successors)
+      {
+        if (state->pending[s].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+          if (next == None)
+            next = s;
+          else
+            submit(state, s);
+        }
+      }
+
+      if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        if (state->exc)
+          state->done.setThrow(state->exc);
+        state->done.finish();
+      }
+      id = next;
+    }
+  }
+
+  void computeCriticalPath(const std::vector<NodeId>& order, Stats& stats) const
+  {
+    // Latest finish time of any predecessor, and the predecessor it belongs to
+    std::vector<Duration> ready(this->nodes.size(), Duration(0));
+    std::vector<NodeId>   prev(this->nodes.size(), None);
+
+    NodeId last = None;
+    for (NodeId id : order)
+    {
+      Duration finish = ready[id] + stats.durations[id];
+      for (NodeId s : this->nodes[id].successors)
+      {
+        if (prev[s] == None || finish > ready[s])
+        {
+          ready[s] = finish;
+          prev[s]  = id;
+        }
+      }
+
+      if (last == None || finish > stats.criticalPathTime)
+      {
+        stats.criticalPathTime = finish;
+        last                   = id;
+      }
+    }
+
+    size_t length = 0;
+    for (NodeId id = last; id != None; id = prev[id])
+    {
+      length++;
+    }
+
+    stats.criticalPath = Array<NodeId>(length);
+    for (NodeId id = last; id != None; id = prev[id])
+    {
+      stats.criticalPath[--length] = id;
+    }
+  }
+
+public:
+  /**
+    * Add a node running `func`
+    *
+    * @return Id of the new node, used to declare its dependencies
+    */
+  NodeId addNode(std::string name, std::function<void()> func)
+  {
+    this->nodes.push_back(Node{std::move(name), std::move(func), {}, 0});
+    return this->nodes.size() - 1;
+  }
+
+  NodeId addNode(std::function<void()> func)
+  {
+    return this->addNode("#" + std::to_string(this->nodes.size()), std::move(func));
+  }
+
+  /**
+    * Declare that node `to` depends on node `from`, i.e. `to` only starts after `from` is finished
+    */
+  void addEdge(NodeId from, NodeId to)
+  {
+    this->checkId(from);
+    this->checkId(to);
+
+    this->nodes[from].successors.push_back(to);
+    this->nodes[to].predecessors++;
+  }
+
+  size_t getSize() const
+  {
+    return this->nodes.size();
+  }
+
+  const std::string& getName(NodeId id) const
+  {
+    this->checkId(id);
+    return this->nodes[id].name;
+  }
+
+  /**
+    * Run all nodes on `pool` and block until they are finished
+    *
+    * If a node throws, nodes that did not start yet are skipped and the first exception is rethrown.
+    *
+    * @throws std::invalid_argument If the graph contains a cycle; no node is run in that case
+    * @note Must not be called from a worker of `pool`, as the caller blocks without taking part in the work.
+    */
+  Stats run(ThreadPool& pool) const
+  {
+    auto  order = this->topologicalOrder();
+    Stats stats;
+
+    if (this->nodes.empty())
+      return stats;
+
+    auto state   = std::make_shared<RunState>();
+    state->graph = this;
+    state->pool  = &pool;
+    state->pending.reset(new std::atomic<size_t>[this->nodes.size()]);
+    state->remaining = this->nodes.size();
+    state->durations = Array<Duration>(this->nodes.size());
+
+    for (NodeId i = 0; i < this->nodes.size(); i++)
+    {
+      state->pending[i] = this->nodes[i].predecessors;
+    }
+
+    auto promise = state->done.asPromise();
+    auto start   = std::chrono::steady_clock::now();
+
+    for (NodeId i = 0; i < this->nodes.size(); i++)
+    {
+      if (this->nodes[i].predecessors == 0)
+        submit(state, i);
+    }
+
+    promise.wait();
+    stats.wallTime = std::chrono::steady_clock::now() - start;
+    promise.get();
+
+    stats.durations = std::move(state->durations);
+    this->computeCriticalPath(order, stats);
+    return stats;
+  }
+
+  /**
+    * Write wall time and critical path of a run in a human readable form
+    */
+  void report(const Stats& stats, std::ostream& out) const
+  {
+    auto ms = [](Duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    out << "wall time: " << ms(stats.wallTime) << " ms, critical path: " << ms(stats.criticalPathTime) << " ms\n";
+    for (size_t i = 0; i < stats.criticalPath.getSize(); i++)
+    {
+      NodeId id = stats.criticalPath[i];
+      out << "  " << this->getName(id) << ": " << ms(stats.durations[id]) << " ms\n";
+    }
+  }
+};
+
+/**
+  * Call `f` for every index in [begin, end) using the workers of `pool`
+  *
+  * Indices are handed out on demand in chunks of `grain`, so uneven work per index balances out. The calling
+  * thread processes chunks as well, which makes nested use from within pool tasks safe.
+  * `f` either takes a single index, or the bounds `(first, last)` of a whole chunk.
+  *
+  * If `f` throws, the remaining chunks are skipped and the first exception is rethrown.
+  */
+template <typename F> void parallelFor(ThreadPool& pool, size_t begin, size_t end, size_t grain, F&& f)
+{
+  static_assert(std::is_invocable_v<F&, size_t> || std::is_invocable_v<F&, size_t, size_t>,
+                "parallelFor function must take an index or the bounds of a chunk!");
+
+  if (begin >= end)
+    return;
+  if (grain == 0)
+    grain = 1;
+
+  struct State
+  {
+    size_t begin, end, grain, chunks;
+    F *    f;
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+
+    std::atomic<bool>  failed{false};
+    std::exception_ptr exc;
+
+    Future<void> done;
+
+    // Process chunks until none are left
+    static void work(const std::shared_ptr<State>& s)
+    {
+      size_t c;
+      while ((c = s->next.fetch_add(1, std::memory_order_relaxed)) < s->chunks)
+      {
+        size_t first = s->begin + c * s->grain;
+        size_t last  = first + std::min(s->grain, s->end - first);
+
+        if (!s->failed.load(std::memory_order_relaxed))
+        {
+          try
+          {
+            if constexpr (std::is_invocable_v<F&, size_t, size_t>)
+            {
+              (*s->f)(first, last);
+            }
+            else
+            {
+              for (size_t i = first; i < last; i++)
+                (*s->f)(i);
+            }
+          }
+          catch (...)
+          {
+            if (!s->failed.exchange(true))
+              s->exc = std::current_exception();
+          }
+        }
+
+        if (s->finished.fetch_add(1, std::memory_order_acq_rel) + 1 == s->chunks)
+        {
+          if (s->exc)
+            s->done.setThrow(s->exc);
+          s->done.finish();
+        }
+      }
+    }
+  };
+
+  auto state    = std::make_shared<State>();
+  state->begin  = begin;
+  state->end    = end;
+  state->grain  = grain;
+  state->chunks = (end - begin) / grain + ((end - begin) % grain != 0);
+  state->f      = &f;
+
+  auto promise = state->done.asPromise();
+
+  // Helpers starting after all chunks are taken return right away, so they never touch `f` after we return
+  size_t helpers = std::min(pool.getSize(), state->chunks - 1);
+  for (size_t i = 0; i < helpers; i++)
+  {
+    pool.submit([state] { State::work(state); });
+  }
+
+  State::work(state);
+  promise.get();
+}
+} // namespace CppUtil
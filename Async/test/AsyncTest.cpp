@@ -1,6 +1,8 @@
 #include "../src/Async.hpp"
 
+#include <array>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 
 #include "CatchVer.hpp"
@@ -131,4 +133,277 @@ TEST_CASE("Test Async", "[async]")
   {
     REQUIRE(100 == __await__(func, 1, 2));
   }
+
+  SECTION("Results of any size fit their pool blocks", "[pool]")
+  {
+    struct Odd
+    {
+      long double f;
+      char        c[17];
+    };
+
+    auto big = CppUtil::Async::async<std::array<char, 4'097>>(
+      []
+      {
+        std::array<char, 4'097> res;
+        res.fill('x');
+        return res;
+      });
+    auto odd = CppUtil::Async::async<Odd>([] { return Odd{1.5L, "sixteen chars..."}; });
+
+    REQUIRE('x' == big.get()[4'096]);
+    REQUIRE(1.5L == odd.get().f);
+  }
+}
+
+TEST_CASE("Test Async timeouts", "[async][timeout]")
+{
+  auto slow = CppUtil::Async::async<int>(
+    []
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(300));
+      return 1;
+    });
+
+  SECTION("Waiting for a running task times out")
+  {
+    REQUIRE_FALSE(slow.waitFor(std::chrono::milliseconds(10)));
+    REQUIRE_FALSE(slow.waitUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(10)));
+    REQUIRE_THROWS_AS(slow.getFor(std::chrono::milliseconds(10)), timed_out);
+  }
+
+  SECTION("Waiting for a task finishing in time succeeds")
+  {
+    REQUIRE(slow.waitFor(std::chrono::seconds(5)));
+    REQUIRE(1 == slow.getFor(std::chrono::milliseconds(0)));
+  }
+
+  SECTION("void tasks can be waited for with a timeout")
+  {
+    auto res = CppUtil::Async::async<void>([] { std::this_thread::sleep_for(std::chrono::milliseconds(300)); });
+
+    REQUIRE_THROWS_AS(res.getFor(std::chrono::milliseconds(10)), timed_out);
+    REQUIRE_NOTHROW(res.getFor(std::chrono::seconds(5)));
+  }
+}
+
+TEST_CASE("Test Async cancellation", "[async][cancel]")
+{
+  CancellationSource source;
+
+  SECTION("Tasks receive their cancellation token")
+  {
+    auto res = CppUtil::Async::async<int>(source.token(),
+                                          [](const CancellationToken& token)
+                                          {
+                                            while (!token.isCancelled())
+                                            {
+                                              std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                            }
+                                            return 5;
+                                          });
+
+    REQUIRE_FALSE(res.waitFor(std::chrono::milliseconds(20)));
+    source.cancel();
+    REQUIRE(5 == res.getFor(std::chrono::seconds(5)));
+  }
+
+  SECTION("Tasks can throw when they are cancelled")
+  {
+    auto res = CppUtil::Async::async<void>(
+      source.token(),
+      [](const CancellationToken& token, int ms)
+      {
+        while (true)
+        {
+          token.throwIfCancelled();
+          std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        }
+      },
+      1);
+
+    source.cancel();
+    REQUIRE_THROWS_AS(res.getFor(std::chrono::seconds(5)), cancelled);
+  }
+
+  SECTION("Tasks with an already cancelled token do not run")
+  {
+    std::atomic<bool> ran{false};
+    source.cancel();
+
+    auto res = CppUtil::Async::async<void>(source.token(), [&] { ran = true; });
+
+    REQUIRE_THROWS_AS(res.get(), cancelled);
+    REQUIRE_FALSE(ran);
+  }
+
+  SECTION("Cancellation propagates to linked sources")
+  {
+    CancellationSource child(source.token());
+    CancellationSource grandChild(child.token());
+
+    auto res = CppUtil::Async::async<int>(grandChild.token(),
+                                          [](const CancellationToken& token)
+                                          {
+                                            auto inner = CppUtil::Async::async<int>(token,
+                                                                                    [](const CancellationToken& t)
+                                                                                    {
+                                                                                      while (!t.isCancelled())
+                                                                                      {
+                                                                                        std::this_thread::yield();
+                                                                                      }
+                                                                                      t.throwIfCancelled();
+                                                                                      return 1;
+                                                                                    });
+                                            return inner.get();
+                                          });
+
+    REQUIRE_FALSE(child.isCancelled());
+    source.cancel();
+
+    REQUIRE(child.isCancelled());
+    REQUIRE(grandChild.isCancelled());
+    REQUIRE_THROWS_AS(res.getFor(std::chrono::seconds(5)), cancelled);
+  }
+
+  SECTION("Cancelling a child does not cancel its parent")
+  {
+    CancellationSource child(source.token());
+    child.cancel();
+
+    REQUIRE(child.isCancelled());
+    REQUIRE_FALSE(source.isCancelled());
+  }
+}
+
+TEST_CASE("Test ThreadPool", "[async][pool]")
+{
+  ThreadPool pool(2);
+
+  SECTION("Tasks can be run on a thread pool")
+  {
+    auto a = CppUtil::Async::async<int>(
+      pool, [](int x) { return x * 2; }, 21);
+    auto b = CppUtil::Async::async<void>(pool, [] {});
+
+    REQUIRE(42 == a.get());
+    REQUIRE_NOTHROW(b.get());
+  }
+
+  SECTION("Queued tasks are dropped without running when they are cancelled")
+  {
+    std::atomic<bool> release{false};
+    std::atomic<int>  ran{0};
+
+    // Block both workers, so the next task stays queued
+    auto blocker1 = CppUtil::Async::async<void>(pool,
+                                                [&]
+                                                {
+                                                  while (!release)
+                                                    std::this_thread::yield();
+                                                });
+    auto blocker2 = CppUtil::Async::async<void>(pool,
+                                                [&]
+                                                {
+                                                  while (!release)
+                                                    std::this_thread::yield();
+                                                });
+
+    CancellationSource source;
+    auto               queued = CppUtil::Async::async<void>(pool, source.token(), [&] { ran++; });
+
+    REQUIRE_FALSE(queued.waitFor(std::chrono::milliseconds(20)));
+    source.cancel();
+
+    // The promise completes right away, even though both workers are still blocked
+    REQUIRE_THROWS_AS(queued.getFor(std::chrono::seconds(5)), cancelled);
+
+    release = true;
+    blocker1.get();
+    blocker2.get();
+
+    REQUIRE(0 == ran);
+    REQUIRE(0 == pool.getQueued());
+  }
+
+  SECTION("Jobs run in FIFO order, even when the queue has to grow")
+  {
+    ThreadPool       single(1);
+    std::atomic<int> next{0};
+    std::atomic<int> outOfOrder{0};
+
+    std::vector<Promise<void>> promises;
+    for (int i = 0; i < 1'000; i++)
+    {
+      promises.push_back(CppUtil::Async::async<void>(single,
+                                                     [&, i]
+                                                     {
+                                                       if (next++ != i)
+                                                         outOfOrder++;
+                                                     }));
+    }
+
+    for (auto& p : promises)
+    {
+      p.get();
+    }
+    REQUIRE(1'000 == next);
+    REQUIRE(0 == outOfOrder);
+  }
+
+  SECTION("Results without default constructor and big captures are supported")
+  {
+    struct Sum
+    {
+      explicit Sum(int v) : v(v) {}
+      int v;
+    };
+
+    std::array<int, 64> big;
+    big.fill(1);
+
+    auto p = CppUtil::Async::async<Sum>(pool,
+                                        [big]
+                                        {
+                                          int sum = 0;
+                                          for (int x : big)
+                                            sum += x;
+                                          return Sum(sum);
+                                        });
+
+    REQUIRE(64 == p.get().v);
+  }
+}
+
+TEST_CASE("Test Task", "[async][task]")
+{
+  SECTION("Small callables are stored inline and can be moved")
+  {
+    int  calls = 0;
+    Task a([&](bool dropped) { calls += dropped ? 10 : 1; });
+    Task b(std::move(a));
+
+    REQUIRE_FALSE(a);
+    REQUIRE(b);
+
+    b();
+    b(true);
+    REQUIRE(11 == calls);
+  }
+
+  SECTION("Big callables are stored on the heap")
+  {
+    auto counter = std::make_shared<int>(0);
+    {
+      std::array<char, 256> pad{};
+      Task                  a([counter, pad](bool) { (*counter)++; });
+      Task                  b;
+      b = std::move(a);
+      b();
+      REQUIRE(2 == counter.use_count());
+    }
+
+    REQUIRE(1 == *counter);
+    REQUIRE(1 == counter.use_count());
+  }
 }
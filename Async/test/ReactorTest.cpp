@@ -0,0 +1,276 @@
+#include "../src/Reactor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <memory>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+using namespace std::chrono_literals;
+
+TEST_CASE("Test TimerWheel", "[async][timer_wheel]")
+{
+  SECTION("Timers expire exactly at their deadline, in any order of insertion")
+  {
+    std::mt19937_64 rng(42);
+    TimerWheel      wheel;
+
+    // Deadlines spread over all levels, including ones beyond the range of the wheel
+    std::vector<TimerWheel::Node> nodes(5'000);
+    for (auto& n : nodes)
+    {
+      uint64_t range = (uint64_t)1 << (6 * (1 + rng() % 5));
+      n.deadline     = 1 + rng() % range;
+      wheel.add(&n);
+    }
+    REQUIRE(nodes.size() == wheel.getCount());
+
+    std::vector<std::pair<uint64_t, uint64_t>> fired; // (tick, deadline)
+    uint64_t                                   now = 0;
+    while (!wheel.isEmpty())
+    {
+      // Jump in steps of varying size, so skipping and single ticks are both covered
+      now += 1 + rng() % 5'000;
+      wheel.advance(now, [&](TimerWheel::Node * n) { fired.emplace_back(wheel.getTick(), n->deadline); });
+    }
+
+    REQUIRE(nodes.size() == fired.size());
+    for (auto& f : fired)
+    {
+      REQUIRE(f.first == f.second);
+    }
+    REQUIRE(std::is_sorted(fired.begin(), fired.end()));
+  }
+
+  SECTION("Removed timers do not expire")
+  {
+    TimerWheel       wheel;
+    TimerWheel::Node a, b;
+    a.deadline = 10;
+    b.deadline = 5'000;
+    wheel.add(&a);
+    wheel.add(&b);
+
+    wheel.remove(&b);
+    REQUIRE_FALSE(wheel.contains(&b));
+
+    size_t count = 0;
+    wheel.advance(10'000, [&](TimerWheel::Node *) { count++; });
+    REQUIRE(1 == count);
+    REQUIRE(wheel.isEmpty());
+  }
+
+  SECTION("Past deadlines expire on the next tick")
+  {
+    TimerWheel       wheel(100);
+    TimerWheel::Node a;
+    a.deadline = 50;
+    wheel.add(&a);
+
+    REQUIRE(101 == wheel.nextTick());
+    uint64_t tick = 0;
+    wheel.advance(200, [&](TimerWheel::Node *) { tick = wheel.getTick(); });
+    REQUIRE(101 == tick);
+  }
+}
+
+#if defined(__linux__)
+TEST_CASE("Test Reactor", "[async][reactor]")
+{
+  Reactor reactor;
+
+  SECTION("Sleeps finish after their duration")
+  {
+    auto start = std::chrono::steady_clock::now();
+    reactor.sleepFor(50ms).get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(elapsed >= 50ms);
+    REQUIRE(elapsed < 500ms);
+  }
+
+  SECTION("Many sleeps share the reactor thread and finish in deadline order")
+  {
+    std::vector<Promise<void>> sleeps;
+    for (int i = 10; i > 0; i--)
+    {
+      sleeps.push_back(reactor.sleepFor(std::chrono::milliseconds(i * 10)));
+    }
+
+    sleeps.front().wait();
+    for (auto& s : sleeps)
+    {
+      REQUIRE(s.isFinished());
+    }
+  }
+
+  SECTION("Cancelled sleeps fail with cancelled")
+  {
+    CancellationSource source;
+    auto               sleep = reactor.sleepFor(10s, source.token());
+    source.cancel();
+
+    REQUIRE_THROWS_AS(sleep.getFor(1s), cancelled);
+  }
+
+  SECTION("Readable finishes once data arrives")
+  {
+    int fds[2];
+    REQUIRE(0 == pipe(fds));
+
+    auto readable = reactor.readable(fds[0]);
+    REQUIRE_FALSE(readable.waitFor(20ms));
+
+    REQUIRE(1 == write(fds[1], "x", 1));
+    REQUIRE_NOTHROW(readable.getFor(1s));
+
+    close(fds[0]);
+    close(fds[1]);
+  }
+
+  SECTION("Writable finishes right away on an empty pipe")
+  {
+    int fds[2];
+    REQUIRE(0 == pipe(fds));
+
+    REQUIRE_NOTHROW(reactor.writable(fds[1]).getFor(1s));
+
+    close(fds[0]);
+    close(fds[1]);
+  }
+
+  SECTION("Waiting on descriptors without epoll support fails")
+  {
+    REQUIRE_THROWS_AS(reactor.readable(-1).getFor(1s), std::system_error);
+  }
+
+  SECTION("Thousands of connections can be multiplexed")
+  {
+    constexpr size_t                Count = 1'000;
+    std::vector<std::array<int, 2>> pairs(Count);
+    std::vector<Promise<void>>      waits;
+
+    for (auto& p : pairs)
+    {
+      REQUIRE(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, p.data()));
+      waits.push_back(reactor.readable(p[0]));
+    }
+
+    // Wake every other connection only
+    for (size_t i = 0; i < Count; i += 2)
+    {
+      REQUIRE(1 == write(pairs[i][1], "x", 1));
+    }
+    for (size_t i = 0; i < Count; i += 2)
+    {
+      REQUIRE_NOTHROW(waits[i].getFor(1s));
+    }
+
+    reactor.sleepFor(20ms).get();
+    for (size_t i = 1; i < Count; i += 2)
+    {
+      REQUIRE_FALSE(waits[i].isFinished());
+    }
+
+    for (auto& p : pairs)
+    {
+      close(p[1]);
+    }
+    for (auto& w : waits)
+    {
+      REQUIRE_NOTHROW(w.getFor(1s));
+    }
+    for (auto& p : pairs)
+    {
+      close(p[0]);
+    }
+  }
+
+  SECTION("Pending waits fail when the reactor is destroyed")
+  {
+    auto other = std::make_unique<Reactor>();
+    auto sleep = other->sleepFor(10s);
+
+    other.reset();
+    REQUIRE_THROWS_AS(sleep.get(), cancelled);
+  }
+
+  SECTION("Waits started while the reactor is destroyed fail")
+  {
+    auto               other = std::make_unique<Reactor>();
+    Reactor *          raw   = other.get();
+    std::promise<void> busy, blocked, inLast, released;
+    auto               block   = blocked.get_future().share();
+    auto               release = released.get_future().share();
+
+    // Keep the reactor busy, so the second task runs in the iteration that sees the stop request
+    raw->post(
+      [&busy, block]
+      {
+        busy.set_value();
+        block.wait();
+      });
+    busy.get_future().wait();
+    raw->post(
+      [&inLast, release]
+      {
+        inLast.set_value();
+        release.wait();
+      });
+
+    std::thread destroyer([&] { other.reset(); });
+    std::this_thread::sleep_for(50ms);
+    blocked.set_value();
+    inLast.get_future().wait();
+
+    auto sleep = raw->sleepFor(10s);
+    released.set_value();
+    destroyer.join();
+
+    REQUIRE_THROWS_AS(sleep.get(), cancelled);
+  }
+
+  SECTION("Waits fail when epoll_wait fails")
+  {
+    auto other = std::make_unique<Reactor>();
+    auto sleep = other->sleepFor(10s);
+    while (other->getTimerCount() == 0)
+    {
+      std::this_thread::sleep_for(1ms);
+    }
+
+    Reactor::waitHook = [](int, epoll_event *, int, int)
+    {
+      errno = EBADF;
+      return -1;
+    };
+    // Wake the reactor, so it waits again and fails
+    other->post([] {});
+
+    try
+    {
+      sleep.getFor(1s);
+      FAIL("Sleep did not fail");
+    }
+    catch (const std::system_error& e)
+    {
+      REQUIRE(EBADF == e.code().value());
+    }
+    Reactor::waitHook = nullptr;
+
+    REQUIRE_THROWS_AS(other->sleepFor(10s).getFor(1s), std::system_error);
+    bool ran = false;
+    other->post([&ran] { ran = true; });
+    other.reset();
+    REQUIRE_FALSE(ran);
+  }
+}
+#endif
@@ -0,0 +1,225 @@
+#include "../src/TaskGraph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+using namespace std::chrono_literals;
+
+TEST_CASE("Test TaskGraph", "[async][graph]")
+{
+  ThreadPool pool(4);
+  TaskGraph  graph;
+
+  std::mutex          mtx;
+  std::vector<size_t> order;
+
+  auto record = [&](size_t id)
+  {
+    return [&, id]
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      order.push_back(id);
+    };
+  };
+
+  auto position = [&](size_t id) { return std::find(order.begin(), order.end(), id) - order.begin(); };
+
+  SECTION("Nodes run after all their dependencies")
+  {
+    // a -> {b, c} -> d
+    auto a = graph.addNode("a", record(0));
+    auto b = graph.addNode("b", record(1));
+    auto c = graph.addNode("c", record(2));
+    auto d = graph.addNode("d", record(3));
+
+    graph.addEdge(a, b);
+    graph.addEdge(a, c);
+    graph.addEdge(b, d);
+    graph.addEdge(c, d);
+
+    graph.run(pool);
+
+    REQUIRE(4 == order.size());
+    REQUIRE(position(0) < position(1));
+    REQUIRE(position(0) < position(2));
+    REQUIRE(position(1) < position(3));
+    REQUIRE(position(2) < position(3));
+  }
+
+  SECTION("A graph can be run multiple times")
+  {
+    auto a = graph.addNode(record(0));
+    auto b = graph.addNode(record(1));
+    graph.addEdge(a, b);
+
+    graph.run(pool);
+    graph.run(pool);
+
+    REQUIRE(std::vector<size_t>{0, 1, 0, 1} == order);
+  }
+
+  SECTION("Independent nodes run in parallel")
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      graph.addNode([] { std::this_thread::sleep_for(100ms); });
+    }
+
+    auto stats = graph.run(pool);
+
+    REQUIRE(stats.wallTime < 300ms);
+    REQUIRE(1 == stats.criticalPath.getSize());
+  }
+
+  SECTION("Cycles are rejected without running any node")
+  {
+    auto a = graph.addNode(record(0));
+    auto b = graph.addNode(record(1));
+    auto c = graph.addNode(record(2));
+    graph.addEdge(a, b);
+    graph.addEdge(b, c);
+    graph.addEdge(c, b);
+
+    REQUIRE_THROWS_AS(graph.run(pool), std::invalid_argument);
+    REQUIRE(order.empty());
+  }
+
+  SECTION("Edges to unknown nodes are rejected")
+  {
+    auto a = graph.addNode(record(0));
+
+    REQUIRE_THROWS_AS(graph.addEdge(a, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(graph.addEdge(5, a), std::out_of_range);
+  }
+
+  SECTION("Exceptions are rethrown and dependent nodes are skipped")
+  {
+    auto a = graph.addNode([] { throw std::runtime_error("Failed!"); });
+    auto b = graph.addNode(record(1));
+    graph.addEdge(a, b);
+
+    REQUIRE_THROWS_AS(graph.run(pool), std::runtime_error);
+    REQUIRE(order.empty());
+  }
+
+  SECTION("The critical path is the chain with the longest run time")
+  {
+    // slow -> end is longer than fast1 -> fast2 -> end
+    auto slow  = graph.addNode("slow", [] { std::this_thread::sleep_for(150ms); });
+    auto fast1 = graph.addNode("fast1", [] { std::this_thread::sleep_for(20ms); });
+    auto fast2 = graph.addNode("fast2", [] { std::this_thread::sleep_for(20ms); });
+    auto end   = graph.addNode("end", [] {});
+
+    graph.addEdge(slow, end);
+    graph.addEdge(fast1, fast2);
+    graph.addEdge(fast2, end);
+
+    auto stats = graph.run(pool);
+
+    REQUIRE(Array<TaskGraph::NodeId>{slow, end} == stats.criticalPath);
+    REQUIRE(stats.criticalPathTime >= 150ms);
+    REQUIRE(stats.durations[fast1] >= 20ms);
+
+    std::ostringstream out;
+    graph.report(stats, out);
+    REQUIRE(out.str().find("slow") != std::string::npos);
+    REQUIRE(out.str().find("fast1") == std::string::npos);
+  }
+
+  SECTION("Empty graphs finish right away")
+  {
+    auto stats = graph.run(pool);
+    REQUIRE(stats.criticalPath.isEmpty());
+  }
+}
+
+TEST_CASE("Test parallelFor", "[async][parallel]")
+{
+  ThreadPool pool(4);
+
+  SECTION("Every index is visited exactly once")
+  {
+    std::vector<std::atomic<int>> visits(10'000);
+
+    parallelFor(pool, 0, visits.size(), 64, [&](size_t i) { visits[i]++; });
+
+    for (auto& v : visits)
+    {
+      REQUIRE(1 == v);
+    }
+  }
+
+  SECTION("Whole chunks can be processed at once")
+  {
+    std::atomic<size_t> sum{0};
+    std::atomic<size_t> chunks{0};
+    std::atomic<size_t> oversized{0};
+
+    parallelFor(pool, 10, 1'010, 100,
+                [&](size_t first, size_t last)
+                {
+                  if (last - first > 100)
+                    oversized++;
+                  for (size_t i = first; i < last; i++)
+                    sum += i;
+                  chunks++;
+                });
+
+    REQUIRE(10 == chunks);
+    REQUIRE(0 == oversized);
+    REQUIRE((10 + 1'009) * 1'000 / 2 == sum);
+  }
+
+  SECTION("Grains covering the whole range form a single chunk")
+  {
+    for (size_t grain : {(size_t)100, (size_t)1'000, SIZE_MAX})
+    {
+      size_t chunks = 0;
+      size_t count  = 0;
+      parallelFor(pool, 0, 100, grain,
+                  [&](size_t first, size_t last)
+                  {
+                    chunks++;
+                    count += last - first;
+                  });
+
+      REQUIRE(1 == chunks);
+      REQUIRE(100 == count);
+    }
+  }
+
+  SECTION("Empty ranges do not call the function")
+  {
+    bool called = false;
+    parallelFor(pool, 5, 5, 1, [&](size_t) { called = true; });
+    REQUIRE_FALSE(called);
+  }
+
+  SECTION("Exceptions are rethrown")
+  {
+    REQUIRE_THROWS_AS(parallelFor(pool, 0, 1'000, 1,
+                                  [](size_t i)
+                                  {
+                                    if (i == 500)
+                                      throw std::runtime_error("Failed!");
+                                  }),
+                      std::runtime_error);
+  }
+
+  SECTION("parallelFor can be nested inside pool tasks")
+  {
+    std::atomic<size_t> count{0};
+
+    parallelFor(pool, 0, 16, 1, [&](size_t) { parallelFor(pool, 0, 100, 10, [&](size_t) { count++; }); });
+
+    REQUIRE(1'600 == count);
+  }
+}
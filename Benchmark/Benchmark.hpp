@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace CppUtil
+{
+/**
+  * Minimal timing helpers shared by the `*Bench` executables
+  */
+class Benchmark
+{
+public:
+  /**
+    * Run `f` `reps` times and return the fastest run in seconds
+    */
+  template <typename F> static double measure(F&& f, size_t reps = 5)
+  {
+    double best = -1;
+    for (size_t i = 0; i < reps; i++)
+    {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      auto   end = std::chrono::steady_clock::now();
+      double sec = std::chrono::duration<double>(end - start).count();
+
+      if (best < 0 || sec < best)
+        best = sec;
+    }
+    return best;
+  }
+
+  /**
+    * Run `setup` and then `f` `reps` times and return the fastest run of `f` in seconds
+    *
+    * Only `f` is timed, so per-run preparation does not distort the result.
+    */
+  template <typename S, typename F> static double measure(S&& setup, F&& f, size_t reps)
+  {
+    double best = -1;
+    for (size_t i = 0; i < reps; i++)
+    {
+      setup();
+      double sec = measure(f, 1);
+
+      if (best < 0 || sec < best)
+        best = sec;
+    }
+    return best;
+  }
+
+  /**
+    * Print a single result line
+    *
+    * @param items Amount of items processed in `seconds`, used to print items per second
+    * @param bytes Amount of bytes processed in `seconds`, used to print throughput; omitted if 0
+    */
+  static void report(const char * name, double seconds, size_t items, size_t bytes = 0)
+  {
+    printf("%-48s %10.3f ms %12.2f Mitems/s", name, seconds * 1e3, (double)items / seconds / 1e6);
+    if (bytes > 0)
+      printf(" %8.2f GB/s", (double)bytes / seconds / 1e9);
+    printf("\n");
+  }
+
+  /**
+    * Keep the compiler from optimizing away the computation of `val`
+    */
+  template <typename T> static void doNotOptimize(const T& val)
+  {
+#if defined(_MSC_VER)
+    static const volatile void * sink;
+    sink = &val;
+#else
+    __asm__ __volatile__("" : : "g"(&val) : "memory");
+#endif
+  }
+};
+} // namespace CppUtil
@@ -0,0 +1,133 @@
+#include "Benchmark.hpp"
+#include "Cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace CppUtil;
+
+static constexpr size_t KeySpace = 1'000'000;
+static constexpr size_t Accesses = 5'000'000;
+
+// Keys drawn from a Zipf distribution with exponent `s` by inverting its CDF
+static std::vector<uint64_t> zipfTrace(double s, uint32_t seed)
+{
+  std::vector<double> cdf(KeySpace);
+  double              sum = 0;
+  for (size_t i = 0; i < KeySpace; i++)
+  {
+    sum += 1.0 / std::pow((double)(i + 1), s);
+    cdf[i] = sum;
+  }
+
+  std::mt19937_64                        rng(seed);
+  std::uniform_real_distribution<double> uniform(0, sum);
+  std::vector<uint64_t>                  trace(Accesses);
+  for (auto& key : trace)
+  {
+    size_t rank = (size_t)(std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin());
+    // Scatter ranks so popular keys are not adjacent integers
+    key = rank * 0x9E3779B97F4A7C15ull;
+  }
+  return trace;
+}
+
+// The usual hand written LRU: a list in recency order and a hash map into it
+class ListLRU
+{
+private:
+  size_t                                                                           cap;
+  std::list<std::pair<uint64_t, uint64_t>>                                         order;
+  std::unordered_map<uint64_t, std::list<std::pair<uint64_t, uint64_t>>::iterator> index;
+
+public:
+  ListLRU(size_t cap) : cap(cap) {}
+
+  uint64_t * get(uint64_t key)
+  {
+    auto it = this->index.find(key);
+    if (it == this->index.end())
+      return nullptr;
+    this->order.splice(this->order.begin(), this->order, it->second);
+    return &it->second->second;
+  }
+
+  void put(uint64_t key, uint64_t value)
+  {
+    if (this->order.size() == this->cap)
+    {
+      this->index.erase(this->order.back().first);
+      this->order.pop_back();
+    }
+    this->order.emplace_front(key, value);
+    this->index[key] = this->order.begin();
+  }
+};
+
+template <typename C> static double replay(const std::vector<uint64_t>& trace, C&& cache)
+{
+  return Benchmark::measure(
+    [&]
+    {
+      uint64_t sum = 0;
+      for (uint64_t key : trace)
+      {
+        if (auto * val = cache.get(key))
+          sum += *val;
+        else
+          cache.put(key, key);
+      }
+      Benchmark::doNotOptimize(sum);
+    },
+    1);
+}
+
+int main()
+{
+  for (double s : {0.8, 0.99})
+  {
+    std::vector<uint64_t> trace = zipfTrace(s, 1);
+
+    for (size_t cap : {KeySpace / 100, KeySpace / 10})
+    {
+      std::string suffix = ", zipf " + std::to_string(s).substr(0, 4) + ", cap " + std::to_string(cap);
+
+      ListLRU                   list(cap);
+      Cache<uint64_t, uint64_t> lru(cap, CachePolicy::LRU);
+      Cache<uint64_t, uint64_t> lfu(cap, CachePolicy::TinyLFU);
+      double                    listTime = replay(trace, list);
+      double                    lruTime  = replay(trace, lru);
+      double                    lfuTime  = replay(trace, lfu);
+
+      ShardedCache<uint64_t, uint64_t> sharded(cap, CachePolicy::TinyLFU);
+      double                           shardedTime = Benchmark::measure(
+        [&]
+        {
+          uint64_t sum = 0, val = 0;
+          for (uint64_t key : trace)
+          {
+            if (sharded.get(key, val))
+              sum += val;
+            else
+              sharded.put(key, key);
+          }
+          Benchmark::doNotOptimize(sum);
+        },
+        1);
+
+      Benchmark::report(("std::list + unordered_map LRU" + suffix).c_str(), listTime, Accesses);
+      Benchmark::report(("Cache LRU" + suffix).c_str(), lruTime, Accesses);
+      Benchmark::report(("Cache TinyLFU" + suffix).c_str(), lfuTime, Accesses);
+      Benchmark::report(("ShardedCache TinyLFU" + suffix).c_str(), shardedTime, Accesses);
+      printf("  hit rate: LRU %.1f%%, TinyLFU %.1f%%, sharded TinyLFU %.1f%%; speedup vs list LRU: %.1fx\n\n",
+             100 * lru.getStats().hitRate(), 100 * lfu.getStats().hitRate(), 100 * sharded.getStats().hitRate(),
+             listTime / lruTime);
+    }
+  }
+  return 0;
+}
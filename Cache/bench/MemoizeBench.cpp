@@ -0,0 +1,68 @@
+#include "Benchmark.hpp"
+#include "Memoize.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CppUtil;
+
+static constexpr size_t Bursts       = 20;
+static constexpr size_t BurstSize    = 256;
+static constexpr size_t DistinctKeys = 8;
+
+static std::atomic<size_t> invocations{0};
+
+// Stand-in for a remote lookup: 1 ms of latency per call
+static int lookup(int key)
+{
+  invocations++;
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  return key * 2;
+}
+
+// Bursts of concurrent requests where many ask for the same few keys, each burst for new keys
+template <typename F> static double replay(F&& request)
+{
+  return Benchmark::measure(
+    [&]
+    {
+      int sum = 0;
+      for (size_t b = 0; b < Bursts; b++)
+      {
+        std::vector<Promise<int>> promises;
+        promises.reserve(BurstSize);
+        for (size_t i = 0; i < BurstSize; i++)
+        {
+          promises.push_back(request((int)(b * DistinctKeys + i % DistinctKeys)));
+        }
+        for (auto& p : promises)
+        {
+          sum += p.get();
+        }
+      }
+      Benchmark::doNotOptimize(sum);
+    },
+    1);
+}
+
+int main()
+{
+  ThreadPool pool(8);
+
+  invocations       = 0;
+  double plainTime  = replay([&](int key) { return Async::async<int>(pool, lookup, key); });
+  size_t plainCalls = invocations;
+
+  auto memo        = memoizeAsync(pool, lookup);
+  invocations      = 0;
+  double memoTime  = replay([&](int key) { return memo(key); });
+  size_t memoCalls = invocations;
+
+  Benchmark::report("Async::async on pool", plainTime, Bursts * BurstSize);
+  Benchmark::report("memoizeAsync on pool", memoTime, Bursts * BurstSize);
+  printf("  invocations: %zu plain, %zu memoized; speedup: %.1fx\n", plainCalls, memoCalls, plainTime / memoTime);
+  return 0;
+}
@@ -0,0 +1,649 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Array.hpp"
+#include "Hash.hpp"
+#include "Map.hpp"
+
+namespace CppUtil
+{
+enum class CachePolicy
+{
+  /** Evict the least recently used entry */
+  LRU,
+  /** LRU eviction, but new keys are only admitted if they were requested more often than the entry they evict */
+  TinyLFU
+};
+
+struct CacheStats
+{
+  size_t hits       = 0;
+  size_t misses     = 0;
+  size_t evictions  = 0;
+  size_t rejections = 0;
+
+  double hitRate() const
+  {
+    return hits + misses == 0 ? 0 : (double)hits / (double)(hits + misses);
+  }
+
+  CacheStats& operator+=(const CacheStats& other)
+  {
+    this->hits += other.hits;
+    this->misses += other.misses;
+    this->evictions += other.evictions;
+    this->rejections += other.rejections;
+    return *this;
+  }
+};
+
+/**
+  * Approximate access counts of keys, as count-min sketch of 4 bit counters
+  *
+  * Each key increments one counter in each of four rows, and its estimate is the smallest of them. When the amount
+  * of increments reaches ten times the capacity all counters are halved, so old popularity fades.
+  */
+class FrequencySketch
+{
+private:
+  Array<uint64_t> table;
+  size_t          mask;
+  size_t          additions = 0;
+  size_t          sampleSize;
+
+  template <typename func> void foreachCounter(uint64_t hash, func&& f) const
+  {
+    uint64_t step = (hash >> 32) | 1;
+    for (uint64_t i = 0; i < 4; i++)
+    {
+      uint64_t x = hash + i * step;
+      f((size_t)((x >> 4) & this->mask), (unsigned)(x & 15) * 4);
+    }
+  }
+
+public:
+  FrequencySketch(size_t cap = 16)
+  {
+    size_t words = 16;
+    while (words < cap)
+    {
+      words *= 2;
+    }
+    this->table      = Array<uint64_t>(words);
+    this->mask       = words - 1;
+    this->sampleSize = 10 * (cap < 16 ? 16 : cap);
+  }
+
+  void record(uint64_t hash)
+  {
+    uint64_t * t     = this->table;
+    bool       added = false;
+    this->foreachCounter(hash,
+                         [&](size_t word, unsigned shift)
+                         {
+                           if (((t[word] >> shift) & 15) < 15)
+                           {
+                             t[word] += (uint64_t)1 << shift;
+                             added = true;
+                           }
+                         });
+
+    if (added && ++this->additions >= this->sampleSize)
+      this->age();
+  }
+
+  unsigned estimate(uint64_t hash) const
+  {
+    const uint64_t * t   = this->table;
+    unsigned         res = 15;
+    this->foreachCounter(hash,
+                         [&](size_t word, unsigned shift)
+                         {
+                           unsigned c = (unsigned)((t[word] >> shift) & 15);
+                           res        = c < res ? c : res;
+                         });
+    return res;
+  }
+
+  /**
+    * Halve all counters
+    */
+  void age()
+  {
+    uint64_t * t = this->table;
+    for (size_t i = 0; i < this->table.getSize(); i++)
+    {
+      t[i] = (t[i] >> 1) & 0x7777777777777777ull;
+    }
+    this->additions /= 2;
+  }
+};
+
+template <typename K, typename V> class ShardedCache;
+
+/**
+  * Bounded key-value cache with O(1) `get` and `put`
+  *
+  * Entries are kept in preallocated columns and linked into a recency list by index, with an open addressing table
+  * mapping keys to entries. The cache is bounded by its capacity in entries and optionally by a memory budget, which
+  * limits the sum of the entry costs passed to `put`. Not thread safe, see `ShardedCache`.
+  */
+template <typename K, typename V> class Cache
+{
+  template <typename, typename> friend class ShardedCache;
+
+private:
+  static constexpr uint32_t Nil = UINT32_MAX;
+
+  Array<K>        keys;
+  Array<V>        values;
+  Array<uint64_t> hashes;
+  Array<size_t>   costs;
+  Array<uint32_t> prev;
+  Array<uint32_t> next;
+  Array<uint32_t> slots; // Index of the entry + 1, 0 for empty slots
+  unsigned        shift;
+
+  uint32_t head     = Nil; // Most recently used
+  uint32_t tail     = Nil; // Least recently used
+  uint32_t freeHead = Nil;
+  size_t   count    = 0;
+  size_t   cap;
+  size_t   budget;
+  size_t   used = 0;
+
+  CachePolicy     policy;
+  FrequencySketch sketch;
+  CacheStats      stats;
+
+  // Hash of the last missed `get`, whose access the following `put` of the same key must not record again
+  uint64_t missedHash = 0;
+  bool     missed     = false;
+
+  size_t slotOf(uint64_t hash) const
+  {
+    return (size_t)((hash * 0x9E3779B97F4A7C15ull) >> this->shift);
+  }
+
+  uint32_t findEntry(const K& key, uint64_t hash) const
+  {
+    const uint32_t * s    = this->slots;
+    const uint64_t * h    = this->hashes;
+    const K *        k    = this->keys;
+    size_t           mask = this->slots.getSize() - 1;
+    for (size_t pos = this->slotOf(hash);; pos = (pos + 1) & mask)
+    {
+      uint32_t entry = s[pos];
+      if (entry == 0)
+        return Nil;
+      if (h[entry - 1] == hash && key == k[entry - 1])
+        return entry - 1;
+    }
+  }
+
+  void linkSlot(uint32_t idx)
+  {
+    uint32_t * s    = this->slots;
+    size_t     mask = this->slots.getSize() - 1;
+    size_t     pos  = this->slotOf(((const uint64_t *)this->hashes)[idx]);
+    while (s[pos] != 0)
+    {
+      pos = (pos + 1) & mask;
+    }
+    s[pos] = idx + 1;
+  }
+
+  // Linear probing deletion without tombstones: following entries are shifted back into the hole if that does not
+  // move them before their home slot
+  void unlinkSlot(uint32_t idx)
+  {
+    uint32_t *       s    = this->slots;
+    const uint64_t * h    = this->hashes;
+    size_t           mask = this->slots.getSize() - 1;
+    size_t           hole = this->slotOf(h[idx]);
+    while (s[hole] != idx + 1)
+    {
+      hole = (hole + 1) & mask;
+    }
+
+    for (size_t pos = (hole + 1) & mask; s[pos] != 0; pos = (pos + 1) & mask)
+    {
+      size_t home = this->slotOf(h[s[pos] - 1]);
+      if (((pos - home) & mask) >= ((pos - hole) & mask))
+      {
+        s[hole] = s[pos];
+        hole    = pos;
+      }
+    }
+    s[hole] = 0;
+  }
+
+  void unlinkList(uint32_t idx)
+  {
+    uint32_t * p = this->prev;
+    uint32_t * n = this->next;
+    if (p[idx] != Nil)
+      n[p[idx]] = n[idx];
+    else
+      this->head = n[idx];
+    if (n[idx] != Nil)
+      p[n[idx]] = p[idx];
+    else
+      this->tail = p[idx];
+  }
+
+  void pushFront(uint32_t idx)
+  {
+    uint32_t * p = this->prev;
+    uint32_t * n = this->next;
+    p[idx]       = Nil;
+    n[idx]       = this->head;
+    if (this->head != Nil)
+      p[this->head] = idx;
+    else
+      this->tail = idx;
+    this->head = idx;
+  }
+
+  void moveToFront(uint32_t idx)
+  {
+    if (this->head == idx)
+      return;
+    this->unlinkList(idx);
+    this->pushFront(idx);
+  }
+
+  void release(uint32_t idx)
+  {
+    this->unlinkSlot(idx);
+    this->unlinkList(idx);
+    this->used -= ((size_t *)this->costs)[idx];
+    this->count--;
+
+    // Default construct the slot so resources held by key and value are released right away
+    ((K *)this->keys)[idx]        = K();
+    ((V *)this->values)[idx]      = V();
+    ((uint32_t *)this->next)[idx] = this->freeHead;
+    this->freeHead                = idx;
+  }
+
+  bool isFull(size_t cost) const
+  {
+    return this->count == this->cap || (this->budget != 0 && this->used + cost > this->budget);
+  }
+
+  V * get(const K& key, uint64_t hash)
+  {
+    if (this->policy == CachePolicy::TinyLFU)
+      this->sketch.record(hash);
+
+    uint32_t idx = this->findEntry(key, hash);
+    if (idx == Nil)
+    {
+      this->stats.misses++;
+      this->missedHash = hash;
+      this->missed     = true;
+      return nullptr;
+    }
+
+    this->stats.hits++;
+    this->moveToFront(idx);
+    return (V *)this->values + idx;
+  }
+
+  bool put(K&& key, V&& value, size_t cost, uint64_t hash)
+  {
+    if (cost == 0)
+      cost = EntrySize;
+
+    // A miss followed by filling it in is a single access
+    bool recorded = this->missed && this->missedHash == hash;
+    this->missed  = false;
+
+    uint32_t idx = this->findEntry(key, hash);
+    if (this->budget != 0 && cost > this->budget)
+    {
+      // Never store entries exceeding the whole budget, and do not keep a stale value either
+      if (idx != Nil)
+        this->release(idx);
+      this->stats.rejections++;
+      return false;
+    }
+
+    if (idx != Nil)
+    {
+      size_t& old              = ((size_t *)this->costs)[idx];
+      this->used               = this->used - old + cost;
+      old                      = cost;
+      ((V *)this->values)[idx] = std::move(value);
+      this->moveToFront(idx);
+
+      while (this->budget != 0 && this->used > this->budget && this->tail != idx)
+      {
+        this->release(this->tail);
+        this->stats.evictions++;
+      }
+      return true;
+    }
+
+    if (this->policy == CachePolicy::TinyLFU && !recorded)
+      this->sketch.record(hash);
+
+    if (this->isFull(cost))
+    {
+      if (this->policy == CachePolicy::TinyLFU &&
+          this->sketch.estimate(hash) <= this->sketch.estimate(((const uint64_t *)this->hashes)[this->tail]))
+      {
+        this->stats.rejections++;
+        return false;
+      }
+
+      do
+      {
+        this->release(this->tail);
+        this->stats.evictions++;
+      } while (this->isFull(cost));
+    }
+
+    idx            = this->freeHead;
+    this->freeHead = ((const uint32_t *)this->next)[idx];
+
+    ((K *)this->keys)[idx]          = std::move(key);
+    ((V *)this->values)[idx]        = std::move(value);
+    ((uint64_t *)this->hashes)[idx] = hash;
+    ((size_t *)this->costs)[idx]    = cost;
+    this->linkSlot(idx);
+    this->pushFront(idx);
+    this->used += cost;
+    this->count++;
+    return true;
+  }
+
+  bool remove(const K& key, uint64_t hash)
+  {
+    uint32_t idx = this->findEntry(key, hash);
+    if (idx == Nil)
+      return false;
+    this->release(idx);
+    return true;
+  }
+
+public:
+  /**
+    * Cost of an entry if none is given to `put`: its fixed memory footprint in this cache
+    */
+  static constexpr size_t EntrySize =
+    sizeof(K) + sizeof(V) + sizeof(uint64_t) + sizeof(size_t) + 2 * sizeof(uint32_t) + 2 * sizeof(uint32_t);
+
+  /**
+    * @param capacity Maximum amount of entries
+    * @param memoryBudget Maximum sum of entry costs, or 0 to only limit the amount of entries
+    * @throws `length_error` for invalid capacities
+    */
+  Cache(size_t capacity, CachePolicy policy = CachePolicy::LRU, size_t memoryBudget = 0) :
+      cap(capacity), budget(memoryBudget), policy(policy), sketch(policy == CachePolicy::TinyLFU ? capacity : 0)
+  {
+    if (capacity == 0 || capacity >= Nil || capacity > ARRAY_MAX_SIZE / 2)
+    {
+      throw std::length_error("Capacity " + std::to_string(capacity) + " is not a valid cache capacity!");
+    }
+
+    unsigned bits = 1;
+    while (((size_t)1 << bits) < 2 * capacity)
+    {
+      bits++;
+    }
+
+    this->keys   = Array<K>(capacity);
+    this->values = Array<V>(capacity);
+    this->hashes = Array<uint64_t>(capacity);
+    this->costs  = Array<size_t>(capacity);
+    this->prev   = Array<uint32_t>(capacity);
+    this->next   = Array<uint32_t>(capacity);
+    this->slots  = Array<uint32_t>((size_t)1 << bits);
+    this->shift  = 64 - bits;
+
+    this->clear();
+  }
+
+  /**
+    * Value cached for `key`, or `nullptr` on a miss
+    *
+    * A hit makes the entry the most recently used. The pointer is invalidated by the next `put` or `remove`.
+    */
+  V * get(const K& key)
+  {
+    return this->get(key, MapKey::hash(key));
+  }
+
+  /**
+    * Whether `key` is cached, without counting as access
+    */
+  bool contains(const K& key) const
+  {
+    return this->findEntry(key, MapKey::hash(key)) != Nil;
+  }
+
+  /**
+    * Insert or update the entry of `key`, evicting the least recently used entries while the cache is full
+    *
+    * With `CachePolicy::TinyLFU` a new key that was requested less often than the entry it would evict is rejected.
+    * Entries costing more than the memory budget are rejected as well.
+    *
+    * @param cost Amount of memory charged against the budget, `EntrySize` if 0
+    * @return Whether the entry was stored
+    */
+  bool put(K key, V value, size_t cost = 0)
+  {
+    uint64_t hash = MapKey::hash(key);
+    return this->put(std::move(key), std::move(value), cost, hash);
+  }
+
+  /**
+    * Remove the entry of `key`
+    *
+    * @return Whether the key was cached
+    */
+  bool remove(const K& key)
+  {
+    return this->remove(key, MapKey::hash(key));
+  }
+
+  /**
+    * Remove all entries, keeping statistics and access frequencies
+    */
+  void clear()
+  {
+    for (size_t i = 0; i < this->cap; i++)
+    {
+      ((K *)this->keys)[i]        = K();
+      ((V *)this->values)[i]      = V();
+      ((uint32_t *)this->next)[i] = i + 1 < this->cap ? (uint32_t)(i + 1) : Nil;
+    }
+    this->slots    = Array<uint32_t>(this->slots.getSize());
+    this->head     = Nil;
+    this->tail     = Nil;
+    this->freeHead = 0;
+    this->count    = 0;
+    this->used     = 0;
+  }
+
+  size_t getCount() const
+  {
+    return this->count;
+  }
+
+  size_t getCap() const
+  {
+    return this->cap;
+  }
+
+  /**
+    * Sum of the costs of all entries
+    */
+  size_t getMemoryUsage() const
+  {
+    return this->used;
+  }
+
+  CacheStats getStats() const
+  {
+    return this->stats;
+  }
+
+  void resetStats()
+  {
+    this->stats = CacheStats();
+  }
+
+  /**
+    * Call `f(key, value)` for every entry, from most to least recently used
+    */
+  template <typename func> void foreach (func&& f) const
+  {
+    const K *        k = this->keys;
+    const V *        v = this->values;
+    const uint32_t * n = this->next;
+    for (uint32_t idx = this->head; idx != Nil; idx = n[idx])
+    {
+      f(k[idx], v[idx]);
+    }
+  }
+};
+
+/**
+  * Thread safe `Cache` split into independently locked shards
+  *
+  * Keys are assigned to shards by hash, each shard holding an equal part of the capacity and memory budget. Values
+  * are copied out on `get`, since a pointer into a shard could be invalidated by other threads.
+  */
+template <typename K, typename V> class ShardedCache
+{
+private:
+  struct Shard
+  {
+    std::mutex  mtx;
+    Cache<K, V> cache = Cache<K, V>(1);
+  };
+
+  std::unique_ptr<Shard[]> shards;
+  size_t                   shardCount = 1;
+
+  Shard& shardOf(uint64_t hash) const
+  {
+    return this->shards[(hash >> 32) & (this->shardCount - 1)];
+  }
+
+public:
+  /**
+    * The capacity and memory budget are split over the shards, so their sums match the configured limits.
+    *
+    * @param shardCount Amount of shards, rounded up to a power of two but at most `capacity` (and `memoryBudget`)
+    * @throws `length_error` for invalid capacities
+    */
+  ShardedCache(size_t capacity, CachePolicy policy = CachePolicy::LRU, size_t memoryBudget = 0, size_t shardCount = 16)
+  {
+    // Every shard needs at least one entry and, if limited, one unit of the budget
+    size_t limit = (memoryBudget == 0) ? capacity : std::min(capacity, memoryBudget);
+    while (this->shardCount < shardCount && this->shardCount * 2 <= limit)
+    {
+      this->shardCount *= 2;
+    }
+
+    this->shards = std::make_unique<Shard[]>(this->shardCount);
+    for (size_t i = 0; i < this->shardCount; i++)
+    {
+      size_t shardCap    = capacity / this->shardCount + (i < capacity % this->shardCount ? 1 : 0);
+      size_t shardBudget = memoryBudget / this->shardCount + (i < memoryBudget % this->shardCount ? 1 : 0);
+      this->shards[i].cache = Cache<K, V>(shardCap, policy, shardBudget);
+    }
+  }
+
+  /**
+    * Copy the value cached for `key` to `out`
+    *
+    * @return Whether `key` was cached
+    */
+  bool get(const K& key, V& out)
+  {
+    uint64_t hash  = MapKey::hash(key);
+    Shard&   shard = this->shardOf(hash);
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    V *                         res = shard.cache.get(key, hash);
+    if (res == nullptr)
+      return false;
+    out = *res;
+    return true;
+  }
+
+  /**
+    * @see Cache::put
+    */
+  bool put(K key, V value, size_t cost = 0)
+  {
+    uint64_t hash  = MapKey::hash(key);
+    Shard&   shard = this->shardOf(hash);
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    return shard.cache.put(std::move(key), std::move(value), cost, hash);
+  }
+
+  bool remove(const K& key)
+  {
+    uint64_t hash  = MapKey::hash(key);
+    Shard&   shard = this->shardOf(hash);
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    return shard.cache.remove(key, hash);
+  }
+
+  size_t getCount() const
+  {
+    size_t res = 0;
+    for (size_t i = 0; i < this->shardCount; i++)
+    {
+      std::lock_guard<std::mutex> lock(this->shards[i].mtx);
+      res += this->shards[i].cache.getCount();
+    }
+    return res;
+  }
+
+  size_t getMemoryUsage() const
+  {
+    size_t res = 0;
+    for (size_t i = 0; i < this->shardCount; i++)
+    {
+      std::lock_guard<std::mutex> lock(this->shards[i].mtx);
+      res += this->shards[i].cache.getMemoryUsage();
+    }
+    return res;
+  }
+
+  /**
+    * Statistics summed over all shards
+    */
+  CacheStats getStats() const
+  {
+    CacheStats res;
+    for (size_t i = 0; i < this->shardCount; i++)
+    {
+      std::lock_guard<std::mutex> lock(this->shards[i].mtx);
+      res += this->shards[i].cache.getStats();
+    }
+    return res;
+  }
+
+  size_t getShardCount() const
+  {
+    return this->shardCount;
+  }
+};
+} // namespace CppUtil
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Async.hpp"
+#include "Cache.hpp"
+#include "Hash.hpp"
+
+namespace CppUtil
+{
+template <typename Sig> class AsyncMemo;
+
+/**
+  * Async function whose calls are shared between callers with equal arguments
+  *
+  * The first call with some arguments starts the function, and every later call with equal arguments returns a
+  * `Promise` of that same computation while it is running and after it finished. Calls that threw are forgotten,
+  * so the next call retries. The amount of remembered results is limited, evicting the least recently used, and
+  * results may expire after a time to live.
+  *
+  * Arguments are compared with `operator==` and hashed with `Hasher`. Copies of an `AsyncMemo` share their results.
+  */
+template <typename T, typename... Args> class AsyncMemo<T(Args...)>
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  using Key   = std::tuple<std::decay_t<Args>...>;
+
+private:
+  struct Entry
+  {
+    Key                       key;
+    std::optional<Promise<T>> promise;
+    Clock::time_point         created;
+    uint64_t                  id = 0;
+
+    bool operator!=(const Entry& other) const
+    {
+      return this->id != other.id;
+    }
+  };
+
+  struct State
+  {
+    std::mutex                mtx;
+    Cache<uint64_t, Entry>    entries;
+    std::function<T(Args...)> f;
+    ThreadPool *              pool;
+    Clock::duration           ttl;
+    uint64_t                  nextId = 0;
+    CacheStats                stats;
+
+    State(std::function<T(Args...)> f, ThreadPool * pool, size_t maxEntries, Clock::duration ttl) :
+        entries(maxEntries), f(std::move(f)), pool(pool), ttl(ttl)
+    {
+    }
+
+    // Forget the computation `id` if it is still the remembered one for `hash`
+    void forget(uint64_t hash, uint64_t id)
+    {
+      std::lock_guard<std::mutex> lock(this->mtx);
+      Entry *                     e = this->entries.get(hash);
+      if (e != nullptr && e->id == id)
+        this->entries.remove(hash);
+    }
+  };
+
+  std::shared_ptr<State> state;
+
+public:
+  /**
+    * @param pool Pool to run the computations on, or `nullptr` to run each one on a new thread like `Async::async`
+    * @param maxEntries Maximum amount of remembered computations
+    * @param ttl Time after which a computation is started again, or 0 to remember results until evicted
+    * @throws `length_error` if `maxEntries` is 0
+    */
+  AsyncMemo(std::function<T(Args...)> f, ThreadPool * pool = nullptr, size_t maxEntries = 1'024,
+            Clock::duration ttl = Clock::duration::zero()) :
+      state(std::make_shared<State>(std::move(f), pool, maxEntries, ttl))
+  {
+  }
+
+  /**
+    * `Promise` of the computation for `a`, starting it unless a remembered one exists
+    */
+  template <typename... A> Promise<T> operator()(A&&... a)
+  {
+    static_assert(std::is_constructible_v<Key, A&&...>, "Arguments do not match the memoized function!");
+
+    Key      key(std::forward<A>(a)...);
+    uint64_t hash = std::apply([](const auto&... x) { return hashValues(x...); }, key);
+    auto     now  = Clock::now();
+
+    State&                      s = *this->state;
+    std::lock_guard<std::mutex> lock(s.mtx);
+
+    Entry * e = s.entries.get(hash);
+    if (e != nullptr && e->key == key && (s.ttl == Clock::duration::zero() || now - e->created < s.ttl))
+    {
+      s.stats.hits++;
+      return *e->promise;
+    }
+    s.stats.misses++;
+
+    uint64_t id  = ++s.nextId;
+    auto     run = [state = this->state, key, hash, id]() -> T
+    {
+      try
+      {
+        return std::apply(state->f, key);
+      }
+      catch (...)
+      {
+        state->forget(hash, id);
+        throw;
+      }
+    };
+
+    Promise<T> res = s.pool ? Async::async<T>(*s.pool, std::move(run)) : Async::async<T>(std::move(run));
+    s.entries.put(hash, Entry{std::move(key), res, now, id});
+    return res;
+  }
+
+  /**
+    * Forget all remembered computations
+    */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(this->state->mtx);
+    this->state->entries.clear();
+  }
+
+  /**
+    * Amount of remembered computations
+    */
+  size_t getCount() const
+  {
+    std::lock_guard<std::mutex> lock(this->state->mtx);
+    return this->state->entries.getCount();
+  }
+
+  /**
+    * Calls that joined a remembered computation (`hits`) and calls that started a new one (`misses`)
+    */
+  CacheStats getStats() const
+  {
+    std::lock_guard<std::mutex> lock(this->state->mtx);
+    CacheStats                  res = this->state->stats;
+    res.evictions                   = this->state->entries.getStats().evictions;
+    return res;
+  }
+};
+
+/**
+  * Memoize the async function `f`
+  *
+  * @see AsyncMemo
+  */
+template <typename T, typename... Args>
+AsyncMemo<T(Args...)>
+memoizeAsync(T (*f)(Args...), size_t maxEntries = 1'024,
+             std::chrono::steady_clock::duration ttl = std::chrono::steady_clock::duration::zero())
+{
+  return AsyncMemo<T(Args...)>(f, nullptr, maxEntries, ttl);
+}
+
+/**
+  * Memoize the async function `f`, running computations on `pool`
+  *
+  * @see AsyncMemo
+  */
+template <typename T, typename... Args>
+AsyncMemo<T(Args...)>
+memoizeAsync(ThreadPool& pool, T (*f)(Args...), size_t maxEntries = 1'024,
+             std::chrono::steady_clock::duration ttl = std::chrono::steady_clock::duration::zero())
+{
+  return AsyncMemo<T(Args...)>(f, &pool, maxEntries, ttl);
+}
+
+/**
+  * Memoize the callable `f` with signature `Sig`, e.g. `memoizeAsync<int(std::string)>(lambda)`
+  *
+  * @see AsyncMemo
+  */
+template <typename Sig, typename F>
+AsyncMemo<Sig> memoizeAsync(F&& f, size_t maxEntries = 1'024,
+                            std::chrono::steady_clock::duration ttl = std::chrono::steady_clock::duration::zero())
+{
+  return AsyncMemo<Sig>(std::forward<F>(f), nullptr, maxEntries, ttl);
+}
+
+template <typename Sig, typename F>
+AsyncMemo<Sig> memoizeAsync(ThreadPool& pool, F&& f, size_t maxEntries = 1'024,
+                            std::chrono::steady_clock::duration ttl = std::chrono::steady_clock::duration::zero())
+{
+  return AsyncMemo<Sig>(std::forward<F>(f), &pool, maxEntries, ttl);
+}
+
+// Declare and define an async function like `__async__`, whose calls with equal arguments share one computation.
+// Remembers up to 1024 results; use `memoizeAsync` for other limits or a time to live.
+// Only works outside classes.
+#define __async_cached__(ret_type, func_name, ...)                                                                     \
+  ret_type __async__##func_name(__VA_ARGS__);                                                                          \
+                                                                                                                       \
+  inline auto& __async_memo__##func_name()                                                                             \
+  {                                                                                                                    \
+    static auto memo = CppUtil::memoizeAsync(__async__##func_name);                                                    \
+    return memo;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  template <typename... Args> CppUtil::Promise<ret_type> func_name(Args&&... a)                                        \
+  {                                                                                                                    \
+    static_assert(std::is_invocable_r_v<ret_type, decltype(__async__##func_name), Args...>,                            \
+                  "Function " #func_name " has signature " #ret_type "(" #__VA_ARGS__ ")");                            \
+    return __async_memo__##func_name()(a...);                                                                          \
+  }                                                                                                                    \
+                                                                                                                       \
+  ret_type __async__##func_name(__VA_ARGS__)
+} // namespace CppUtil
@@ -0,0 +1,298 @@
+#include "Cache.hpp"
+#include "String.hpp"
+
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("Cache Init", "[cache][init]")
+{
+  REQUIRE(3 == Cache<int, int>(3).getCap());
+  REQUIRE_THROWS_AS((Cache<int, int>(0)), std::length_error);
+}
+
+TEST_CASE("LRU Cache", "[cache][lru]")
+{
+  Cache<String, int> cache(3);
+
+  cache.put("a", 1);
+  cache.put("b", 2);
+  cache.put("c", 3);
+
+  SECTION("The least recently used entry is evicted")
+  {
+    REQUIRE(*cache.get("a") == 1);
+    cache.put("d", 4);
+
+    REQUIRE(cache.contains("a"));
+    REQUIRE_FALSE(cache.contains("b"));
+    REQUIRE(cache.get("b") == nullptr);
+    REQUIRE(3 == cache.getCount());
+
+    CacheStats stats = cache.getStats();
+    REQUIRE(1 == stats.hits);
+    REQUIRE(1 == stats.misses);
+    REQUIRE(1 == stats.evictions);
+    REQUIRE(0.5 == stats.hitRate());
+
+    String order;
+    cache.foreach ([&](const String& key, int) { order = order + key; });
+    REQUIRE(order == "dac");
+  }
+
+  SECTION("Updating keeps a single entry")
+  {
+    REQUIRE(cache.put("a", 10));
+    REQUIRE(3 == cache.getCount());
+    REQUIRE(*cache.get("a") == 10);
+    REQUIRE(0 == cache.getStats().evictions);
+  }
+
+  SECTION("Entries can be removed")
+  {
+    REQUIRE(cache.remove("b"));
+    REQUIRE_FALSE(cache.remove("b"));
+    cache.put("d", 4);
+    REQUIRE(cache.contains("a"));
+    REQUIRE(3 == cache.getCount());
+
+    cache.clear();
+    REQUIRE(0 == cache.getCount());
+    REQUIRE(cache.get("a") == nullptr);
+  }
+}
+
+TEST_CASE("Cache memory budget", "[cache][budget]")
+{
+  Cache<int, std::string> cache(100, CachePolicy::LRU, 1'000);
+
+  for (int i = 0; i < 10; i++)
+  {
+    cache.put(i, std::string(200, 'x'), 200);
+  }
+
+  REQUIRE(5 == cache.getCount());
+  REQUIRE(1'000 == cache.getMemoryUsage());
+  REQUIRE(cache.contains(9));
+  REQUIRE_FALSE(cache.contains(4));
+
+  // Growing an entry evicts others, entries larger than the budget are rejected
+  REQUIRE(cache.put(9, std::string(600, 'x'), 600));
+  REQUIRE(3 == cache.getCount());
+  REQUIRE_FALSE(cache.put(1, "", 2'000));
+  REQUIRE_FALSE(cache.put(9, "", 2'000));
+  REQUIRE_FALSE(cache.contains(9));
+  REQUIRE(2 == cache.getStats().rejections);
+
+  Cache<int, int> sized(100, CachePolicy::LRU, 10 * Cache<int, int>::EntrySize);
+  for (int i = 0; i < 20; i++)
+  {
+    sized.put(i, i);
+  }
+  REQUIRE(10 == sized.getCount());
+}
+
+TEST_CASE("TinyLFU Cache", "[cache][tinylfu]")
+{
+  auto access = [](Cache<int, int>& cache, int key)
+  {
+    if (cache.get(key) == nullptr)
+      cache.put(key, key);
+  };
+
+  // A scan of keys requested once, interleaved with requests of a small hot set
+  auto run = [&](Cache<int, int>& cache)
+  {
+    for (int i = 0; i < 10; i++)
+    {
+      access(cache, i);
+    }
+    for (int i = 0; i < 1'000; i++)
+    {
+      access(cache, 100 + i);
+      access(cache, i % 10);
+    }
+  };
+
+  Cache<int, int> lfu(10, CachePolicy::TinyLFU);
+  Cache<int, int> lru(10, CachePolicy::LRU);
+  run(lfu);
+  run(lru);
+
+  // LRU lets the scan flush the hot set, TinyLFU rejects the scanned keys
+  REQUIRE(lfu.getStats().hitRate() > 0.4);
+  REQUIRE(lru.getStats().hitRate() < 0.05);
+  REQUIRE(lfu.getStats().rejections > 900);
+  for (int i = 0; i < 10; i++)
+  {
+    REQUIRE(lfu.contains(i));
+  }
+
+  // A key that becomes popular is admitted eventually
+  for (int round = 0; round < 10 && !lfu.contains(5'000); round++)
+  {
+    access(lfu, 5'000);
+  }
+  REQUIRE(lfu.contains(5'000));
+}
+
+TEST_CASE("TinyLFU counts a miss and its put as one access", "[cache][tinylfu]")
+{
+  Cache<int, int> cache(1, CachePolicy::TinyLFU);
+  REQUIRE(cache.put(1, 1));
+
+  // Both keys were accessed once, so the cold key must not displace the victim
+  REQUIRE(cache.get(2) == nullptr);
+  REQUIRE_FALSE(cache.put(2, 2));
+  REQUIRE(cache.contains(1));
+
+  // A put without a preceding miss still counts
+  REQUIRE(cache.put(2, 2));
+  REQUIRE(cache.contains(2));
+}
+
+TEST_CASE("LRU Cache behaves like a reference implementation", "[cache][random]")
+{
+  const size_t                                     cap = 64;
+  Cache<int, int>                                  cache(cap);
+  std::list<std::pair<int, int>>                   ref;
+  std::unordered_map<int, decltype(ref)::iterator> pos;
+  std::mt19937                                     rng(9);
+
+  for (int i = 0; i < 200'000; i++)
+  {
+    int key = (int)(rng() % 200);
+    switch (rng() % 3)
+    {
+      case 0:
+      {
+        int * val = cache.get(key);
+        auto  it  = pos.find(key);
+        REQUIRE((val != nullptr) == (it != pos.end()));
+        if (val != nullptr)
+        {
+          REQUIRE(*val == it->second->second);
+          ref.splice(ref.begin(), ref, it->second);
+        }
+        break;
+      }
+      case 1:
+      {
+        cache.put(key, i);
+        auto it = pos.find(key);
+        if (it != pos.end())
+        {
+          it->second->second = i;
+          ref.splice(ref.begin(), ref, it->second);
+        }
+        else
+        {
+          if (ref.size() == cap)
+          {
+            pos.erase(ref.back().first);
+            ref.pop_back();
+          }
+          ref.emplace_front(key, i);
+          pos[key] = ref.begin();
+        }
+        break;
+      }
+      default:
+        REQUIRE(cache.remove(key) == (pos.count(key) == 1));
+        if (pos.count(key) == 1)
+        {
+          ref.erase(pos[key]);
+          pos.erase(key);
+        }
+        break;
+    }
+  }
+
+  REQUIRE(ref.size() == cache.getCount());
+  auto it = ref.begin();
+  cache.foreach (
+    [&](int key, int value)
+    {
+      REQUIRE(key == it->first);
+      REQUIRE(value == it->second);
+      ++it;
+    });
+}
+
+TEST_CASE("ShardedCache", "[cache][sharded]")
+{
+  ShardedCache<int, int> cache(1'000, CachePolicy::LRU, 0, 8);
+  REQUIRE(8 == cache.getShardCount());
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    threads.emplace_back(
+      [&, t]
+      {
+        std::mt19937 rng(t);
+        for (int i = 0; i < 50'000; i++)
+        {
+          int key = (int)(rng() % 2'000);
+          int val = 0;
+          if (cache.get(key, val))
+            REQUIRE(val == key * 2);
+          else
+            cache.put(key, key * 2);
+          if (i % 100 == 0)
+            cache.remove(key);
+        }
+      });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  CacheStats stats = cache.getStats();
+  REQUIRE(200'000 == stats.hits + stats.misses);
+  REQUIRE(stats.hits > 0);
+  REQUIRE(cache.getCount() <= 1'000);
+  REQUIRE(cache.getMemoryUsage() == cache.getCount() * Cache<int, int>::EntrySize);
+}
+
+TEST_CASE("ShardedCache stays within its limits", "[cache][sharded][limits]")
+{
+  SECTION("The capacity is split over the shards")
+  {
+    ShardedCache<int, int> cache(10);
+    REQUIRE(8 == cache.getShardCount());
+
+    for (int i = 0; i < 1'000; i++)
+    {
+      cache.put(i, i);
+    }
+    REQUIRE(cache.getCount() <= 10);
+  }
+
+  SECTION("The memory budget is split over the shards")
+  {
+    size_t                 budget = 10 * Cache<int, int>::EntrySize;
+    ShardedCache<int, int> cache(1'000, CachePolicy::LRU, budget, 16);
+
+    for (int i = 0; i < 1'000; i++)
+    {
+      cache.put(i, i);
+    }
+    REQUIRE(cache.getMemoryUsage() <= budget);
+  }
+
+  SECTION("There are not more shards than entries")
+  {
+    ShardedCache<int, int> cache(3, CachePolicy::LRU, 0, 16);
+    REQUIRE(2 == cache.getShardCount());
+  }
+}
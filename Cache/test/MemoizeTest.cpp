@@ -0,0 +1,139 @@
+#include "Memoize.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+static std::atomic<int> lookups{0};
+
+__async_cached__(std::string, resolve, std::string host)
+{
+  lookups++;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  return host + " -> 10.0.0.1";
+}
+
+TEST_CASE("Memoized async functions share computations", "[memoize][coalesce]")
+{
+  std::atomic<int>  calls{0};
+  std::atomic<bool> release{false};
+  auto              memo = memoizeAsync<int(int)>(
+    [&](int x)
+    {
+      calls++;
+      while (!release)
+      {
+        std::this_thread::yield();
+      }
+      return x * 2;
+    });
+
+  SECTION("Calls with equal arguments join the running computation")
+  {
+    std::vector<Promise<int>> promises;
+    for (int i = 0; i < 10; i++)
+    {
+      promises.push_back(memo(21));
+    }
+    promises.push_back(memo(1));
+    release = true;
+
+    for (int i = 0; i < 10; i++)
+    {
+      REQUIRE(42 == promises[i].get());
+    }
+    REQUIRE(2 == promises[10].get());
+    REQUIRE(2 == calls);
+
+    // Finished computations are remembered as well
+    REQUIRE(42 == memo(21).get());
+    REQUIRE(2 == calls);
+    REQUIRE(2 == memo.getCount());
+    REQUIRE(9 + 1 == memo.getStats().hits);
+    REQUIRE(2 == memo.getStats().misses);
+  }
+
+  SECTION("Clearing forgets all results")
+  {
+    release = true;
+    memo(1).get();
+    memo.clear();
+    memo(1).get();
+    REQUIRE(2 == calls);
+  }
+}
+
+TEST_CASE("Memoized async functions retry failures", "[memoize][throw]")
+{
+  std::atomic<int> calls{0};
+  ThreadPool       pool(2);
+  auto             memo = memoizeAsync<int(std::string)>(pool,
+                                             [&](const std::string& s)
+                                             {
+                                               if (calls++ == 0)
+                                                 throw std::runtime_error("first call fails");
+                                               return (int)s.size();
+                                             });
+
+  REQUIRE_THROWS_AS(memo("abc").get(), std::runtime_error);
+  REQUIRE(3 == memo("abc").get());
+  REQUIRE(3 == memo(std::string("abc")).get());
+  REQUIRE(2 == calls);
+}
+
+TEST_CASE("Memoized async functions are bounded", "[memoize][limits]")
+{
+  std::atomic<int> calls{0};
+
+  SECTION("Least recently used results are evicted")
+  {
+    auto memo = memoizeAsync<int(int)>([&](int x) { return calls++, x; }, 2);
+    memo(1).get();
+    memo(2).get();
+    memo(1).get();
+    memo(3).get();
+    REQUIRE(3 == calls);
+
+    memo(1).get();
+    REQUIRE(3 == calls);
+    memo(2).get();
+    REQUIRE(4 == calls);
+    REQUIRE(2 == memo.getCount());
+    REQUIRE(memo.getStats().evictions >= 2);
+  }
+
+  SECTION("Results expire after their time to live")
+  {
+    auto memo = memoizeAsync<int(int)>([&](int x) { return calls++, x; }, 16, std::chrono::milliseconds(50));
+    memo(1).get();
+    memo(1).get();
+    REQUIRE(1 == calls);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    memo(1).get();
+    REQUIRE(2 == calls);
+  }
+}
+
+TEST_CASE("__async_cached__ macro", "[memoize][macro]")
+{
+  std::vector<Promise<std::string>> promises;
+  for (int i = 0; i < 5; i++)
+  {
+    promises.push_back(resolve("db.local"));
+  }
+  for (auto& p : promises)
+  {
+    REQUIRE("db.local -> 10.0.0.1" == p.get());
+  }
+
+  REQUIRE("db.local -> 10.0.0.1" == __await__(resolve, "db.local"));
+  REQUIRE(1 == lookups);
+}
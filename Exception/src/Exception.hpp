@@ -9,4 +9,14 @@ struct not_found : public std::logic_error
 {
   not_found(std::string message) : logic_error(message){};
 };
+
+struct cancelled : public std::runtime_error
+{
+  cancelled(std::string message) : runtime_error(message){};
+};
+
+struct timed_out : public std::runtime_error
+{
+  timed_out(std::string message) : runtime_error(message){};
+};
 } // namespace CppUtil
\ No newline at end of file
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace CppUtil
+{
+/**
+  * Controls how a range of elements is written by `Format::join()`
+  *
+  * The defaults reproduce the classic `{1 2 3 }` output of `std::to_string(Array)`.
+  */
+struct FormatOptions
+{
+  const char * prefix    = "{";
+  const char * separator = " ";
+  const char * suffix    = "}";
+
+  // Maximum number of elements to write; everything after is replaced by `truncation`
+  size_t       limit      = SIZE_MAX;
+  const char * truncation = "";
+
+  // Whether the separator is written after the last element as well
+  bool trailingSeparator = true;
+};
+
+/**
+  * Growable character buffer used as a formatting sink
+  *
+  * `clear()` keeps the allocated capacity, so a single buffer can be reused for many dumps.
+  */
+class FormatBuffer
+{
+private:
+  char * buf = nullptr;
+  size_t len = 0;
+  size_t cap = 0;
+
+  void grow(size_t minCap)
+  {
+    size_t newCap = (this->cap * 2 > minCap) ? this->cap * 2 : minCap;
+
+    char * tmp = new char[newCap];
+    if (this->len > 0)
+      memcpy(tmp, this->buf, this->len);
+    delete[] this->buf;
+
+    this->buf = tmp;
+    this->cap = newCap;
+  }
+
+public:
+  FormatBuffer() {}
+
+  FormatBuffer(size_t cap)
+  {
+    this->reserve(cap);
+  }
+
+  FormatBuffer(const FormatBuffer& other)
+  {
+    this->append(other.buf, other.len);
+  }
+
+  FormatBuffer& operator=(const FormatBuffer& other)
+  {
+    if (&other != this)
+    {
+      this->clear();
+      this->append(other.buf, other.len);
+    }
+    return *this;
+  }
+
+  ~FormatBuffer()
+  {
+    delete[] this->buf;
+  }
+
+  /**
+    * Make sure the buffer can hold at least `cap` characters without reallocating
+    */
+  void reserve(size_t cap)
+  {
+    if (cap > this->cap)
+      this->grow(cap);
+  }
+
+  /**
+    * Get a pointer to at least `n` writable characters at the end of the buffer
+    *
+    * @note The characters are only part of the buffer once they are `commit()`ed.
+    */
+  char * claim(size_t n)
+  {
+    if (this->len + n > this->cap)
+      this->grow(this->len + n);
+    return this->buf + this->len;
+  }
+
+  void commit(size_t n)
+  {
+    this->len += n;
+  }
+
+  void append(const char * str, size_t n)
+  {
+    if (n == 0)
+      return;
+    memcpy(this->claim(n), str, n);
+    this->len += n;
+  }
+
+  void append(const char * str)
+  {
+    this->append(str, strlen(str));
+  }
+
+  void append(const std::string& str)
+  {
+    this->append(str.data(), str.size());
+  }
+
+  void append(char c)
+  {
+    *this->claim(1) = c;
+    this->len++;
+  }
+
+  void clear()
+  {
+    this->len = 0;
+  }
+
+  const char * data() const
+  {
+    return this->buf;
+  }
+
+  size_t length() const
+  {
+    return this->len;
+  }
+
+  size_t getCap() const
+  {
+    return this->cap;
+  }
+
+  std::string toString() const
+  {
+    return std::string(this->buf == nullptr ? "" : this->buf, this->len);
+  }
+
+  void writeTo(std::ostream& out) const
+  {
+    out.write(this->buf, (std::streamsize)this->len);
+  }
+};
+
+class Format
+{
+private:
+  // Amount of decimals written for floating point values, same as `std::to_string()`
+  static constexpr int FloatPrecision = 6;
+
+  // Amount of elements formatted per chunk when writing into a stream
+  static constexpr size_t StreamChunk = 4096;
+
+public:
+  /**
+    * Upper bound of characters needed to write a single value of type T
+    *
+    * Returns 0 if there is no fixed upper bound (e.g. for strings).
+    */
+  template <typename T> static constexpr size_t maxLength()
+  {
+    if constexpr (std::is_same_v<T, bool>)
+      return 1;
+    else if constexpr (std::is_integral_v<T>)
+      return std::numeric_limits<T>::digits10 + 2;
+    else if constexpr (std::is_floating_point_v<T>)
+      return std::numeric_limits<T>::max_exponent10 + FloatPrecision + 3;
+    else
+      return 0;
+  }
+
+  /**
+    * Expected (not maximal) amount of characters needed to write a single value of type T
+    */
+  template <typename T> static constexpr size_t typicalLength()
+  {
+    if constexpr (std::is_integral_v<T>)
+      return maxLength<T>();
+    else if constexpr (std::is_floating_point_v<T>)
+      return 16;
+    else
+      return 8;
+  }
+
+  /**
+    * Estimate the size of `join()`ing `count` elements of type T, so the sink can be sized up front
+    */
+  template <typename T> static size_t estimate(size_t count, const FormatOptions& opts = FormatOptions())
+  {
+    size_t n   = (count < opts.limit) ? count : opts.limit;
+    size_t res = strlen(opts.prefix) + strlen(opts.suffix) + n * (typicalLength<T>() + strlen(opts.separator));
+
+    if (n < count)
+      res += strlen(opts.truncation);
+    return res;
+  }
+
+  /**
+    * Append a single value to `out`
+    *
+    * Arithmetic types are written via `std::to_chars`, everything else goes through `to_string()`.
+    */
+  template <typename T> static void append(FormatBuffer& out, const T& val)
+  {
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      out.append(val ? '1' : '0');
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+      char * first = out.claim(maxLength<T>());
+      auto   res   = std::to_chars(first, first + maxLength<T>(), val);
+      out.commit(res.ptr - first);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+#if defined(__cpp_lib_to_chars)
+      char * first = out.claim(maxLength<T>());
+      auto   res   = std::to_chars(first, first + maxLength<T>(), val, std::chars_format::fixed, FloatPrecision);
+      out.commit(res.ptr - first);
+#else
+      // snprintf needs room for the terminating null and returns the untruncated length
+      char * first = out.claim(maxLength<T>() + 1);
+      int    n     = snprintf(first, maxLength<T>() + 1, "%.*Lf", FloatPrecision, (long double)val);
+      out.commit(n > 0 ? std::min((size_t)n, maxLength<T>()) : 0);
+#endif
+    }
+    else
+    {
+      using std::to_string;
+      out.append(to_string(val));
+    }
+  }
+
+  /**
+    * Write `count` elements starting at `data` into `out`, as configured by `opts`
+    *
+    * The sink is sized up front using `estimate()`, so typically only a single allocation takes place.
+    */
+  template <typename T>
+  static void join(FormatBuffer& out, const T * data, size_t count, const FormatOptions& opts = FormatOptions())
+  {
+    size_t n      = (count < opts.limit) ? count : opts.limit;
+    size_t sepLen = strlen(opts.separator);
+
+    out.reserve(out.length() + estimate<T>(count, opts));
+    out.append(opts.prefix);
+
+    for (size_t i = 0; i < n; i++)
+    {
+      append(out, data[i]);
+      if (opts.trailingSeparator || i + 1 < n)
+        out.append(opts.separator, sepLen);
+    }
+
+    if (n < count)
+      out.append(opts.truncation);
+    out.append(opts.suffix);
+  }
+
+  /**
+    * Write `count` elements starting at `data` into a stream
+    *
+    * Elements are formatted in fixed size chunks into `scratch`, so memory use does not grow with `count`.
+    */
+  template <typename T>
+  static void join(std::ostream& out, const T * data, size_t count, const FormatOptions& opts, FormatBuffer& scratch)
+  {
+    size_t n      = (count < opts.limit) ? count : opts.limit;
+    size_t sepLen = strlen(opts.separator);
+
+    scratch.clear();
+    scratch.append(opts.prefix);
+
+    for (size_t i = 0; i < n; i++)
+    {
+      append(scratch, data[i]);
+      if (opts.trailingSeparator || i + 1 < n)
+        scratch.append(opts.separator, sepLen);
+
+      if ((i + 1) % StreamChunk == 0)
+      {
+        scratch.writeTo(out);
+        scratch.clear();
+      }
+    }
+
+    if (n < count)
+      scratch.append(opts.truncation);
+    scratch.append(opts.suffix);
+    scratch.writeTo(out);
+    scratch.clear();
+  }
+
+  template <typename T>
+  static void join(std::ostream& out, const T * data, size_t count, const FormatOptions& opts = FormatOptions())
+  {
+    FormatBuffer scratch(StreamChunk * (typicalLength<T>() + strlen(opts.separator)));
+    join(out, data, count, opts, scratch);
+  }
+};
+} // namespace CppUtil
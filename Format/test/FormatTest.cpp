@@ -0,0 +1,150 @@
+#include "Format.hpp"
+
+#include <limits>
+#include <sstream>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("FormatBuffer", "[format][buffer]")
+{
+  FormatBuffer buf;
+
+  SECTION("Characters and strings can be appended")
+  {
+    buf.append("Hello");
+    buf.append(' ');
+    buf.append(std::string("World"));
+
+    REQUIRE(buf.length() == 11);
+    REQUIRE(buf.toString() == "Hello World");
+  }
+
+  SECTION("Clearing a FormatBuffer keeps its capacity")
+  {
+    buf.reserve(100);
+    buf.append("Hello");
+    buf.clear();
+
+    REQUIRE(buf.length() == 0);
+    REQUIRE(buf.getCap() >= 100);
+    REQUIRE(buf.toString() == "");
+  }
+
+  SECTION("FormatBuffer grows when appending beyond its capacity")
+  {
+    for (int i = 0; i < 1'000; i++)
+    {
+      buf.append("0123456789");
+    }
+
+    REQUIRE(buf.length() == 10'000);
+    REQUIRE(buf.data()[9'999] == '9');
+  }
+}
+
+TEST_CASE("Format values", "[format][value]")
+{
+  FormatBuffer buf;
+
+  SECTION("Integers are formatted like std::to_string")
+  {
+    Format::append(buf, 0);
+    buf.append(' ');
+    Format::append(buf, -123);
+    buf.append(' ');
+    Format::append(buf, std::numeric_limits<long long>::min());
+    buf.append(' ');
+    Format::append(buf, std::numeric_limits<unsigned long long>::max());
+
+    REQUIRE(buf.toString() == "0 -123 " + std::to_string(std::numeric_limits<long long>::min()) + " " +
+                                std::to_string(std::numeric_limits<unsigned long long>::max()));
+  }
+
+  SECTION("Floating point values are formatted like std::to_string")
+  {
+    Format::append(buf, 1.5);
+    buf.append(' ');
+    Format::append(buf, -0.25f);
+    buf.append(' ');
+    Format::append(buf, std::numeric_limits<double>::max());
+
+    REQUIRE(buf.toString() == std::to_string(1.5) + " " + std::to_string(-0.25f) + " " +
+                                std::to_string(std::numeric_limits<double>::max()));
+  }
+
+  SECTION("Booleans are formatted as 0 and 1")
+  {
+    Format::append(buf, true);
+    Format::append(buf, false);
+
+    REQUIRE(buf.toString() == "10");
+  }
+}
+
+TEST_CASE("Format ranges", "[format][join]")
+{
+  int          data[] = {1, 2, 3, 4, 5};
+  FormatBuffer buf;
+
+  SECTION("Default options produce the classic to_string format")
+  {
+    Format::join(buf, data, 5);
+    REQUIRE(buf.toString() == "{1 2 3 4 5 }");
+  }
+
+  SECTION("Prefix, separator and suffix can be configured")
+  {
+    FormatOptions opts;
+    opts.prefix            = "[";
+    opts.separator         = ", ";
+    opts.suffix            = "]";
+    opts.trailingSeparator = false;
+
+    Format::join(buf, data, 5, opts);
+    REQUIRE(buf.toString() == "[1, 2, 3, 4, 5]");
+  }
+
+  SECTION("Output can be truncated")
+  {
+    FormatOptions opts;
+    opts.limit             = 2;
+    opts.separator         = ",";
+    opts.truncation        = "...";
+    opts.trailingSeparator = false;
+
+    Format::join(buf, data, 5, opts);
+    REQUIRE(buf.toString() == "{1,2...}");
+  }
+
+  SECTION("Empty ranges only write prefix and suffix")
+  {
+    Format::join(buf, data, 0);
+    REQUIRE(buf.toString() == "{}");
+  }
+
+  SECTION("A FormatBuffer can be reused")
+  {
+    Format::join(buf, data, 5);
+    buf.clear();
+    Format::join(buf, data, 3);
+    REQUIRE(buf.toString() == "{1 2 3 }");
+  }
+
+  SECTION("Ranges can be written into a stream")
+  {
+    std::ostringstream out;
+    int                big[10'000];
+    std::string        expected = "{";
+    for (int i = 0; i < 10'000; i++)
+    {
+      big[i] = i;
+      expected += std::to_string(i) + " ";
+    }
+    expected += "}";
+
+    Format::join(out, big, 10'000);
+    REQUIRE(out.str() == expected);
+  }
+}
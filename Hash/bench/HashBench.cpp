@@ -0,0 +1,64 @@
+#include "Benchmark.hpp"
+#include "Hash.hpp"
+
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+
+using namespace CppUtil;
+
+// Total bytes hashed per measurement, split into keys of the measured size
+static constexpr size_t TotalBytes = 64 << 20;
+
+int main()
+{
+  std::mt19937_64 rng(11);
+  Array<uint8_t>  buf(TotalBytes + 64);
+  for (size_t i = 0; i < buf.getSize(); i++)
+    buf[i] = (uint8_t)rng();
+  const char * data = (const char *)(const uint8_t *)buf;
+
+  for (size_t len : {8, 16, 32, 64, 256, 1'024, 4'096, 65'536, 1 << 20})
+  {
+    size_t keys = TotalBytes / len;
+
+    uint64_t sum   = 0;
+    double   fresh = Benchmark::measure(
+      [&]
+      {
+        sum = 0;
+        for (size_t i = 0; i < keys; i++)
+          sum += Hash::bytes(data + i * len, len);
+        Benchmark::doNotOptimize(sum);
+      },
+      5);
+    double std = Benchmark::measure(
+      [&]
+      {
+        sum = 0;
+        for (size_t i = 0; i < keys; i++)
+          sum += std::hash<std::string_view>()(std::string_view(data + i * len, len));
+        Benchmark::doNotOptimize(sum);
+      },
+      5);
+
+    std::string suffix = ", " + std::to_string(len) + " B keys";
+    Benchmark::report(("Hash::bytes" + suffix).c_str(), fresh, keys, TotalBytes);
+    Benchmark::report(("std::hash<string_view>" + suffix).c_str(), std, keys, TotalBytes);
+    printf("  speedup: %.1fx\n\n", std / fresh);
+  }
+
+  uint64_t sum  = 0;
+  double   ints = Benchmark::measure(
+    [&]
+    {
+      sum = 0;
+      for (uint64_t i = 0; i < TotalBytes / 8; i++)
+        sum += Hash::integer(i);
+      Benchmark::doNotOptimize(sum);
+    },
+    5);
+  Benchmark::report("Hash::integer", ints, TotalBytes / 8, TotalBytes);
+  return 0;
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "Array.hpp"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace CppUtil
+{
+/**
+  * Fast non-cryptographic 64 bit hashing
+  *
+  * Byte ranges are hashed with the wyhash construction: 48 bytes per round are folded into three independent lanes by
+  * 64x64->128 bit multiplications, which keeps the multipliers busy and reaches memory bandwidth for large inputs.
+  * Inputs of up to 16 bytes take a single multiplication round. Not suitable where hash flooding by an attacker is a
+  * concern unless a secret seed is used.
+  */
+class Hash
+{
+private:
+  static constexpr uint64_t Secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+                                         0x4d5a2da51de1aa47ull};
+
+  // Full 128 bit product of `a` and `b`, low half in `a` and high half in `b`
+  static constexpr void multiplyConst(uint64_t& a, uint64_t& b)
+  {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+
+    uint128 r = (uint128)a * b;
+    a         = (uint64_t)r;
+    b         = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    uint64_t c  = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+  }
+
+  // Reads and multiplications for hashing at runtime, using unaligned little endian loads and compiler intrinsics
+  struct RuntimeOps
+  {
+    static void multiply(uint64_t& a, uint64_t& b)
+    {
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+      a = _umul128(a, b, &b);
+#else
+      multiplyConst(a, b);
+#endif
+    }
+
+    static uint64_t read8(const uint8_t * p)
+    {
+      uint64_t v;
+      memcpy(&v, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+      v = __builtin_bswap64(v);
+#endif
+      return v;
+    }
+
+    static uint64_t read4(const uint8_t * p)
+    {
+      uint32_t v;
+      memcpy(&v, p, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+      v = __builtin_bswap32(v);
+#endif
+      return v;
+    }
+  };
+
+  // Reads assembled from single characters in little endian order, usable during compilation
+  struct ConstOps
+  {
+    static constexpr void multiply(uint64_t& a, uint64_t& b)
+    {
+      multiplyConst(a, b);
+    }
+
+    static constexpr uint64_t read8(const char * p)
+    {
+      return read4(p) | (read4(p + 4) << 32);
+    }
+
+    static constexpr uint64_t read4(const char * p)
+    {
+      return (uint64_t)(uint8_t)p[0] | ((uint64_t)(uint8_t)p[1] << 8) | ((uint64_t)(uint8_t)p[2] << 16) |
+             ((uint64_t)(uint8_t)p[3] << 24);
+    }
+  };
+
+  template <typename Ops> static constexpr uint64_t mix(uint64_t a, uint64_t b)
+  {
+    Ops::multiply(a, b);
+    return a ^ b;
+  }
+
+  template <typename Ops, typename Char> static constexpr uint64_t bytesWith(const Char * p, size_t len, uint64_t seed)
+  {
+    uint64_t a = 0, b = 0;
+
+    seed ^= mix<Ops>(seed ^ Secret[0], Secret[1]);
+    if (len <= 16)
+    {
+      if (len >= 4)
+      {
+        // Two possibly overlapping 4 byte reads from each end cover 4 to 16 bytes without branching on the length
+        size_t off = (len >> 3) << 2;
+        a          = (Ops::read4(p) << 32) | Ops::read4(p + off);
+        b          = (Ops::read4(p + len - 4) << 32) | Ops::read4(p + len - 4 - off);
+      }
+      else if (len > 0)
+      {
+        a = ((uint64_t)(uint8_t)p[0] << 16) | ((uint64_t)(uint8_t)p[len >> 1] << 8) | (uint8_t)p[len - 1];
+        b = 0;
+      }
+    }
+    else
+    {
+      size_t i = len;
+      if (i >= 48)
+      {
+        uint64_t lane1 = seed, lane2 = seed;
+        do
+        {
+          seed  = mix<Ops>(Ops::read8(p) ^ Secret[1], Ops::read8(p + 8) ^ seed);
+          lane1 = mix<Ops>(Ops::read8(p + 16) ^ Secret[2], Ops::read8(p + 24) ^ lane1);
+          lane2 = mix<Ops>(Ops::read8(p + 32) ^ Secret[3], Ops::read8(p + 40) ^ lane2);
+          p += 48;
+          i -= 48;
+        } while (i >= 48);
+        seed ^= lane1 ^ lane2;
+      }
+      while (i > 16)
+      {
+        seed = mix<Ops>(Ops::read8(p) ^ Secret[1], Ops::read8(p + 8) ^ seed);
+        p += 16;
+        i -= 16;
+      }
+      a = Ops::read8(p + i - 16);
+      b = Ops::read8(p + i - 8);
+    }
+
+    a ^= Secret[1];
+    b ^= seed;
+    Ops::multiply(a, b);
+    return mix<Ops>(a ^ Secret[0] ^ len, b ^ Secret[1]);
+  }
+
+public:
+  /**
+    * Hash of `len` bytes at `data`
+    */
+  static uint64_t bytes(const void * data, size_t len, uint64_t seed = 0)
+  {
+    return bytesWith<RuntimeOps>((const uint8_t *)data, len, seed);
+  }
+
+  static uint64_t string(std::string_view str, uint64_t seed = 0)
+  {
+    return bytes(str.data(), str.size(), seed);
+  }
+
+  /**
+    * `Hash::string` evaluable during compilation, e.g. for `switch` labels or tables of known keys
+    *
+    * Reads characters one by one, so prefer `Hash::string` at runtime. Both return the same hash, so hashes
+    * computed during compilation can be compared with hashes computed at runtime.
+    */
+  static constexpr uint64_t constString(std::string_view str, uint64_t seed = 0)
+  {
+    return bytesWith<ConstOps>(str.data(), str.size(), seed);
+  }
+
+  /**
+    * Hash of a single 64 bit value
+    *
+    * Every input bit affects every output bit, unlike `std::hash` of integers which is the identity.
+    */
+  static constexpr uint64_t integer(uint64_t value, uint64_t seed = 0)
+  {
+    uint64_t a = value ^ Secret[0], b = seed ^ Secret[1];
+    multiplyConst(a, b);
+    return mix<ConstOps>(a ^ Secret[0], b ^ Secret[1]);
+  }
+
+  /**
+    * Combine the hash `value` of one part of a compound key into `seed`, which is the hash of the previous parts
+    *
+    * The result depends on the order in which parts are combined.
+    */
+  static constexpr uint64_t combine(uint64_t seed, uint64_t value)
+  {
+    return mix<ConstOps>(seed ^ Secret[2], value ^ Secret[3]);
+  }
+};
+
+/**
+  * Hash function object for keys of type T, usable as hasher of `std::unordered_map`
+  *
+  * Supports integers and enums, string-like types (anything convertible to `std::string_view` or providing `view()`
+  * like `String`) and `Array` / `DynamicArray` of supported types. Other types can specialize `Hasher`.
+  * String-like types hash equally if they contain the same characters.
+  *
+  * Like `std::hash`, the primary template is disabled: it cannot be constructed, so `isHashable` can tell which types
+  * are supported.
+  */
+template <typename T, typename = void> struct Hasher
+{
+  Hasher()                         = delete;
+  Hasher(const Hasher&)            = delete;
+  Hasher& operator=(const Hasher&) = delete;
+};
+
+/**
+  * Whether `Hasher<T>` is specialized for T
+  */
+template <typename T> constexpr bool isHashable = std::is_default_constructible_v<Hasher<T>>;
+
+template <typename T, typename = void> struct HasStringView : std::false_type
+{
+};
+
+template <typename T>
+struct HasStringView<T, std::void_t<decltype(std::string_view(std::declval<const T&>().view()))>> : std::true_type
+{
+};
+
+template <typename T>
+struct Hasher<T, std::enable_if_t<HasStringView<T>::value || std::is_convertible_v<const T&, std::string_view> ||
+                                  std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>>>
+{
+  uint64_t seed = 0;
+
+  Hasher(uint64_t seed = 0) : seed(seed) {}
+
+  size_t operator()(const T& value) const
+  {
+    if constexpr (HasStringView<T>::value)
+      return (size_t)Hash::string(value.view(), this->seed);
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+      return (size_t)Hash::string(std::string_view(value), this->seed);
+    else if constexpr (std::is_enum_v<T>)
+      return (size_t)Hash::integer((uint64_t)(std::underlying_type_t<T>)value, this->seed);
+    else if constexpr (std::is_pointer_v<T>)
+      return (size_t)Hash::integer((uint64_t)(uintptr_t)value, this->seed);
+    else
+      return (size_t)Hash::integer((uint64_t)value, this->seed);
+  }
+};
+
+/**
+  * Hash of `Array<T>` over its elements
+  *
+  * Elements without padding or other ambiguous bytes are hashed as one byte range, others are hashed one by one and
+  * combined.
+  */
+template <typename T>
+struct Hasher<Array<T>, std::enable_if_t<std::has_unique_object_representations_v<T> || isHashable<T>>>
+{
+  uint64_t seed = 0;
+
+  Hasher(uint64_t seed = 0) : seed(seed) {}
+
+  static uint64_t elements(const T * data, size_t n, uint64_t seed)
+  {
+    if constexpr (std::has_unique_object_representations_v<T>)
+      return Hash::bytes(data, n * sizeof(T), seed);
+    else
+    {
+      Hasher<T> item(seed);
+      uint64_t  res = Hash::integer(n, seed);
+      for (size_t i = 0; i < n; i++)
+      {
+        res = Hash::combine(res, item(data[i]));
+      }
+      return res;
+    }
+  }
+
+  size_t operator()(const Array<T>& arr) const
+  {
+    return (size_t)elements((const T *)arr, arr.getSize(), this->seed);
+  }
+};
+
+template <typename T>
+struct Hasher<DynamicArray<T>, std::enable_if_t<std::has_unique_object_representations_v<T> || isHashable<T>>>
+{
+  uint64_t seed = 0;
+
+  Hasher(uint64_t seed = 0) : seed(seed) {}
+
+  size_t operator()(const DynamicArray<T>& arr) const
+  {
+    return (size_t)Hasher<Array<T>>::elements(arr.getData(), arr.getCount(), this->seed);
+  }
+};
+
+/**
+  * Hash of a compound key made of `parts`, e.g. `hashValues(id, name)`
+  */
+template <typename... Parts> uint64_t hashValues(const Parts&... parts)
+{
+  uint64_t res = 0;
+  ((res = Hash::combine(res, Hasher<Parts>()(parts))), ...);
+  return res;
+}
+} // namespace CppUtil
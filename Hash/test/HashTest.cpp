@@ -0,0 +1,145 @@
+#include "Hash.hpp"
+#include "String.hpp"
+
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+static size_t bitDiff(uint64_t a, uint64_t b)
+{
+  size_t res = 0;
+  for (uint64_t x = a ^ b; x != 0; x &= x - 1)
+  {
+    res++;
+  }
+  return res;
+}
+
+TEST_CASE("Hash of byte ranges", "[hash][bytes]")
+{
+  std::mt19937_64      rng(3);
+  std::vector<uint8_t> buf(1'100);
+  for (auto& b : buf)
+  {
+    b = (uint8_t)rng();
+  }
+
+  SECTION("Every length and seed gives a different hash")
+  {
+    std::set<uint64_t> seen;
+    for (size_t len = 0; len <= buf.size(); len++)
+    {
+      seen.insert(Hash::bytes(buf.data(), len));
+      seen.insert(Hash::bytes(buf.data(), len, 1));
+    }
+    REQUIRE(2 * (buf.size() + 1) == seen.size());
+  }
+
+  SECTION("Hashes only depend on the content, not the alignment")
+  {
+    for (size_t len : {0, 3, 4, 8, 16, 17, 48, 100, 1'000})
+    {
+      std::vector<uint8_t> copy(buf.begin() + 1, buf.begin() + 1 + len);
+      REQUIRE(Hash::bytes(buf.data() + 1, len) == Hash::bytes(copy.data(), len));
+    }
+  }
+
+  SECTION("Flipping a single input bit flips about half of the output bits")
+  {
+    for (size_t len : {1, 4, 8, 12, 16, 32, 64, 1'000})
+    {
+      size_t   flips = 0, trials = 0;
+      uint64_t base = Hash::bytes(buf.data(), len);
+      for (size_t bit = 0; bit < len * 8; bit++)
+      {
+        buf[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        flips += bitDiff(base, Hash::bytes(buf.data(), len));
+        buf[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        trials++;
+      }
+      double avg = (double)flips / trials;
+      REQUIRE(avg > 24);
+      REQUIRE(avg < 40);
+    }
+  }
+}
+
+TEST_CASE("Hash of integers and compound keys", "[hash][integer]")
+{
+  std::set<uint64_t> seen;
+  for (uint64_t i = 0; i < 10'000; i++)
+  {
+    seen.insert(Hash::integer(i << 20) >> 52);
+  }
+  // Keys differing only in high bits still spread over the low 12 bits of the hash
+  REQUIRE(seen.size() > 3'500);
+
+  REQUIRE(Hash::integer(1) != Hash::integer(1, 1));
+  REQUIRE(hashValues(1, 2) != hashValues(2, 1));
+  REQUIRE(hashValues(1, std::string("a")) == hashValues(1, "a"));
+  REQUIRE(Hash::combine(Hash::integer(1), Hash::integer(2)) != Hash::combine(Hash::integer(2), Hash::integer(1)));
+}
+
+TEST_CASE("Hasher specializations", "[hash][hasher]")
+{
+  SECTION("String-like types hash equally for the same characters")
+  {
+    const char * str = "hello world";
+    size_t       h   = Hasher<String>()(String(str));
+    REQUIRE(h == Hasher<std::string>()(std::string(str)));
+    REQUIRE(h == Hasher<std::string_view>()(std::string_view(str)));
+    REQUIRE(h == Hasher<const char *>()(str));
+    REQUIRE(h == Hash::string(str));
+    REQUIRE(h != Hasher<String>(7)(String(str)));
+  }
+
+  SECTION("Arrays hash by content")
+  {
+    Array<int>        arr = {1, 2, 3};
+    DynamicArray<int> dyn;
+    dyn.addRange(arr, 3);
+    REQUIRE(Hasher<Array<int>>()(arr) == Hasher<DynamicArray<int>>()(dyn));
+    REQUIRE(Hasher<Array<int>>()(arr) == Hash::bytes((const int *)arr, 3 * sizeof(int)));
+
+    dyn.add(4);
+    REQUIRE(Hasher<Array<int>>()(arr) != Hasher<DynamicArray<int>>()(dyn));
+
+    Array<String> strs = {"a", "bc"};
+    Array<String> same = {"a", "bc"};
+    Array<String> diff = {"ab", "c"};
+    REQUIRE(Hasher<Array<String>>()(strs) == Hasher<Array<String>>()(same));
+    REQUIRE(Hasher<Array<String>>()(strs) != Hasher<Array<String>>()(diff));
+  }
+
+  SECTION("Hasher can be used by standard containers")
+  {
+    std::unordered_map<String, int, Hasher<String>> m;
+    m["one"] = 1;
+    m["two"] = 2;
+    REQUIRE(m["one"] == 1);
+    REQUIRE(m["two"] == 2);
+  }
+
+  SECTION("Unsupported types are detected")
+  {
+    struct Padded
+    {
+      char c;
+      int  i;
+    };
+
+    STATIC_REQUIRE(isHashable<int>);
+    STATIC_REQUIRE(isHashable<String>);
+    STATIC_REQUIRE(isHashable<Array<String>>);
+    STATIC_REQUIRE(isHashable<DynamicArray<int>>);
+    STATIC_REQUIRE_FALSE(isHashable<Padded>);
+    STATIC_REQUIRE_FALSE(isHashable<Array<Padded>>);
+  }
+}
@@ -0,0 +1,98 @@
+#include "AsyncFile.hpp"
+#include "Benchmark.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace CppUtil;
+
+static constexpr size_t FileSize  = 256 << 20;
+static constexpr size_t BlockSize = 4096;
+static constexpr size_t Reads     = 200'000;
+
+static const char * backendName(IoService::Backend backend)
+{
+  return (backend == IoService::Backend::IoUring) ? "io_uring" : "thread pool";
+}
+
+// Issue `Reads` random 4K reads, keeping up to `depth` in flight
+static double randomReads(IoService& io, AsyncFile& file, const std::vector<uint64_t>& offsets, size_t depth)
+{
+  std::vector<char>            buffers(depth * BlockSize);
+  std::vector<Promise<size_t>> inFlight;
+  inFlight.reserve(depth);
+
+  return Benchmark::measure(
+    [&]
+    {
+      inFlight.clear();
+      size_t bytes = 0;
+      for (size_t i = 0; i < offsets.size(); i += depth)
+      {
+        size_t n = std::min(depth, offsets.size() - i);
+        {
+          IoService::Batch batch(io);
+          for (size_t j = 0; j < n; j++)
+            inFlight.push_back(file.read(&buffers[j * BlockSize], BlockSize, offsets[i + j]));
+        }
+        for (auto& p : inFlight)
+          bytes += p.get();
+        inFlight.clear();
+      }
+      Benchmark::doNotOptimize(bytes);
+    },
+    3);
+}
+
+int main()
+{
+  auto path = (std::filesystem::temp_directory_path() / "CppUtil_AsyncFileBench.bin").string();
+  {
+    std::ofstream     out(path, std::ios::binary);
+    std::vector<char> block(1 << 20, 'x');
+    for (size_t i = 0; i < FileSize; i += block.size())
+      out.write(block.data(), block.size());
+  }
+
+  std::mt19937_64       rng(42);
+  std::vector<uint64_t> offsets(Reads);
+  for (auto& o : offsets)
+    o = (rng() % (FileSize / BlockSize)) * BlockSize;
+
+  // Blocking reads one after another, as done before IoService
+  {
+    int    fd = open(path.c_str(), O_RDONLY);
+    char   buf[BlockSize];
+    double sec = Benchmark::measure(
+      [&]
+      {
+        size_t bytes = 0;
+        for (auto o : offsets)
+          bytes += pread(fd, buf, BlockSize, o);
+        Benchmark::doNotOptimize(bytes);
+      },
+      3);
+    close(fd);
+    Benchmark::report("random 4K reads, blocking pread", sec, Reads, Reads * BlockSize);
+  }
+
+  for (auto backend : {IoService::Backend::ThreadPool, IoService::Backend::IoUring})
+  {
+    IoService io(256, 4, backend);
+    AsyncFile file(io, path.c_str());
+
+    for (size_t depth : {1, 32, 256})
+    {
+      double      sec = randomReads(io, file, offsets, depth);
+      std::string name =
+        std::string("random 4K reads, ") + backendName(io.getBackend()) + ", depth " + std::to_string(depth);
+      Benchmark::report(name.c_str(), sec, Reads, Reads * BlockSize);
+    }
+  }
+
+  std::filesystem::remove(path);
+  return 0;
+}
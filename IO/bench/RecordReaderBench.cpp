@@ -0,0 +1,87 @@
+#include "Benchmark.hpp"
+#include "RecordReader.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+using namespace CppUtil;
+
+static constexpr size_t Size = 256 << 20;
+
+// Log-like lines of 40 to 160 characters with space separated fields
+static std::string writeLog()
+{
+  auto          path = (std::filesystem::temp_directory_path() / "CppUtil_RecordReaderBench.log").string();
+  std::ofstream out(path, std::ios::binary);
+  std::mt19937  rng(42);
+
+  std::string line;
+  for (size_t written = 0; written < Size; written += line.size())
+  {
+    line       = "2024-01-01T00:00:00 INFO worker-" + std::to_string(rng() % 64) + " ";
+    size_t len = 40 + rng() % 120;
+    while (line.size() < len)
+      line += (rng() % 8) ? (char)('a' + rng() % 26) : ' ';
+    line += '\n';
+    out << line;
+  }
+  return path;
+}
+
+int main()
+{
+  std::string path  = writeLog();
+  size_t      bytes = std::filesystem::file_size(path);
+
+  // Reading as before RecordReader: std::getline, then a String copy of every line
+  size_t lines = 0;
+  size_t sum   = 0;
+  double sec   = Benchmark::measure(
+    [&]
+    {
+      std::ifstream in(path, std::ios::binary);
+      std::string   line;
+      lines = 0;
+      while (std::getline(in, line))
+      {
+        String s = line;
+        sum += s.length();
+        lines++;
+      }
+    },
+    3);
+  Benchmark::doNotOptimize(sum);
+  Benchmark::report("256 MiB log, std::getline + String", sec, lines, bytes);
+
+  sec = Benchmark::measure(
+    [&]
+    {
+      LineReader reader(path.c_str());
+      lines = reader.foreach ([&](std::string_view line) { sum += line.size(); });
+    },
+    3);
+  Benchmark::doNotOptimize(sum);
+  Benchmark::report("256 MiB log, LineReader", sec, lines, bytes);
+
+  DynamicArray<std::string_view> fields;
+  CharSet                        spaces(" ");
+  sec = Benchmark::measure(
+    [&]
+    {
+      LineReader reader(path.c_str());
+      lines = 0;
+      while (reader.next(spaces, fields))
+      {
+        sum += fields.getCount();
+        lines++;
+      }
+    },
+    3);
+  Benchmark::doNotOptimize(sum);
+  Benchmark::report("256 MiB log, LineReader + fields", sec, lines, bytes);
+
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,716 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "Async.hpp"
+#include "Platform.hpp"
+#include "String.hpp"
+
+#if defined(PLATFORM_UNIX_LIKE)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(PLATFORM_LINUX) && __has_include(<linux/io_uring.h>)
+#define ASYNCFILE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(PLATFORM_UNIX_LIKE)
+namespace CppUtil
+{
+/**
+  * Executor for asynchronous file I/O at explicit offsets
+  *
+  * On Linux, requests are handed to the kernel through an io_uring, so a handful of threads can keep hundreds of
+  * requests in flight; a single completion thread resolves the returned promises. If the kernel refuses requests,
+  * their promises fail with `std::system_error`. Where io_uring is not available (other platforms, old kernels,
+  * seccomp filters), requests run as blocking `pread`/`pwrite` on a `ThreadPool`.
+  *
+  * Buffers passed to `read` and `write` must stay valid until the returned promise is finished.
+  */
+class IoService
+{
+public:
+  enum class Backend
+  {
+    IoUring,
+    ThreadPool
+  };
+
+  static constexpr unsigned DefaultQueueDepth      = 256;
+  static constexpr size_t   DefaultFallbackThreads = 4;
+
+#if defined(ASYNCFILE_IO_URING)
+  using EnterFn = int (*)(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags);
+
+  /**
+    * Replacement for the `io_uring_enter` syscall if set, so tests can inject failures
+    */
+  static inline std::atomic<EnterFn> enterHook{nullptr};
+#endif
+
+private:
+  enum class Op
+  {
+    Read,
+    Write,
+    Fsync
+  };
+
+  static std::exception_ptr error(int err, Op op)
+  {
+    const char * name = (op == Op::Read) ? "read" : (op == Op::Write) ? "write" : "fsync";
+    return std::make_exception_ptr(
+      std::system_error(err, std::generic_category(), std::string("Asynchronous ") + name + " failed"));
+  }
+
+#if defined(ASYNCFILE_IO_URING)
+  /**
+    * Minimal io_uring driven through the raw syscalls
+    *
+    * Errors of `io_uring_enter` never escape: requests the kernel did not take are failed with the error. If waiting
+    * for completions fails, the ring is broken: all requests in flight fail and later requests fail right away.
+    */
+  class Ring
+  {
+  private:
+    // Completion target of a request, passed as `user_data`; 0 marks the wakeup request sent on shutdown
+    struct Request
+    {
+      Future<size_t> future;
+      Op             op;
+      int            result = 0;
+      Request *      prev   = nullptr;
+      Request *      next   = nullptr;
+    };
+
+    using RequestPool = BlockPool<std::max(sizeof(Request), 2 * sizeof(void *))>;
+
+    // Attempts to submit while the kernel reports being out of resources, waiting a millisecond each
+    static constexpr unsigned MaxBusyRetries = 100;
+
+    int fd = -1;
+
+    void * sqPtr  = nullptr;
+    size_t sqSize = 0;
+    void * cqPtr  = nullptr;
+    size_t cqSize = 0;
+
+    io_uring_sqe * sqes     = nullptr;
+    size_t         sqesSize = 0;
+
+    unsigned * sqTail;
+    unsigned * sqMask;
+    unsigned * sqArray;
+    unsigned   sqEntries;
+
+    unsigned *     cqHead;
+    unsigned *     cqTail;
+    unsigned *     cqMask;
+    io_uring_cqe * cqes;
+    unsigned       cqEntries;
+
+    // Guards the submission queue; `inFlight` never exceeds `cqEntries`, so completions cannot overflow
+    std::mutex              mtx;
+    std::condition_variable slots;
+    unsigned                inFlight = 0;
+    unsigned                queued   = 0;
+    size_t                  batching = 0;
+    Request *               pending  = nullptr; // All requests pushed and not yet completed
+    int                     broken   = 0;       // Error that stopped the reaper
+    bool                    stopping = false;
+
+    std::thread reaper;
+
+    static int enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+    {
+      if (auto hook = enterHook.load(std::memory_order_acquire))
+        return hook(fd, toSubmit, minComplete, flags);
+      return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    // Whether the ring supports all opcodes used by `submit`; kernels before 5.6 lack both them and the probe
+    static bool supportsOps(int fd)
+    {
+      constexpr unsigned MaxOps = 256;
+
+      alignas(io_uring_probe) unsigned char buf[sizeof(io_uring_probe) + MaxOps * sizeof(io_uring_probe_op)];
+      memset(buf, 0, sizeof(buf));
+      auto probe = (io_uring_probe *)buf;
+
+      if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, MaxOps) < 0)
+        return false;
+
+      for (unsigned op : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC, IORING_OP_NOP})
+      {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+          return false;
+      }
+      return true;
+    }
+
+    // Requires `mtx`
+    void link(Request * req)
+    {
+      req->prev = nullptr;
+      req->next = this->pending;
+      if (this->pending != nullptr)
+        this->pending->prev = req;
+      this->pending = req;
+    }
+
+    // Requires `mtx`
+    void unlink(Request * req)
+    {
+      if (req->prev != nullptr)
+        req->prev->next = req->next;
+      else
+        this->pending = req->next;
+      if (req->next != nullptr)
+        req->next->prev = req->prev;
+    }
+
+    // Fail all requests of a list linked by `next`, must be called without `mtx` as it runs continuations
+    static void fail(Request * list, int err)
+    {
+      while (list != nullptr)
+      {
+        Request * req = list;
+        list          = list->next;
+
+        req->future.setThrow(std::make_exception_ptr(
+          std::system_error(err, std::generic_category(), "Submitting to io_uring failed")));
+        req->future.finish();
+        req->~Request();
+        RequestPool::deallocate(req);
+      }
+    }
+
+    static void complete(Request * req)
+    {
+      if (req->result < 0)
+        req->future.setThrow(error(-req->result, req->op));
+      else
+        req->future.setValue((size_t)req->result);
+      req->future.finish();
+
+      req->~Request();
+      RequestPool::deallocate(req);
+    }
+
+    // Hand all queued entries to the kernel, requires `mtx`
+    //
+    // If the kernel does not take them, they are taken back out of the queue and returned in `failed`, to be passed
+    // to `fail` with the returned error once `mtx` is released.
+    int flush(std::unique_lock<std::mutex>& lock, Request *& failed)
+    {
+      unsigned busy = 0;
+      while (this->queued > 0)
+      {
+        int n   = enter(this->fd, this->queued, 0, 0);
+        int err = (n < 0) ? errno : EBUSY;
+        if (n > 0)
+        {
+          this->queued -= (unsigned)n;
+          busy = 0;
+        }
+        else if (err == EINTR)
+        {
+        }
+        else if ((err == EAGAIN || err == EBUSY) && busy++ < MaxBusyRetries)
+        {
+          // The kernel is short on resources until completions are reaped, so wait for them instead of spinning
+          this->slots.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        else
+        {
+          failed = this->takeBackQueued(failed);
+          return err;
+        }
+      }
+      return 0;
+    }
+
+    // Remove the entries the kernel has not seen from the submission queue, requires `mtx`
+    Request * takeBackQueued(Request * list)
+    {
+      unsigned tail = *this->sqTail;
+      for (unsigned i = 1; i <= this->queued; i++)
+      {
+        auto req = (Request *)this->sqes[(tail - i) & *this->sqMask].user_data;
+        if (req == nullptr)
+          continue;
+        this->unlink(req);
+        req->next = list;
+        list      = req;
+      }
+
+      __atomic_store_n(this->sqTail, tail - this->queued, __ATOMIC_RELEASE);
+      this->inFlight -= this->queued;
+      this->queued = 0;
+      this->slots.notify_all();
+      return list;
+    }
+
+    // Queue a request, requires `mtx`
+    void push(uint8_t opcode, int fd, uint64_t addr, uint32_t len, uint64_t offset, Request * req)
+    {
+      unsigned tail = *this->sqTail;
+      unsigned idx  = tail & *this->sqMask;
+
+      io_uring_sqe * sqe = &this->sqes[idx];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode    = opcode;
+      sqe->fd        = fd;
+      sqe->addr      = addr;
+      sqe->len       = len;
+      sqe->off       = offset;
+      sqe->user_data = (uint64_t)req;
+
+      if (req != nullptr)
+        this->link(req);
+
+      this->sqArray[idx] = idx;
+      __atomic_store_n(this->sqTail, tail + 1, __ATOMIC_RELEASE);
+      this->queued++;
+      this->inFlight++;
+    }
+
+    void reap()
+    {
+      while (true)
+      {
+        unsigned  head = *this->cqHead;
+        unsigned  tail = __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE);
+        Request * done = nullptr;
+        bool      exit = false;
+
+        if (head != tail)
+        {
+          // Every completed request was pushed under `mtx`, which also orders the requests before their completion
+          // in a way thread sanitizers can see, as they do not observe the ordering provided by the kernel
+          std::lock_guard<std::mutex> lock(this->mtx);
+          for (unsigned i = head; i != tail; i++)
+          {
+            const io_uring_cqe& cqe = this->cqes[i & *this->cqMask];
+            if (auto req = (Request *)cqe.user_data)
+            {
+              this->unlink(req);
+              req->result = cqe.res;
+              req->next   = done;
+              done        = req;
+            }
+          }
+          __atomic_store_n(this->cqHead, tail, __ATOMIC_RELEASE);
+
+          this->inFlight -= tail - head;
+          exit = this->stopping && this->inFlight == 0;
+          this->slots.notify_all();
+        }
+
+        while (done != nullptr)
+        {
+          Request * req = done;
+          done          = done->next;
+          complete(req);
+        }
+        if (exit)
+          return;
+
+        if (enter(this->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+          return this->breakRing(errno);
+      }
+    }
+
+    // Completions can no longer be waited for: fail everything in flight and make later requests fail right away
+    void breakRing(int err)
+    {
+      Request * list;
+      {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        this->broken   = err;
+        list           = this->pending;
+        this->pending  = nullptr;
+        this->inFlight = 0;
+        this->queued   = 0;
+        this->slots.notify_all();
+      }
+
+      // `pending` was linked by `next` already
+      fail(list, err);
+    }
+
+    void unmap()
+    {
+      if (this->sqes != nullptr)
+        munmap(this->sqes, this->sqesSize);
+      if (this->cqPtr != nullptr && this->cqPtr != this->sqPtr)
+        munmap(this->cqPtr, this->cqSize);
+      if (this->sqPtr != nullptr)
+        munmap(this->sqPtr, this->sqSize);
+      if (this->fd >= 0)
+        close(this->fd);
+    }
+
+  public:
+    /**
+      * @throws std::system_error If the kernel does not provide io_uring, or no support for reads and writes on it
+      */
+    explicit Ring(unsigned entries)
+    {
+      io_uring_params p;
+      memset(&p, 0, sizeof(p));
+
+      this->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+      if (this->fd < 0)
+        throw std::system_error(errno, std::generic_category(), "io_uring is not available");
+
+      if (!supportsOps(this->fd))
+      {
+        this->unmap();
+        throw std::system_error(EOPNOTSUPP, std::generic_category(), "io_uring does not support reads and writes");
+      }
+
+      this->sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+      this->cqSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+      if (p.features & IORING_FEAT_SINGLE_MMAP)
+        this->sqSize = this->cqSize = std::max(this->sqSize, this->cqSize);
+
+      auto map = [&](size_t size, off_t offset)
+      {
+        void * ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->fd, offset);
+        if (ptr == MAP_FAILED)
+        {
+          int err = errno;
+          this->unmap();
+          throw std::system_error(err, std::generic_category(), "Mapping the io_uring failed");
+        }
+        return ptr;
+      };
+
+      this->sqPtr = map(this->sqSize, IORING_OFF_SQ_RING);
+      this->cqPtr = (p.features & IORING_FEAT_SINGLE_MMAP) ? this->sqPtr : map(this->cqSize, IORING_OFF_CQ_RING);
+
+      this->sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+      this->sqes     = (io_uring_sqe *)map(this->sqesSize, IORING_OFF_SQES);
+
+      auto sq         = (char *)this->sqPtr;
+      this->sqTail    = (unsigned *)(sq + p.sq_off.tail);
+      this->sqMask    = (unsigned *)(sq + p.sq_off.ring_mask);
+      this->sqArray   = (unsigned *)(sq + p.sq_off.array);
+      this->sqEntries = p.sq_entries;
+
+      auto cq         = (char *)this->cqPtr;
+      this->cqHead    = (unsigned *)(cq + p.cq_off.head);
+      this->cqTail    = (unsigned *)(cq + p.cq_off.tail);
+      this->cqMask    = (unsigned *)(cq + p.cq_off.ring_mask);
+      this->cqes      = (io_uring_cqe *)(cq + p.cq_off.cqes);
+      this->cqEntries = p.cq_entries;
+
+      this->reaper = std::thread([this] { this->reap(); });
+    }
+
+    Ring(const Ring&)            = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    ~Ring()
+    {
+      // Wake the reaper with a no-op; it exits once all requests in flight are completed. If the no-op cannot be
+      // submitted either, the reaper exits with the next completion of a request still in flight.
+      Request * failed = nullptr;
+      int       err    = 0;
+      {
+        std::unique_lock<std::mutex> lock(this->mtx);
+        this->slots.wait(lock, [&] { return this->broken || this->inFlight < this->cqEntries; });
+        this->stopping = true;
+        if (!this->broken)
+        {
+          this->push(IORING_OP_NOP, -1, 0, 0, 0, nullptr);
+          err = this->flush(lock, failed);
+        }
+      }
+      fail(failed, err);
+
+      this->reaper.join();
+      this->unmap();
+    }
+
+    Promise<size_t> submit(Op op, int fd, uint64_t addr, size_t len, uint64_t offset)
+    {
+      uint8_t opcode = (op == Op::Read) ? IORING_OP_READ : (op == Op::Write) ? IORING_OP_WRITE : IORING_OP_FSYNC;
+
+      Request *                    failed = nullptr;
+      int                          err    = 0;
+      std::unique_lock<std::mutex> lock(this->mtx);
+      if (!this->broken && this->inFlight >= this->cqEntries)
+      {
+        // Requests held back by a batch cannot complete, so they must not be waited for
+        err = this->flush(lock, failed);
+        this->slots.wait(lock, [&] { return this->broken || this->inFlight < this->cqEntries; });
+      }
+
+      if (this->broken)
+      {
+        int brokenErr = this->broken;
+        lock.unlock();
+        fail(failed, err);
+
+        Future<size_t> future;
+        future.setThrow(std::make_exception_ptr(
+          std::system_error(brokenErr, std::generic_category(), "Waiting for io_uring completions failed")));
+        future.finish();
+        return future.asPromise();
+      }
+
+      auto req = new (RequestPool::allocate()) Request{Future<size_t>(), op};
+      auto res = req->future.asPromise();
+
+      this->push(opcode, fd, addr, (uint32_t)std::min<size_t>(len, UINT32_MAX), offset, req);
+
+      if (this->batching == 0 || this->queued == this->sqEntries)
+      {
+        int flushErr = this->flush(lock, failed);
+        if (flushErr != 0)
+          err = flushErr;
+      }
+
+      lock.unlock();
+      fail(failed, err);
+      return res;
+    }
+
+    void beginBatch()
+    {
+      std::lock_guard<std::mutex> lock(this->mtx);
+      this->batching++;
+    }
+
+    void endBatch()
+    {
+      Request * failed = nullptr;
+      int       err    = 0;
+      {
+        std::unique_lock<std::mutex> lock(this->mtx);
+        if (--this->batching == 0)
+          err = this->flush(lock, failed);
+      }
+      fail(failed, err);
+    }
+  };
+
+  std::unique_ptr<Ring> ring;
+#endif
+
+  std::unique_ptr<ThreadPool> pool;
+
+  Promise<size_t> submit(Op op, int fd, void * buf, size_t len, uint64_t offset)
+  {
+#if defined(ASYNCFILE_IO_URING)
+    if (this->ring)
+      return this->ring->submit(op, fd, (uint64_t)buf, len, offset);
+#endif
+
+    Future<size_t> future;
+    this->pool->submit(
+      [=]() mutable
+      {
+        ssize_t n;
+        do
+        {
+          if (op == Op::Read)
+            n = pread(fd, buf, len, (off_t)offset);
+          else if (op == Op::Write)
+            n = pwrite(fd, buf, len, (off_t)offset);
+          else
+            n = ::fsync(fd);
+        } while (n < 0 && errno == EINTR);
+
+        if (n < 0)
+          future.setThrow(error(errno, op));
+        else
+          future.setValue((size_t)n);
+        future.finish();
+      });
+    return future.asPromise();
+  }
+
+public:
+  /**
+    * @param queueDepth Maximum amount of requests in flight at once with io_uring
+    * @param fallbackThreads Threads running blocking requests if io_uring is not used
+    * @param backend Preferred backend; io_uring falls back to the thread pool if it is not available
+    */
+  explicit IoService(unsigned queueDepth = DefaultQueueDepth, size_t fallbackThreads = DefaultFallbackThreads,
+                     Backend backend = Backend::IoUring)
+  {
+#if defined(ASYNCFILE_IO_URING)
+    if (backend == Backend::IoUring)
+    {
+      try
+      {
+        this->ring = std::make_unique<Ring>(queueDepth);
+        return;
+      }
+      catch (const std::system_error&)
+      {
+      }
+    }
+#endif
+    this->pool = std::make_unique<ThreadPool>(fallbackThreads);
+  }
+
+  IoService(const IoService&)            = delete;
+  IoService& operator=(const IoService&) = delete;
+
+  Backend getBackend() const
+  {
+    return this->pool ? Backend::ThreadPool : Backend::IoUring;
+  }
+
+  /**
+    * Read up to `len` bytes at `offset` of `fd` into `buf`
+    *
+    * @return Promise of the amount of bytes read, like `pread`; fails with `std::system_error`
+    */
+  Promise<size_t> read(int fd, void * buf, size_t len, uint64_t offset)
+  {
+    return this->submit(Op::Read, fd, buf, len, offset);
+  }
+
+  /**
+    * Write up to `len` bytes from `buf` at `offset` of `fd`
+    *
+    * @return Promise of the amount of bytes written, like `pwrite`; fails with `std::system_error`
+    */
+  Promise<size_t> write(int fd, const void * buf, size_t len, uint64_t offset)
+  {
+    return this->submit(Op::Write, fd, (void *)buf, len, offset);
+  }
+
+  /**
+    * Flush all data written to `fd` to the storage device
+    *
+    * @return Promise finishing with 0 once the data is durable; fails with `std::system_error`
+    */
+  Promise<size_t> fsync(int fd)
+  {
+    return this->submit(Op::Fsync, fd, nullptr, 0, 0);
+  }
+
+  /**
+    * Scope in which requests of all threads are only queued, and handed to the kernel at once when it ends
+    *
+    * Saves one syscall per request when issuing many requests in a row. Batches have no effect on the thread pool
+    * backend.
+    */
+  class Batch
+  {
+  private:
+    IoService& io;
+
+  public:
+    explicit Batch(IoService& io) : io(io)
+    {
+#if defined(ASYNCFILE_IO_URING)
+      if (io.ring)
+        io.ring->beginBatch();
+#endif
+    }
+
+    Batch(const Batch&)            = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    ~Batch()
+    {
+#if defined(ASYNCFILE_IO_URING)
+      if (this->io.ring)
+        this->io.ring->endBatch();
+#endif
+    }
+  };
+};
+
+/**
+  * File opened for asynchronous reads and writes at explicit offsets through an `IoService`
+  */
+class AsyncFile
+{
+private:
+  IoService& io;
+  int        fd;
+
+public:
+  /**
+    * Open the file at `path`
+    *
+    * @param flags Flags for `open`, e.g. `O_RDWR | O_CREAT`
+    * @throws std::system_error If the file cannot be opened
+    */
+  AsyncFile(IoService& io, const char * path, int flags = O_RDONLY, mode_t mode = 0644) :
+      io(io), fd(::open(path, flags | O_CLOEXEC, mode))
+  {
+    if (this->fd < 0)
+      throw std::system_error(errno, std::generic_category(), "Could not open '" + std::string(path) + "'");
+  }
+
+  AsyncFile(IoService& io, const String& path, int flags = O_RDONLY, mode_t mode = 0644) :
+      AsyncFile(io, (const char *)path, flags, mode)
+  {
+  }
+
+  AsyncFile(const AsyncFile&)            = delete;
+  AsyncFile& operator=(const AsyncFile&) = delete;
+
+  /**
+    * @warning All requests on this file must be finished before it is destroyed
+    */
+  ~AsyncFile()
+  {
+    close(this->fd);
+  }
+
+  int getFd() const
+  {
+    return this->fd;
+  }
+
+  uint64_t getSize() const
+  {
+    struct stat st;
+    if (fstat(this->fd, &st) != 0)
+      throw std::system_error(errno, std::generic_category(), "Could not determine file size");
+    return (uint64_t)st.st_size;
+  }
+
+  Promise<size_t> read(void * buf, size_t len, uint64_t offset)
+  {
+    return this->io.read(this->fd, buf, len, offset);
+  }
+
+  Promise<size_t> write(const void * buf, size_t len, uint64_t offset)
+  {
+    return this->io.write(this->fd, buf, len, offset);
+  }
+
+  Promise<size_t> fsync()
+  {
+    return this->io.fsync(this->fd);
+  }
+};
+} // namespace CppUtil
+#endif
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "CharClass.hpp"
+#include "Platform.hpp"
+#include "String.hpp"
+
+#if defined(PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace CppUtil
+{
+/**
+  * Reader splitting a file or pipe into records separated by a delimiter
+  *
+  * Input is read in large blocks into a buffer that is reused for the whole stream, and delimiters are located with
+  * a vectorized search over the whole block. Records are handed out as views into that buffer, so no record is ever copied
+  * unless it straddles two blocks, in which case the unconsumed tail is moved to the front once.
+  *
+  * Views returned by `next()` are only valid until the next call to `next()`.
+  */
+class RecordReader
+{
+public:
+  static constexpr size_t DefaultBufferSize    = 1 << 20;
+  static constexpr size_t DefaultMaxRecordSize = 1 << 20;
+
+private:
+  int  fd;
+  bool ownsFd;
+
+  char   delimiter;
+  size_t maxRecordSize;
+
+  std::unique_ptr<char[]> buffer;
+  size_t                  cap;
+  size_t                  begin = 0; // Start of the first unconsumed byte
+  size_t                  end   = 0; // End of the valid data
+  size_t                  scan  = 0; // Everything in [begin, scan) is known to contain no delimiter
+
+  bool   eof     = false;
+  size_t records = 0;
+
+  static int openFile(const char * path)
+  {
+#if defined(PLATFORM_WINDOWS)
+    int fd = _open(path, _O_RDONLY | _O_BINARY);
+#else
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+#endif
+    if (fd < 0)
+      throw std::system_error(errno, std::generic_category(), "Could not open '" + std::string(path) + "'");
+
+#if defined(PLATFORM_LINUX)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return fd;
+  }
+
+  // Read as much as fits behind `end`, returns false once the input is exhausted
+  bool fill()
+  {
+    if (this->begin > 0)
+    {
+      memmove(this->buffer.get(), this->buffer.get() + this->begin, this->end - this->begin);
+      this->end -= this->begin;
+      this->scan -= this->begin;
+      this->begin = 0;
+    }
+
+    while (true)
+    {
+#if defined(PLATFORM_WINDOWS)
+      auto n =
+        _read(this->fd, this->buffer.get() + this->end, (unsigned)std::min<size_t>(this->cap - this->end, INT_MAX));
+#else
+      auto n = ::read(this->fd, this->buffer.get() + this->end, this->cap - this->end);
+#endif
+      if (n > 0)
+      {
+        this->end += (size_t)n;
+        return true;
+      }
+      if (n == 0)
+        return false;
+      if (errno != EINTR)
+        throw std::system_error(errno, std::generic_category(),
+                                "Could not read record " + std::to_string(this->records));
+    }
+  }
+
+  void checkSize(size_t len) const
+  {
+    if (len > this->maxRecordSize)
+      throw std::length_error("Record " + std::to_string(this->records) + " exceeds the maximum record size of " +
+                              std::to_string(this->maxRecordSize) + " bytes!");
+  }
+
+  RecordReader(int fd, bool ownsFd, char delimiter, size_t maxRecordSize, size_t bufferSize) :
+      fd(fd), ownsFd(ownsFd), delimiter(delimiter), maxRecordSize(maxRecordSize)
+  {
+    if (maxRecordSize == 0)
+      throw std::invalid_argument("Maximum record size must be at least 1!");
+
+    // A full record and its delimiter must fit into the buffer at once
+    this->cap = std::max(bufferSize, maxRecordSize + 1);
+    this->buffer.reset(new char[this->cap]);
+  }
+
+  std::string_view makeRecord(size_t len)
+  {
+    std::string_view record(this->buffer.get() + this->begin, len);
+    if (this->stripCarriageReturn && !record.empty() && record.back() == '\r')
+      record.remove_suffix(1);
+    this->records++;
+    return record;
+  }
+
+protected:
+  // Drop a trailing '\r' from every record, for "\r\n" line endings
+  bool stripCarriageReturn = false;
+
+public:
+  /**
+    * Read records from the file at `path`
+    *
+    * @throws std::system_error If the file cannot be opened
+    */
+  explicit RecordReader(const char * path, char delimiter = '\n', size_t maxRecordSize = DefaultMaxRecordSize,
+                        size_t bufferSize = DefaultBufferSize) :
+      RecordReader(-1, false, delimiter, maxRecordSize, bufferSize)
+  {
+    this->fd     = openFile(path);
+    this->ownsFd = true;
+  }
+
+  explicit RecordReader(const String& path, char delimiter = '\n', size_t maxRecordSize = DefaultMaxRecordSize,
+                        size_t bufferSize = DefaultBufferSize) :
+      RecordReader((const char *)path, delimiter, maxRecordSize, bufferSize)
+  {
+  }
+
+  /**
+    * Read records from the open file descriptor `fd`, e.g. a pipe or `STDIN_FILENO`
+    *
+    * The descriptor is not closed by the reader.
+    */
+  RecordReader(int fd, char delimiter, size_t maxRecordSize = DefaultMaxRecordSize,
+               size_t bufferSize = DefaultBufferSize) :
+      RecordReader(fd, false, delimiter, maxRecordSize, bufferSize)
+  {
+  }
+
+  RecordReader(const RecordReader&)            = delete;
+  RecordReader& operator=(const RecordReader&) = delete;
+
+  virtual ~RecordReader()
+  {
+    if (this->ownsFd)
+    {
+#if defined(PLATFORM_WINDOWS)
+      _close(this->fd);
+#else
+      ::close(this->fd);
+#endif
+    }
+  }
+
+  /**
+    * Advance to the next record, excluding its delimiter
+    *
+    * A final record without a trailing delimiter is reported as well.
+    *
+    * @return false once all records have been read
+    * @throws std::length_error If the record is longer than the maximum record size
+    * @throws std::system_error If reading fails
+    */
+  bool next(std::string_view& record)
+  {
+    while (true)
+    {
+      // A single delimiter byte is what libc's vectorized memchr is tuned for; it beats CharClass on short lines
+      auto found = (const char *)memchr(this->buffer.get() + this->scan, this->delimiter, this->end - this->scan);
+      if (found)
+      {
+        size_t pos = found - this->buffer.get();
+        this->checkSize(pos - this->begin);
+
+        record      = this->makeRecord(pos - this->begin);
+        this->begin = this->scan = pos + 1;
+        return true;
+      }
+
+      this->scan = this->end;
+      this->checkSize(this->end - this->begin);
+
+      if (this->eof || !this->fill())
+      {
+        this->eof = true;
+        if (this->begin == this->end)
+          return false;
+
+        record      = this->makeRecord(this->end - this->begin);
+        this->begin = this->scan = this->end;
+        return true;
+      }
+    }
+  }
+
+  /**
+    * Advance to the next record and split it at `fieldDelimiters` into `fields`
+    *
+    * @see String::splitViews
+    */
+  bool next(const CharSet& fieldDelimiters, DynamicArray<std::string_view>& fields, bool keepEmpty = false)
+  {
+    std::string_view record;
+    if (!this->next(record))
+      return false;
+
+    String::splitViews(record, fieldDelimiters, fields, keepEmpty);
+    return true;
+  }
+
+  /**
+    * Call `f(std::string_view)` for every remaining record
+    *
+    * @return Amount of records visited
+    */
+  template <typename F> size_t foreach (F&& f)
+  {
+    size_t           count = 0;
+    std::string_view record;
+    while (this->next(record))
+    {
+      f(record);
+      count++;
+    }
+    return count;
+  }
+
+  /**
+    * Amount of records read so far
+    */
+  size_t getRecordCount() const
+  {
+    return this->records;
+  }
+
+  char getDelimiter() const
+  {
+    return this->delimiter;
+  }
+
+  size_t getMaxRecordSize() const
+  {
+    return this->maxRecordSize;
+  }
+};
+
+/**
+  * `RecordReader` for text lines, accepting both "\n" and "\r\n" line endings
+  */
+class LineReader : public RecordReader
+{
+public:
+  explicit LineReader(const char * path, size_t maxLineSize = DefaultMaxRecordSize,
+                      size_t bufferSize = DefaultBufferSize) :
+      RecordReader(path, '\n', maxLineSize, bufferSize)
+  {
+    this->stripCarriageReturn = true;
+  }
+
+  explicit LineReader(const String& path, size_t maxLineSize = DefaultMaxRecordSize,
+                      size_t bufferSize = DefaultBufferSize) :
+      RecordReader(path, '\n', maxLineSize, bufferSize)
+  {
+    this->stripCarriageReturn = true;
+  }
+
+  explicit LineReader(int fd, size_t maxLineSize = DefaultMaxRecordSize, size_t bufferSize = DefaultBufferSize) :
+      RecordReader(fd, '\n', maxLineSize, bufferSize)
+  {
+    this->stripCarriageReturn = true;
+  }
+};
+} // namespace CppUtil
@@ -0,0 +1,215 @@
+#include "../src/AsyncFile.hpp"
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+#if defined(PLATFORM_UNIX_LIKE)
+static std::string tempPath(const std::string& name)
+{
+  return (std::filesystem::temp_directory_path() / ("CppUtil_" + name)).string();
+}
+
+TEST_CASE("AsyncFile", "[io][async_file]")
+{
+  auto backend = GENERATE(IoService::Backend::IoUring, IoService::Backend::ThreadPool);
+
+  IoService io(64, 4, backend);
+  auto      path = tempPath("async_file");
+
+  SECTION("Written data can be read back")
+  {
+    AsyncFile file(io, path.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+
+    std::string data = "Hello asynchronous world";
+    REQUIRE(data.size() == file.write(data.data(), data.size(), 100).get());
+    REQUIRE(0 == file.fsync().get());
+    REQUIRE(100 + data.size() == file.getSize());
+
+    std::string buf(data.size(), '\0');
+    REQUIRE(data.size() == file.read(&buf[0], buf.size(), 100).get());
+    REQUIRE(data == buf);
+  }
+
+  SECTION("Reads behind the end of the file are short")
+  {
+    AsyncFile file(io, path.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+    REQUIRE(3 == file.write("abc", 3, 0).get());
+
+    char buf[16];
+    REQUIRE(2 == file.read(buf, sizeof(buf), 1).get());
+    REQUIRE(0 == file.read(buf, sizeof(buf), 10).get());
+  }
+
+  SECTION("Many requests can be in flight at once")
+  {
+    AsyncFile file(io, path.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+
+    // More requests than the queue depth, so submitters have to wait for free slots
+    constexpr size_t             Count = 500;
+    std::vector<uint32_t>        values(Count);
+    std::vector<Promise<size_t>> writes;
+    {
+      IoService::Batch batch(io);
+      for (uint32_t i = 0; i < Count; i++)
+      {
+        values[i] = i * 7;
+        writes.push_back(file.write(&values[i], sizeof(uint32_t), i * sizeof(uint32_t)));
+      }
+    }
+    for (auto& w : writes)
+    {
+      REQUIRE(sizeof(uint32_t) == w.get());
+    }
+
+    std::vector<uint32_t>        read(Count);
+    std::vector<Promise<size_t>> reads;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+      reads.push_back(file.read(&read[i], sizeof(uint32_t), i * sizeof(uint32_t)));
+    }
+    for (auto& r : reads)
+    {
+      REQUIRE(sizeof(uint32_t) == r.get());
+    }
+    REQUIRE(values == read);
+  }
+
+  SECTION("Failed requests throw on get")
+  {
+    AsyncFile file(io, path.c_str(), O_RDONLY | O_CREAT);
+
+    REQUIRE_THROWS_AS(file.write("abc", 3, 0).get(), std::system_error);
+  }
+
+  SECTION("Missing files are rejected")
+  {
+    REQUIRE_THROWS_AS(AsyncFile(io, "/this/file/does/not/exist"), std::system_error);
+  }
+
+  std::filesystem::remove(path);
+}
+
+#if defined(ASYNCFILE_IO_URING)
+static int realEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+  return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+static int errorOf(Promise<size_t>& promise)
+{
+  try
+  {
+    promise.get();
+  }
+  catch (const std::system_error& e)
+  {
+    return e.code().value();
+  }
+  return 0;
+}
+
+TEST_CASE("IoService io_uring failures", "[io][async_file][io_uring]")
+{
+  auto path = tempPath("async_file_failures");
+
+  SECTION("Requests of a batch the kernel refuses fail")
+  {
+    IoService io(64, 4);
+    if (io.getBackend() != IoService::Backend::IoUring)
+      return;
+    AsyncFile file(io, path.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+
+    std::vector<Promise<size_t>> writes;
+    IoService::enterHook = [](int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+    {
+      if (toSubmit == 0)
+        return realEnter(fd, toSubmit, minComplete, flags);
+      errno = EBADF;
+      return -1;
+    };
+    {
+      IoService::Batch batch(io);
+      for (int i = 0; i < 10; i++)
+      {
+        writes.push_back(file.write("abc", 3, i * 3));
+      }
+    }
+    IoService::enterHook = nullptr;
+
+    for (auto& w : writes)
+    {
+      REQUIRE(EBADF == errorOf(w));
+    }
+    REQUIRE(3 == file.write("abc", 3, 0).get());
+  }
+
+  SECTION("Busy submissions are retried a bounded number of times")
+  {
+    IoService io(64, 4);
+    if (io.getBackend() != IoService::Backend::IoUring)
+      return;
+    AsyncFile file(io, path.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+
+    IoService::enterHook = [](int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+    {
+      if (toSubmit == 0)
+        return realEnter(fd, toSubmit, minComplete, flags);
+      errno = EAGAIN;
+      return -1;
+    };
+    auto write = file.write("abc", 3, 0);
+    IoService::enterHook = nullptr;
+
+    REQUIRE(EAGAIN == errorOf(write));
+    REQUIRE(3 == file.write("abc", 3, 0).get());
+  }
+
+  SECTION("Requests fail once completions cannot be waited for")
+  {
+    int  pipeFds[2];
+    char pipeBuf[16];
+    char fileBuf[16];
+    REQUIRE(0 == pipe(pipeFds));
+    {
+      IoService io(64, 4);
+      if (io.getBackend() != IoService::Backend::IoUring)
+      {
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        return;
+      }
+      AsyncFile file(io, path.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+
+      IoService::enterHook = [](int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+      {
+        if (toSubmit > 0)
+          return realEnter(fd, toSubmit, minComplete, flags);
+        errno = EBADF;
+        return -1;
+      };
+
+      // The pipe read stays in flight; the reaper fails once it waits again after the file read
+      auto stuck = io.read(pipeFds[0], pipeBuf, sizeof(pipeBuf), 0);
+      auto done  = file.read(fileBuf, sizeof(fileBuf), 0);
+      REQUIRE(0 == done.get());
+      REQUIRE(EBADF == errorOf(stuck));
+
+      auto later = file.read(fileBuf, sizeof(fileBuf), 0);
+      REQUIRE(EBADF == errorOf(later));
+      IoService::enterHook = nullptr;
+    }
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+  }
+
+  IoService::enterHook = nullptr;
+  std::filesystem::remove(path);
+}
+#endif
+#endif
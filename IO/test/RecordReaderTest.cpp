@@ -0,0 +1,127 @@
+#include "../src/RecordReader.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+static std::string writeTempFile(const std::string& name, const std::string& content)
+{
+  auto          path = (std::filesystem::temp_directory_path() / ("CppUtil_" + name)).string();
+  std::ofstream out(path, std::ios::binary);
+  out << content;
+  return path;
+}
+
+static std::vector<std::string> readAll(RecordReader& reader)
+{
+  std::vector<std::string> res;
+  reader.foreach ([&](std::string_view record) { res.emplace_back(record); });
+  return res;
+}
+
+TEST_CASE("RecordReader", "[io][record_reader]")
+{
+  SECTION("Lines are read with and without a trailing newline")
+  {
+    LineReader a(writeTempFile("lines_a", "first\nsecond\n\nlast\n").c_str());
+    LineReader b(writeTempFile("lines_b", "first\nsecond\n\nlast").c_str());
+
+    std::vector<std::string> expected = {"first", "second", "", "last"};
+    REQUIRE(expected == readAll(a));
+    REQUIRE(expected == readAll(b));
+    REQUIRE(4 == b.getRecordCount());
+  }
+
+  SECTION("Empty files contain no records")
+  {
+    LineReader       reader(writeTempFile("empty", "").c_str());
+    std::string_view record;
+
+    REQUIRE_FALSE(reader.next(record));
+    REQUIRE_FALSE(reader.next(record));
+  }
+
+  SECTION("Carriage returns of CRLF line endings are dropped")
+  {
+    LineReader reader(writeTempFile("crlf", "a\r\nb\r\n").c_str());
+    REQUIRE(std::vector<std::string>{"a", "b"} == readAll(reader));
+  }
+
+  SECTION("Records can use a custom delimiter")
+  {
+    RecordReader reader(writeTempFile("custom", "a\nb;c;;d").c_str(), ';');
+    REQUIRE(std::vector<std::string>{"a\nb", "c", "", "d"} == readAll(reader));
+  }
+
+  SECTION("Records spanning multiple reads are reassembled")
+  {
+    std::string content;
+    for (size_t i = 0; i < 1'000; i++)
+      content += std::string(i % 50, (char)('a' + i % 26)) + "\n";
+
+    // A buffer far smaller than the file forces many refills with records crossing block boundaries
+    LineReader reader(writeTempFile("small_buffer", content).c_str(), 64, 16);
+
+    auto records = readAll(reader);
+    REQUIRE(1'000 == records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+      REQUIRE(std::string(i % 50, (char)('a' + i % 26)) == records[i]);
+    }
+  }
+
+  SECTION("Records exceeding the maximum size are rejected")
+  {
+    LineReader       reader(writeTempFile("too_long", "short\n" + std::string(100, 'x') + "\n").c_str(), 50);
+    std::string_view record;
+
+    REQUIRE(reader.next(record));
+    REQUIRE(record == "short");
+    REQUIRE_THROWS_AS(reader.next(record), std::length_error);
+  }
+
+  SECTION("Records can be split into fields")
+  {
+    RecordReader                   reader(writeTempFile("csv", "1,2,,4\nx,y\n").c_str());
+    DynamicArray<std::string_view> fields;
+
+    REQUIRE(reader.next(CharSet(","), fields, true));
+    REQUIRE(4 == fields.getCount());
+    REQUIRE(fields[2].empty());
+    REQUIRE(fields[3] == "4");
+
+    REQUIRE(reader.next(CharSet(","), fields));
+    REQUIRE(2 == fields.getCount());
+    REQUIRE(fields[1] == "y");
+
+    REQUIRE_FALSE(reader.next(CharSet(","), fields));
+  }
+
+  SECTION("Missing files and invalid sizes are rejected")
+  {
+    REQUIRE_THROWS_AS(LineReader("/this/file/does/not/exist"), std::system_error);
+    REQUIRE_THROWS_AS(RecordReader(writeTempFile("zero", "").c_str(), '\n', 0), std::invalid_argument);
+  }
+
+#if defined(PLATFORM_UNIX_LIKE)
+  SECTION("Records can be read from pipes")
+  {
+    int fds[2];
+    REQUIRE(0 == pipe(fds));
+
+    std::string content = "one\ntwo\nthree";
+    REQUIRE((ssize_t)content.size() == write(fds[1], content.data(), content.size()));
+    close(fds[1]);
+
+    LineReader reader(fds[0]);
+    REQUIRE(std::vector<std::string>{"one", "two", "three"} == readAll(reader));
+    close(fds[0]);
+  }
+#endif
+}
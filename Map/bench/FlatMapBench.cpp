@@ -0,0 +1,114 @@
+#include "Benchmark.hpp"
+#include "FlatMap.hpp"
+#include "Map.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace CppUtil;
+
+static constexpr size_t Lookups = 1'000'000;
+
+// Look up `Lookups` random keys in a map of `n` keys: sorted flat map, hash map and a linear scan over the keys
+template <typename K> static void run(const std::vector<K>& keys, const char * label)
+{
+  size_t         n = keys.size();
+  std::mt19937   rng(11);
+  std::vector<K> queries(Lookups);
+  for (auto& q : queries)
+  {
+    q = keys[rng() % n];
+  }
+
+  std::vector<std::pair<K, size_t>> entries;
+  Map<K, size_t>                    map;
+  DynamicArray<K>                   scanKeys;
+  DynamicArray<size_t>              scanItems;
+  for (size_t i = 0; i < n; i++)
+  {
+    entries.push_back({keys[i], i});
+    map[keys[i]] = i;
+    scanKeys.add(keys[i]);
+    scanItems.add(i);
+  }
+
+  FlatMap<K, size_t> flat;
+  double             batch = Benchmark::measure(
+    [&]
+    {
+      flat = FlatMap<K, size_t>();
+      flat.insertBatch(entries.data(), entries.size());
+    },
+    3);
+  double single = Benchmark::measure(
+    [&]
+    {
+      FlatMap<K, size_t> m;
+      for (const auto& entry : entries)
+      {
+        m[entry.first] = entry.second;
+      }
+      Benchmark::doNotOptimize(m);
+    },
+    3);
+
+  auto lookup = [&](auto&& find)
+  {
+    return Benchmark::measure(
+      [&]
+      {
+        size_t sum = 0;
+        for (const K& q : queries)
+        {
+          sum += find(q);
+        }
+        Benchmark::doNotOptimize(sum);
+      },
+      3);
+  };
+
+  double scanTime = lookup(
+    [&](const K& q)
+    {
+      const K * k = scanKeys.getData();
+      return scanItems[(size_t)(std::find(k, k + n, q) - k)];
+    });
+  double mapTime  = lookup([&](const K& q) { return *map.find(q); });
+  double flatTime = lookup([&](const K& q) { return *flat.find(q); });
+
+  std::string suffix = std::string(", ") + label;
+  Benchmark::report(("FlatMap insertBatch" + suffix).c_str(), batch, n);
+  Benchmark::report(("FlatMap operator[] inserts" + suffix).c_str(), single, n);
+  Benchmark::report(("Linear scan find" + suffix).c_str(), scanTime, Lookups);
+  Benchmark::report(("Map find" + suffix).c_str(), mapTime, Lookups);
+  Benchmark::report(("FlatMap find" + suffix).c_str(), flatTime, Lookups);
+  printf("  speedup vs Map: %.2fx, vs linear scan: %.2fx\n\n", mapTime / flatTime, scanTime / flatTime);
+}
+
+int main()
+{
+  for (size_t n : {16, 256, 1'024})
+  {
+    std::vector<size_t>           ints;
+    std::vector<std::string>      strings;
+    std::vector<std::string_view> views;
+    for (size_t i = 0; i < n; i++)
+    {
+      ints.push_back(i * 7'919);
+      strings.push_back("/api/v1/resource/" + std::to_string(i * 7'919));
+    }
+    for (const auto& s : strings)
+    {
+      views.push_back(s);
+    }
+
+    std::string count = std::to_string(n);
+    run(ints, (count + " integer keys").c_str());
+    run(views, (count + " string keys").c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include "Benchmark.hpp"
+#include "Map.hpp"
+#include "String.hpp"
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace CppUtil;
+
+static constexpr size_t Routes  = 1'000;
+static constexpr size_t Lookups = 1'000'000;
+
+int main()
+{
+  // Routes are looked up as slices of one request buffer, like a router parsing request lines
+  std::string                    buffer;
+  DynamicArray<std::string_view> paths;
+  {
+    DynamicArray<size_t> offsets;
+    for (size_t i = 0; i < Routes; i++)
+    {
+      offsets.add(buffer.size());
+      buffer += "GET /api/v1/resource/" + std::to_string(i * 7'919);
+    }
+    offsets.add(buffer.size());
+    for (size_t i = 0; i < Routes; i++)
+      paths.add(std::string_view(buffer).substr(offsets[i], offsets[i + 1] - offsets[i]));
+  }
+
+  std::mt19937    rng(7);
+  Array<uint32_t> order(Lookups);
+  for (size_t i = 0; i < Lookups; i++)
+    order[i] = rng() % Routes;
+
+  Map<String, size_t>                     map;
+  std::unordered_map<std::string, size_t> ref;
+  DynamicArray<String>                    legacyKeys;
+  for (size_t i = 0; i < Routes; i++)
+  {
+    map[paths[i]]              = i;
+    ref[std::string(paths[i])] = i;
+    legacyKeys.add(String(paths[i]));
+  }
+
+  const std::string_view * p = paths.getData();
+  const uint32_t *         o = order;
+  size_t                   sum;
+
+  // Previous Map: linear scan comparing against a constructed key
+  size_t legacyLookups = Lookups / 100;
+  double legacy        = Benchmark::measure(
+    [&]
+    {
+      sum = 0;
+      for (size_t i = 0; i < legacyLookups; i++)
+      {
+        String key(p[o[i]]);
+        for (size_t j = 0; j < legacyKeys.getCount(); j++)
+        {
+          if (key == legacyKeys[j])
+          {
+            sum += j;
+            break;
+          }
+        }
+      }
+      Benchmark::doNotOptimize(sum);
+    },
+    3);
+  Benchmark::report("linear scan with String key", legacy, legacyLookups);
+
+  double stdMap = Benchmark::measure(
+    [&]
+    {
+      sum = 0;
+      for (size_t i = 0; i < Lookups; i++)
+        sum += ref.find(std::string(p[o[i]]))->second;
+      Benchmark::doNotOptimize(sum);
+    });
+  Benchmark::report("std::unordered_map with std::string key", stdMap, Lookups);
+
+  double view = Benchmark::measure(
+    [&]
+    {
+      sum = 0;
+      for (size_t i = 0; i < Lookups; i++)
+        sum += *map.find(p[o[i]]);
+      Benchmark::doNotOptimize(sum);
+    });
+  Benchmark::report("Map::find with string_view", view, Lookups);
+
+  Array<size_t> hashes(Routes);
+  for (size_t i = 0; i < Routes; i++)
+    hashes[i] = Map<String, size_t>::hash(paths[i]);
+  const size_t * h = hashes;
+
+  double hashed = Benchmark::measure(
+    [&]
+    {
+      sum = 0;
+      for (size_t i = 0; i < Lookups; i++)
+        sum += *map.find(p[o[i]], h[o[i]]);
+      Benchmark::doNotOptimize(sum);
+    });
+  Benchmark::report("Map::find with precomputed hash", hashed, Lookups);
+
+  printf("  speedup vs linear scan: %.0fx, vs std::unordered_map: %.1fx\n", (legacy / legacyLookups) / (view / Lookups),
+         stdMap / view);
+  return 0;
+}
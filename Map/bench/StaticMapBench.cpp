@@ -0,0 +1,79 @@
+#include "Benchmark.hpp"
+#include "Map.hpp"
+#include "StaticMap.hpp"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace CppUtil;
+
+static constexpr size_t Lookups = 1'000'000;
+
+// Look up `Lookups` random keys of `keys` in a fixed map of N string keys, once per map type
+template <size_t N> static void run(const char * label)
+{
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < N; i++)
+  {
+    keys.push_back("/api/v1/resource/" + std::to_string(i * 7'919));
+  }
+
+  std::mt19937                  rng(7);
+  std::vector<std::string_view> queries(Lookups);
+  for (auto& q : queries)
+  {
+    q = keys[rng() % N];
+  }
+
+  static std::pair<std::string_view, size_t>   entries[N];
+  Map<std::string_view, size_t>                map;
+  std::unordered_map<std::string_view, size_t> ref;
+  for (size_t i = 0; i < N; i++)
+  {
+    entries[i]   = {keys[i], i};
+    map[keys[i]] = i;
+    ref[keys[i]] = i;
+  }
+
+  std::unique_ptr<StaticMap<std::string_view, size_t, N>> fixed;
+  double                                                  build =
+    Benchmark::measure([&] { fixed = std::make_unique<StaticMap<std::string_view, size_t, N>>(entries); }, 3);
+
+  auto lookup = [&](auto&& find)
+  {
+    return Benchmark::measure(
+      [&]
+      {
+        size_t sum = 0;
+        for (std::string_view q : queries)
+        {
+          sum += find(q);
+        }
+        Benchmark::doNotOptimize(sum);
+      },
+      3);
+  };
+
+  double refTime    = lookup([&](std::string_view q) { return ref.find(q)->second; });
+  double mapTime    = lookup([&](std::string_view q) { return *map.find(q); });
+  double staticTime = lookup([&](std::string_view q) { return *fixed->find(q); });
+
+  std::string suffix = std::string(", ") + label;
+  Benchmark::report(("StaticMap build" + suffix).c_str(), build, N);
+  Benchmark::report(("std::unordered_map find" + suffix).c_str(), refTime, Lookups);
+  Benchmark::report(("Map find" + suffix).c_str(), mapTime, Lookups);
+  Benchmark::report(("StaticMap find" + suffix).c_str(), staticTime, Lookups);
+  printf("  speedup vs Map: %.2fx\n\n", mapTime / staticTime);
+}
+
+int main()
+{
+  run<64>("64 keys");
+  run<1'000>("1k keys");
+  run<20'000>("20k keys");
+  return 0;
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <utility> // for std::pair
+
+#include "Array.hpp"
+#include "Exception.hpp"
+#include "Map.hpp"
+
+namespace CppUtil
+{
+/**
+  * Maps item U to unique key T, kept sorted by key in two flat arrays
+  *
+  * Lookups are a branchless binary search over the contiguous keys, with no buckets or index beside the entries. For
+  * small and read-mostly maps this is much faster than a linear scan and about as fast as `Map` for integer keys;
+  * string keys pay a full comparison per step, so `Map` stays faster for them. Single inserts and removals shift the
+  * following entries, so fill the map with the constructor or `insertBatch`, which sort the new entries and merge
+  * them in one pass. Iteration is in key order.
+  *
+  * This is a separate class rather than a mode of `Map`, as `Map` keeps its entries in insertion order and its hash
+  * index refers to them by position, which sorting would invalidate.
+  *
+  * String-like keys are ordered and looked up by their characters and can be searched by any string-like type, like
+  * `Map`. Other keys are ordered by `operator<`.
+  */
+template <typename T, typename U> class FlatMap
+{
+private:
+  static constexpr size_t npos = (size_t)-1;
+
+  DynamicArray<T> t;
+  DynamicArray<U> u;
+
+  template <typename K> static constexpr bool isTransparent = MapKey::isStringLike<T>&& MapKey::isStringLike<K>;
+  template <typename K> static constexpr bool isKey         = isTransparent<K> || std::is_convertible_v<const K&, T>;
+  template <typename K> using EnableKey                     = std::enable_if_t<isKey<K>, int>;
+
+  template <typename K> static decltype(auto) lookupKey(const K& key)
+  {
+    if constexpr (isTransparent<K> || std::is_same_v<K, T>)
+      return key;
+    else
+      return T(key);
+  }
+
+  template <typename A, typename B> static bool less(const A& a, const B& b)
+  {
+    if constexpr (MapKey::isStringLike<A> && MapKey::isStringLike<B>)
+      return MapKey::view(a) < MapKey::view(b);
+    else
+      return a < b;
+  }
+
+  template <typename A, typename B> static bool equal(const A& a, const B& b)
+  {
+    if constexpr (MapKey::isStringLike<A> && MapKey::isStringLike<B>)
+      return MapKey::view(a) == MapKey::view(b);
+    else
+      return a == b;
+  }
+
+  // Index of the first key not less than `key`; the loop has no data dependent branch, so it compiles to cmov
+  template <typename K> size_t lowerBound(const K& key) const
+  {
+    size_t len = this->t.getCount();
+    if (len == 0)
+      return 0;
+
+    const T * keys = this->t.getData();
+    const T * base = keys;
+    while (len > 1)
+    {
+      size_t half = len / 2;
+      base        = less(base[half], key) ? base + half : base;
+      len -= half;
+    }
+    return (size_t)(base - keys) + less(*base, key);
+  }
+
+  template <typename K> size_t findIdx(const K& key) const
+  {
+    size_t idx = this->lowerBound(key);
+    return idx < this->t.getCount() && equal(this->t.getData()[idx], key) ? idx : npos;
+  }
+
+public:
+  FlatMap() = default;
+
+  /**
+    * Sort `list` once; of duplicate keys the last entry wins
+    */
+  FlatMap(std::initializer_list<std::pair<const T, U>> list)
+  {
+    this->insertBatch(list);
+  }
+
+  /**
+    * Insert or overwrite the `n` entries at `entries` by sorting them and merging them with the map in one pass
+    *
+    * Takes O(m + n log n) for a map of m entries, instead of O(m * n) for `n` single inserts. Of duplicate keys the
+    * last entry wins.
+    *
+    * @throws `invalid_argument` if `entries` is a nullpointer
+    */
+  template <typename P> void insertBatch(const P * entries, size_t n)
+  {
+    if (entries == nullptr)
+    {
+      if (n == 0)
+        return;
+      throw std::invalid_argument("Buffer must not be a nullpointer!");
+    }
+
+    // Sort indices instead of the entries, keeping equal keys in insertion order
+    Array<size_t> order(n);
+    size_t *      o = order;
+    for (size_t i = 0; i < n; i++)
+    {
+      o[i] = i;
+    }
+    std::stable_sort(o, o + n, [&](size_t a, size_t b) { return less(entries[a].first, entries[b].first); });
+
+    size_t          count = this->t.getCount();
+    DynamicArray<T> keys(count + n);
+    DynamicArray<U> items(count + n);
+    const T *       oldKeys  = this->t.getData();
+    const U *       oldItems = this->u.getData();
+
+    size_t i = 0;
+    for (size_t j = 0; j < n; j++)
+    {
+      // Skip all but the last of equal batch keys
+      const auto& entry = entries[o[j]];
+      if (j + 1 < n && !less(entry.first, entries[o[j + 1]].first))
+        continue;
+
+      while (i < count && less(oldKeys[i], entry.first))
+      {
+        keys.add(oldKeys[i]);
+        items.add(oldItems[i]);
+        i++;
+      }
+      if (i < count && !less(entry.first, oldKeys[i]))
+        i++;
+
+      keys.add(T(entry.first));
+      items.add(U(entry.second));
+    }
+    for (; i < count; i++)
+    {
+      keys.add(oldKeys[i]);
+      items.add(oldItems[i]);
+    }
+
+    this->t = std::move(keys);
+    this->u = std::move(items);
+  }
+
+  void insertBatch(std::initializer_list<std::pair<const T, U>> list)
+  {
+    this->insertBatch(list.begin(), list.size());
+  }
+
+  /**
+    * Get item U correspinding to `key`
+    *
+    * Adds `key` and a new item U at its sorted position if key is not found
+    */
+  template <typename K, EnableKey<K> = 0> U& operator[](const K& key)
+  {
+    const auto& k   = lookupKey(key);
+    size_t      idx = this->lowerBound(k);
+    if (idx == this->t.getCount() || !equal(this->t.getData()[idx], k))
+    {
+      if constexpr (std::is_constructible_v<T, decltype(k)>)
+        this->t.add(T(k), idx);
+      else
+        this->t.add(T(std::string(MapKey::view(k))), idx);
+      this->u.add(U(), idx);
+    }
+    return this->u[idx];
+  }
+
+  /**
+    * Item U corresponding to `key`, or `nullptr` if the key is not found
+    */
+  template <typename K, EnableKey<K> = 0> U * find(const K& key)
+  {
+    size_t idx = this->findIdx(lookupKey(key));
+    return idx == npos ? nullptr : &this->u[idx];
+  }
+
+  template <typename K, EnableKey<K> = 0> const U * find(const K& key) const
+  {
+    size_t idx = this->findIdx(lookupKey(key));
+    return idx == npos ? nullptr : this->u.getData() + idx;
+  }
+
+  template <typename K, EnableKey<K> = 0> bool contains(const K& key) const
+  {
+    return this->find(key) != nullptr;
+  }
+
+  /**
+    * Get item U corresponding to `key`
+    *
+    * @throws not_found
+    */
+  template <typename K, EnableKey<K> = 0> U& tryGetItem(const K& key)
+  {
+    U * item = this->find(key);
+    if (item == nullptr)
+      throw not_found("Cannot get item of nonexistant key '" + MapKey::toString(key) + "'!");
+    return *item;
+  }
+
+  /**
+    * Set item U correspinding to `key` to `item`
+    *
+    * @throws not_found
+    */
+  template <typename K, EnableKey<K> = 0> void trySetItem(const K& key, const U& item)
+  {
+    this->tryGetItem(key) = item;
+  }
+
+  /**
+    * Remove item U correspinding to `key`, shifting the following entries
+    *
+    * @throws not_found
+    */
+  template <typename K, EnableKey<K> = 0> void tryRemoveItem(const K& key)
+  {
+    size_t idx = this->findIdx(lookupKey(key));
+    if (idx == npos)
+      throw not_found("Cannot remove item of nonexistant key '" + MapKey::toString(key) + "'!");
+
+    this->t.remove(idx);
+    this->u.remove(idx);
+  }
+
+  size_t getCount() const
+  {
+    return this->t.getCount();
+  }
+
+  /**
+    * Call `f(key, item)` for every entry, in key order
+    */
+  template <typename func> void foreach (func&& f) const
+  {
+    const T * keys  = this->t.getData();
+    const U * items = this->u.getData();
+    for (size_t i = 0; i < this->t.getCount(); i++)
+    {
+      f(keys[i], items[i]);
+    }
+  }
+};
+} // namespace CppUtil
@@ -1,21 +1,200 @@
 #pragma once
 
+#include <functional>
 #include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility> // for std::pair
 
 #include "Array.hpp"
 #include "Exception.hpp"
+#include "Hash.hpp"
 
 namespace CppUtil
 {
+/**
+  * Hashing and equality of `Map` keys
+  *
+  * Keys are hashed by `Hasher<K>` if it supports them, and by `std::hash<K>` otherwise. String-like keys, i.e. anything
+  * convertible to `std::string_view` or providing `view()` like `String`, are hashed and compared by their
+  * characters. This makes them interchangeable: a `Map<String, U>` can be searched with a `const char*`,
+  * `std::string` or `std::string_view` without constructing a `String`.
+  */
+struct MapKey
+{
+  template <typename K, typename = void> struct HasView : std::false_type
+  {
+  };
+
+  template <typename K>
+  struct HasView<K, std::void_t<decltype(std::string_view(std::declval<const K&>().view()))>> : std::true_type
+  {
+  };
+
+  template <typename K>
+  static constexpr bool isStringLike = HasView<K>::value || std::is_convertible_v<const K&, std::string_view>;
+
+  template <typename K> static constexpr std::string_view view(const K& key)
+  {
+    if constexpr (HasView<K>::value)
+      return key.view();
+    else
+      return std::string_view(key);
+  }
+
+  /**
+    * Whether keys of type K can be hashed, either by `Hasher<K>` or by `std::hash<K>`
+    */
+  template <typename K>
+  static constexpr bool canHash = isHashable<K> || std::is_default_constructible_v<std::hash<K>>;
+
+  template <typename K> static size_t hash(const K& key)
+  {
+    if constexpr (isHashable<K>)
+      return Hasher<K>()(key);
+    else
+      return std::hash<K>()(key);
+  }
+
+  template <typename K> static std::string toString(const K& key)
+  {
+    if constexpr (isStringLike<K>)
+      return std::string(view(key));
+    else if constexpr (std::is_arithmetic_v<K>)
+      return std::to_string(key);
+    else
+      return "?";
+  }
+};
+
 /**
   * Maps item U to unique key T
+  *
+  * Entries are kept in insertion order and indexed by an open addressing hash table, so lookups take O(1) instead of
+  * scanning all keys. String-like keys can be looked up by any other string-like type (see `MapKey`), and the hash
+  * of a key searched repeatedly can be computed once with `Map::hash` and passed to `find`, `contains` and
+  * `tryGetItem`.
+  *
+  * Keys that can not be hashed (see `MapKey::canHash`) only need `==`, they are found by scanning all keys.
   */
 template <typename T, typename U> class Map
 {
 private:
-  DynamicArray<T> t;
-  DynamicArray<U> u;
+  static constexpr size_t npos    = (size_t)-1;
+  static constexpr bool   indexed = MapKey::canHash<T>;
+
+  DynamicArray<T>      t;
+  DynamicArray<U>      u;
+  DynamicArray<size_t> hashes;
+  Array<size_t>        slots; // Index of the entry + 1, 0 for empty slots
+  unsigned             shift = 64;
+
+  // Keys of other types are only used as-is if both are string-like, others are converted to T
+  template <typename K> static constexpr bool isTransparent = MapKey::isStringLike<T>&& MapKey::isStringLike<K>;
+  template <typename K> static constexpr bool isKey         = isTransparent<K> || std::is_convertible_v<const K&, T>;
+  template <typename K> using EnableKey                     = std::enable_if_t<isKey<K>, int>;
+
+  template <typename K> static decltype(auto) lookupKey(const K& key)
+  {
+    if constexpr (isTransparent<K> || std::is_same_v<K, T>)
+      return key;
+    else
+      return T(key);
+  }
+
+  template <typename K> static bool equal(const T& stored, const K& key)
+  {
+    if constexpr (isTransparent<K> && !std::is_same_v<K, T>)
+      return MapKey::view(stored) == MapKey::view(key);
+    else
+      return key == stored;
+  }
+
+  template <typename K> static size_t hashOf(const K& key)
+  {
+    if constexpr (indexed)
+      return MapKey::hash(key);
+    else
+      return 0;
+  }
+
+  size_t slotOf(size_t hash) const
+  {
+    // Fibonacci hashing spreads weak `std::hash` results like the identity hash of pointers over all slots
+    return (size_t)((hash * 0x9E3779B97F4A7C15ull) >> this->shift);
+  }
+
+  void link(size_t idx)
+  {
+    size_t * s    = this->slots;
+    size_t   mask = this->slots.getSize() - 1;
+    size_t   pos  = this->slotOf(this->hashes.getData()[idx]);
+    while (s[pos] != 0)
+    {
+      pos = (pos + 1) & mask;
+    }
+    s[pos] = idx + 1;
+  }
+
+  void rehash(unsigned bits)
+  {
+    this->slots = Array<size_t>((size_t)1 << bits);
+    this->shift = 64 - bits;
+    for (size_t i = 0; i < this->t.getCount(); i++)
+    {
+      this->link(i);
+    }
+  }
+
+  template <typename K> size_t findIdx(const K& key, size_t hash) const
+  {
+    if (this->t.getCount() == 0)
+      return npos;
+
+    if constexpr (!indexed)
+    {
+      const T * keys = this->t.getData();
+      for (size_t i = 0; i < this->t.getCount(); i++)
+      {
+        if (equal(keys[i], key))
+          return i;
+      }
+      return npos;
+    }
+
+    const size_t * s    = this->slots;
+    const size_t * h    = this->hashes.getData();
+    const T *      keys = this->t.getData();
+    size_t         mask = this->slots.getSize() - 1;
+    for (size_t pos = this->slotOf(hash);; pos = (pos + 1) & mask)
+    {
+      size_t entry = s[pos];
+      if (entry == 0)
+        return npos;
+      if (h[entry - 1] == hash && equal(keys[entry - 1], key))
+        return entry - 1;
+    }
+  }
+
+  void addEntry(T key, U item, size_t hash)
+  {
+    if constexpr (!indexed)
+    {
+      this->t.add(std::move(key));
+      this->u.add(std::move(item));
+      return;
+    }
+
+    // Keep the table at most half full
+    if (2 * (this->t.getCount() + 1) > this->slots.getSize())
+      this->rehash(this->slots.getSize() == 0 ? 3 : 65 - this->shift);
+
+    this->t.add(std::move(key));
+    this->u.add(std::move(item));
+    this->hashes.add(hash);
+    this->link(this->t.getCount() - 1);
+  }
 
 public:
   Map() : t(), u() {}
@@ -24,83 +203,183 @@ public:
   {
     for (const auto& item : list)
     {
-      t.add(item.first);
-      u.add(item.second);
+      this->addEntry(item.first, item.second, hashOf(item.first));
     }
   }
 
+  Map(const Map& other)            = default;
+  Map& operator=(const Map& other) = default;
+
   /**
-    * Get item U correspinding to `key`
-    * 
-    * Adds `key` and a new item U if key is not found
+    * Take over the entries of `other`, leaving it empty
     */
-  U& operator[](const T& key)
+  Map(Map&& other) noexcept
+    : t(std::move(other.t)), u(std::move(other.u)), hashes(std::move(other.hashes)), slots(std::move(other.slots)),
+      shift(other.shift)
   {
-    for (size_t i = 0; i < t.getCount(); i++)
+    other.shift = 64;
+  }
+
+  Map& operator=(Map&& other) noexcept
+  {
+    if (&other != this)
     {
-      if (key == t[i])
-      {
-        return u[i];
-      }
+      this->t      = std::move(other.t);
+      this->u      = std::move(other.u);
+      this->hashes = std::move(other.hashes);
+      // Take the table out of `other` first, so it does not keep the stale slots of this map
+      this->slots = Array<size_t>(std::move(other.slots));
+      this->shift = other.shift;
+      other.shift = 64;
     }
+    return *this;
+  }
+
+  /**
+    * Hash of `key` as used by this map, to be passed to lookups of the same key
+    *
+    * Always 0 for keys that can not be hashed.
+    */
+  template <typename K, EnableKey<K> = 0> static size_t hash(const K& key)
+  {
+    return hashOf(lookupKey(key));
+  }
+
+  /**
+    * Get item U correspinding to `key`
+    *
+    * Adds `key` and a new item U if key is not found
+    */
+  template <typename K, EnableKey<K> = 0> U& operator[](const K& key)
+  {
+    const auto& k    = lookupKey(key);
+    size_t      hash = hashOf(k);
+    size_t      idx  = this->findIdx(k, hash);
+    if (idx != npos)
+      return this->u[idx];
 
-    t.add(key);
-    u.add(U());
-    return u[u.getCount() - 1];
+    if constexpr (std::is_constructible_v<T, decltype(k)>)
+      this->addEntry(T(k), U(), hash);
+    else
+      this->addEntry(T(std::string(MapKey::view(k))), U(), hash);
+    return this->u[this->u.getCount() - 1];
+  }
+
+  /**
+    * Item U corresponding to `key`, or `nullptr` if the key is not found
+    *
+    * @param hash Precomputed `Map::hash(key)`
+    */
+  template <typename K, EnableKey<K> = 0> U * find(const K& key, size_t hash)
+  {
+    size_t idx = this->findIdx(lookupKey(key), hash);
+    return idx == npos ? nullptr : &this->u[idx];
+  }
+
+  template <typename K, EnableKey<K> = 0> const U * find(const K& key, size_t hash) const
+  {
+    size_t idx = this->findIdx(lookupKey(key), hash);
+    return idx == npos ? nullptr : this->u.getData() + idx;
+  }
+
+  template <typename K, EnableKey<K> = 0> U * find(const K& key)
+  {
+    return this->find(key, hash(key));
+  }
+
+  template <typename K, EnableKey<K> = 0> const U * find(const K& key) const
+  {
+    return this->find(key, hash(key));
+  }
+
+  template <typename K, EnableKey<K> = 0> bool contains(const K& key, size_t hash) const
+  {
+    return this->find(key, hash) != nullptr;
+  }
+
+  template <typename K, EnableKey<K> = 0> bool contains(const K& key) const
+  {
+    return this->find(key) != nullptr;
   }
 
   /**
     * Get item U corresponding to `key`
-    * 
+    *
+    * @param hash Precomputed `Map::hash(key)`
     * @throws not_found
     */
-  U& tryGetItem(const T& key)
+  template <typename K, EnableKey<K> = 0> U& tryGetItem(const K& key, size_t hash)
   {
-    for (size_t i = 0; i < t.getCount(); i++)
-    {
-      if (key == t[i])
-      {
-        return u[i];
-      }
-    }
-    throw not_found("Cannot get item of nonexistant key '" + key + "'!");
+    U * item = this->find(key, hash);
+    if (item == nullptr)
+      throw not_found("Cannot get item of nonexistant key '" + MapKey::toString(key) + "'!");
+    return *item;
+  }
+
+  /**
+    * Get item U corresponding to `key`
+    *
+    * @throws not_found
+    */
+  template <typename K, EnableKey<K> = 0> U& tryGetItem(const K& key)
+  {
+    return this->tryGetItem(key, hash(key));
   }
 
   /**
     * Set item U correspinding to `key` to `item`
-    * 
+    *
     * @throws not_found
     */
-  void trySetItem(const T& key, const U& item)
+  template <typename K, EnableKey<K> = 0> void trySetItem(const K& key, const U& item)
   {
-    for (size_t i = 0; i < t.getCount(); i++)
-    {
-      if (key == t[i])
-      {
-        u[i] = item;
-        return;
-      }
-    }
-    throw not_found("Cannot set item of nonexistant key '" + key + "'!");
+    U * old = this->find(key);
+    if (old == nullptr)
+      throw not_found("Cannot set item of nonexistant key '" + MapKey::toString(key) + "'!");
+    *old = item;
   }
 
   /**
     * Remove item U correspinding to `key`
-    * 
+    *
+    * Following entries move up to keep the insertion order, so the index is rebuilt in O(n).
+    *
     * @throws not_found
     */
-  void tryRemoveItem(const T& key)
+  template <typename K, EnableKey<K> = 0> void tryRemoveItem(const K& key)
+  {
+    const auto& k   = lookupKey(key);
+    size_t      idx = this->findIdx(k, hashOf(k));
+    if (idx == npos)
+      throw not_found("Cannot remove item of nonexistant key '" + MapKey::toString(key) + "'!");
+
+    this->t.remove(idx);
+    this->u.remove(idx);
+    if constexpr (indexed)
+    {
+      this->hashes.remove(idx);
+      this->rehash(64 - this->shift);
+    }
+  }
+
+  size_t getCount() const
+  {
+    return t.getCount();
+  }
+
+  /**
+    * Call `f(key, item)` for every entry, in insertion order
+    *
+    * Lets generic code read all entries, e.g. `String::replaceAll` taking a `Map<String, String>`.
+    */
+  template <typename func> void foreach (func&& f) const
   {
+    const T * keys  = t.getData();
+    const U * items = u.getData();
     for (size_t i = 0; i < t.getCount(); i++)
     {
-      if (key == t[i])
-      {
-        t.remove(i);
-        u.remove(i);
-        return;
-      }
+      f(keys[i], items[i]);
     }
-    throw not_found("Cannot remove item of nonexistant key '" + key + "'!");
   }
 };
-} // namespace CppUtil
\ No newline at end of file
+} // namespace CppUtil
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility> // for std::pair
+
+#include "Exception.hpp"
+#include "Hash.hpp"
+#include "Map.hpp"
+
+namespace CppUtil
+{
+/**
+  * Immutable map of `N` entries, indexed by a minimal perfect hash
+  *
+  * The hash is built once from the key set with the PTHash construction: keys are hashed into buckets of about four
+  * keys, and for every bucket, largest first, a "pilot" value is searched that moves all of its keys to free slots.
+  * Entries are stored in flat arrays at their slot, so a lookup hashes the key once, reads the pilot of its bucket and
+  * compares a single stored key; there is no probing.
+  *
+  * String-like keys (see `MapKey`) and integer or enum keys are hashed during compilation, so a map of e.g.
+  * `std::string_view` keys and literal values can be built as a `constexpr` with `makeStaticMap`. Maps with other
+  * key or value types are built at runtime. Lookups accept any string-like type for string-like keys, like `Map`.
+  *
+  * @warning The hash is built on the stack, which takes about 40 bytes per entry. Use `Map` for large key sets.
+  */
+template <typename T, typename U, size_t N> class StaticMap
+{
+  static_assert(N > 0, "StaticMap needs at least one entry!");
+  static_assert(N <= UINT32_MAX, "StaticMap supports up to 2^32 - 1 entries!");
+
+private:
+  // About four keys per bucket keeps the pilot search short while needing few pilots
+  static constexpr size_t BucketCount = (N + 3) / 4;
+  static constexpr size_t MaxAttempts = 64;
+
+  template <typename K> static constexpr bool isTransparent = MapKey::isStringLike<T>&& MapKey::isStringLike<K>;
+  template <typename K> static constexpr bool isKey         = isTransparent<K> || std::is_convertible_v<const K&, T>;
+  template <typename K> using EnableKey                     = std::enable_if_t<isKey<K>, int>;
+
+  static_assert(MapKey::isStringLike<T> || std::is_integral_v<T> || std::is_enum_v<T>,
+                "StaticMap keys must be string-like, integers or enums!");
+
+  T        keys[N]             = {};
+  U        values[N]           = {};
+  uint32_t pilots[BucketCount] = {};
+  uint64_t seed                = 0;
+
+  // The same hash during compilation and at runtime, see `Hash::constString`
+  template <typename K, bool Compile> static constexpr uint64_t hashOf(const K& key, uint64_t seed)
+  {
+    if constexpr (MapKey::isStringLike<K> && Compile)
+      return Hash::constString(MapKey::view(key), seed);
+    else if constexpr (MapKey::isStringLike<K>)
+      return Hash::string(MapKey::view(key), seed);
+    else if constexpr (std::is_enum_v<K>)
+      return Hash::integer((uint64_t)(std::underlying_type_t<K>)key, seed);
+    else
+      return Hash::integer((uint64_t)key, seed);
+  }
+
+  static constexpr size_t bucketOf(uint64_t hash)
+  {
+    return (size_t)(((hash & 0xFFFFFFFF) * BucketCount) >> 32);
+  }
+
+  static constexpr size_t slotOf(uint64_t hash, uint32_t pilot)
+  {
+    return (size_t)(((Hash::combine(hash, pilot) >> 32) * N) >> 32);
+  }
+
+  template <typename K> static decltype(auto) lookupKey(const K& key)
+  {
+    if constexpr (isTransparent<K> || std::is_same_v<K, T>)
+      return key;
+    else
+      return T(key);
+  }
+
+  template <typename K> static constexpr bool equal(const T& stored, const K& key)
+  {
+    if constexpr (isTransparent<K>)
+      return MapKey::view(stored) == MapKey::view(key);
+    else
+      return stored == T(key);
+  }
+
+  // Search pilots for all buckets with hash seed `s`, false if some bucket's keys collide in their full hash
+  constexpr bool build(const std::pair<T, U> (&entries)[N], uint64_t s, size_t (&slots)[N])
+  {
+    uint64_t hashes[N]                    = {};
+    size_t   bucketStart[BucketCount + 1] = {};
+    size_t   byBucket[N]                  = {};
+    size_t   order[BucketCount]           = {};
+    size_t   sizeCount[N + 1]             = {};
+    bool     taken[N]                     = {};
+
+    // Group keys by bucket with a counting sort
+    for (size_t i = 0; i < N; i++)
+    {
+      hashes[i] = hashOf<T, true>(entries[i].first, s);
+      bucketStart[bucketOf(hashes[i]) + 1]++;
+    }
+    for (size_t b = 0; b < BucketCount; b++)
+    {
+      bucketStart[b + 1] += bucketStart[b];
+    }
+    size_t fill[BucketCount] = {};
+    for (size_t i = 0; i < N; i++)
+    {
+      size_t b                             = bucketOf(hashes[i]);
+      byBucket[bucketStart[b] + fill[b]++] = i;
+    }
+
+    // Place the largest buckets first, while most slots are free
+    for (size_t b = 0; b < BucketCount; b++)
+    {
+      sizeCount[bucketStart[b + 1] - bucketStart[b]]++;
+    }
+    size_t used = 0;
+    for (size_t size = N; size > 0; size--)
+    {
+      size_t count    = sizeCount[size];
+      sizeCount[size] = used;
+      used += count;
+    }
+    for (size_t b = 0; b < BucketCount; b++)
+    {
+      size_t size = bucketStart[b + 1] - bucketStart[b];
+      if (size > 0)
+        order[sizeCount[size]++] = b;
+    }
+
+    for (size_t o = 0; o < used; o++)
+    {
+      size_t b     = order[o];
+      size_t begin = bucketStart[b];
+      size_t end   = bucketStart[b + 1];
+
+      for (size_t i = begin; i < end; i++)
+      {
+        for (size_t j = begin; j < i; j++)
+        {
+          if (hashes[byBucket[i]] == hashes[byBucket[j]])
+          {
+            if (equal(entries[byBucket[i]].first, entries[byBucket[j]].first))
+              throw std::invalid_argument("StaticMap keys must be unique!");
+            return false;
+          }
+        }
+      }
+
+      for (uint32_t pilot = 0;; pilot++)
+      {
+        size_t placed = begin;
+        for (; placed < end; placed++)
+        {
+          size_t slot = slotOf(hashes[byBucket[placed]], pilot);
+          if (taken[slot])
+            break;
+          taken[slot]             = true;
+          slots[byBucket[placed]] = slot;
+        }
+
+        if (placed == end)
+        {
+          this->pilots[b] = pilot;
+          break;
+        }
+
+        // Keys of the same bucket may have collided with each other, release the slots taken by this attempt
+        for (size_t i = begin; i < placed; i++)
+        {
+          taken[slots[byBucket[i]]] = false;
+        }
+      }
+    }
+    return true;
+  }
+
+public:
+  /**
+    * @throws `invalid_argument` if a key appears more than once
+    */
+  constexpr explicit StaticMap(const std::pair<T, U> (&entries)[N])
+  {
+    size_t slots[N] = {};
+    for (size_t attempt = 0;; attempt++)
+    {
+      // Full hash collisions within a bucket are astronomically unlikely, but could never be separated by a pilot
+      if (attempt == MaxAttempts)
+        throw std::invalid_argument("Cannot build a perfect hash for the StaticMap keys!");
+
+      this->seed = Hash::integer(attempt);
+      if (this->build(entries, this->seed, slots))
+        break;
+    }
+
+    for (size_t i = 0; i < N; i++)
+    {
+      this->keys[slots[i]]   = entries[i].first;
+      this->values[slots[i]] = entries[i].second;
+    }
+  }
+
+  /**
+    * Item U corresponding to `key`, or `nullptr` if the key is not found
+    */
+  template <typename K, EnableKey<K> = 0> const U * find(const K& key) const
+  {
+    const auto& k    = lookupKey(key);
+    uint64_t    hash = hashOf<std::decay_t<decltype(k)>, false>(k, this->seed);
+    size_t      slot = slotOf(hash, this->pilots[bucketOf(hash)]);
+    return equal(this->keys[slot], k) ? &this->values[slot] : nullptr;
+  }
+
+  template <typename K, EnableKey<K> = 0> bool contains(const K& key) const
+  {
+    return this->find(key) != nullptr;
+  }
+
+  /**
+    * Get item U corresponding to `key`
+    *
+    * @throws not_found
+    */
+  template <typename K, EnableKey<K> = 0> const U& tryGetItem(const K& key) const
+  {
+    const U * item = this->find(key);
+    if (item == nullptr)
+      throw not_found("Cannot get item of nonexistant key '" + MapKey::toString(key) + "'!");
+    return *item;
+  }
+
+  static constexpr size_t getCount()
+  {
+    return N;
+  }
+
+  /**
+    * Call `f(key, item)` for every entry, in slot order
+    */
+  template <typename func> void foreach (func&& f) const
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      f(this->keys[i], this->values[i]);
+    }
+  }
+};
+
+/**
+  * Build a `StaticMap` from a list of entries, deducing its size
+  *
+  * `constexpr auto Keywords = makeStaticMap<std::string_view, int>({{"select", 1}, {"from", 2}});`
+  *
+  * @throws `invalid_argument` if a key appears more than once
+  */
+template <typename T, typename U, size_t N>
+constexpr StaticMap<T, U, N> makeStaticMap(const std::pair<T, U> (&entries)[N])
+{
+  return StaticMap<T, U, N>(entries);
+}
+} // namespace CppUtil
@@ -0,0 +1,94 @@
+#include "FlatMap.hpp"
+#include "String.hpp"
+
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("FlatMap keeps entries sorted", "[flat_map][order]")
+{
+  FlatMap<String, int> map{{"delta", 4}, {"alpha", 1}, {"charlie", 3}, {"alpha", 10}};
+  REQUIRE(3 == map.getCount());
+  REQUIRE(10 == map.tryGetItem("alpha"));
+
+  map["bravo"] = 2;
+  map["echo"]  = 5;
+  map["delta"] = 40;
+
+  std::string order;
+  map.foreach ([&](const String& key, int) { order += key.view().substr(0, 1); });
+  REQUIRE("abcde" == order);
+  REQUIRE(40 == *map.find(std::string_view("delta")));
+
+  SECTION("Lookups by any string-like type")
+  {
+    REQUIRE(map.contains("charlie"));
+    REQUIRE(map.contains(std::string("echo")));
+    REQUIRE(map.contains(String("bravo")));
+    REQUIRE_FALSE(map.contains("foxtrot"));
+    REQUIRE_FALSE(map.contains(""));
+    REQUIRE_FALSE(map.contains("zulu"));
+  }
+
+  SECTION("Setting and removing items")
+  {
+    map.trySetItem("echo", 50);
+    REQUIRE(50 == map.tryGetItem("echo"));
+    map.tryRemoveItem("alpha");
+    REQUIRE_FALSE(map.contains("alpha"));
+    REQUIRE(4 == map.getCount());
+    REQUIRE(2 == map.tryGetItem("bravo"));
+
+    REQUIRE_THROWS_AS(map.tryGetItem("alpha"), not_found);
+    REQUIRE_THROWS_AS(map.trySetItem("alpha", 1), not_found);
+    REQUIRE_THROWS_AS(map.tryRemoveItem("alpha"), not_found);
+  }
+}
+
+TEST_CASE("FlatMap batch inserts match single inserts", "[flat_map][batch]")
+{
+  std::mt19937       rng(3);
+  FlatMap<int, int>  map;
+  std::map<int, int> ref;
+  for (int round = 0; round < 20; round++)
+  {
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < 50; i++)
+    {
+      batch.push_back({(int)(rng() % 500), round * 100 + i});
+    }
+
+    map.insertBatch(batch.data(), batch.size());
+    for (const auto& entry : batch)
+    {
+      ref[entry.first] = entry.second;
+    }
+  }
+
+  REQUIRE(ref.size() == map.getCount());
+  auto it = ref.begin();
+  map.foreach (
+    [&](int key, int item)
+    {
+      REQUIRE(it->first == key);
+      REQUIRE(it->second == item);
+      ++it;
+    });
+
+  for (int key = -1; key <= 500; key++)
+  {
+    REQUIRE(ref.count(key) == (size_t)map.contains(key));
+  }
+
+  map.insertBatch({{-5, 1}, {1'000, 2}});
+  REQUIRE(1 == map.tryGetItem(-5));
+  REQUIRE(2 == map.tryGetItem(1'000));
+  REQUIRE_THROWS_AS(map.insertBatch((const std::pair<int, int> *)nullptr, 1), std::invalid_argument);
+}
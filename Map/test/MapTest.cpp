@@ -1,4 +1,8 @@
 #include "Map.hpp"
+#include "String.hpp"
+
+#include <string>
+#include <string_view>
 
 #include "CatchVer.hpp"
 
@@ -75,4 +79,220 @@ TEST_CASE("Map can be initialized with initializer list", "[initialize]")
       REQUIRE(m["1,2"] == 1.2);
       REQUIRE(m["1,3"] == 1.3);
     }());
-};
\ No newline at end of file
+};
+
+TEST_CASE("Map entries can be iterated", "[foreach]")
+{
+  const Map<std::string, int> m{{"One", 1}, {"Two", 2}, {"Three", 3}};
+
+  std::string keys;
+  int         sum = 0;
+  m.foreach (
+    [&](const std::string& key, int item)
+    {
+      keys += key;
+      sum += item;
+    });
+
+  REQUIRE(3 == m.getCount());
+  REQUIRE(keys == "OneTwoThree");
+  REQUIRE(sum == 6);
+}
+
+namespace
+{
+// String-like key counting how often it is constructed
+struct CountedKey
+{
+  static inline int constructed = 0;
+
+  std::string str;
+
+  CountedKey() = default;
+
+  CountedKey(std::string_view s) : str(s)
+  {
+    constructed++;
+  }
+
+  CountedKey(const CountedKey& other) : str(other.str)
+  {
+    constructed++;
+  }
+
+  CountedKey& operator=(const CountedKey& other) = default;
+
+  std::string_view view() const
+  {
+    return str;
+  }
+
+  bool operator==(const CountedKey& other) const
+  {
+    return str == other.str;
+  }
+
+  bool operator!=(const CountedKey& other) const
+  {
+    return str != other.str;
+  }
+};
+} // namespace
+
+TEST_CASE("Map looks up string keys without constructing them", "[transparent]")
+{
+  Map<String, int> m{{"GET /", 1}, {"GET /users", 2}};
+
+  std::string      path              = "POST /users/42";
+  std::string_view prefix            = std::string_view(path).substr(0, 11);
+  m[std::string_view("POST /users")] = 3;
+
+  REQUIRE(m["GET /"] == 1);
+  REQUIRE(m.tryGetItem(std::string("GET /users")) == 2);
+  REQUIRE(m.tryGetItem(prefix) == 3);
+  REQUIRE(m.contains(String("GET /")));
+  REQUIRE_FALSE(m.contains("GET"));
+  REQUIRE(m.find("PUT /") == nullptr);
+  REQUIRE(3 == m.getCount());
+
+  Map<CountedKey, int> counted;
+  counted["a"] = 1;
+  counted["b"] = 2;
+
+  int before = CountedKey::constructed;
+  REQUIRE(counted["a"] == 1);
+  REQUIRE(counted.tryGetItem(std::string("b")) == 2);
+  REQUIRE_FALSE(counted.contains("c"));
+  counted.trySetItem("a", 3);
+  REQUIRE(counted.tryGetItem("a") == 3);
+  REQUIRE(before == CountedKey::constructed);
+}
+
+TEST_CASE("Map lookups accept a precomputed hash", "[hash]")
+{
+  Map<std::string, int> m;
+  for (int i = 0; i < 1'000; i++)
+  {
+    m[std::to_string(i)] = i;
+  }
+
+  size_t hash = Map<std::string, int>::hash("123");
+  REQUIRE(hash == Map<std::string, int>::hash(std::string("123")));
+  REQUIRE(hash == Map<String, int>::hash(String("123")));
+  REQUIRE(m.tryGetItem("123", hash) == 123);
+  REQUIRE(*m.find(std::string_view("123"), hash) == 123);
+  REQUIRE(m.contains("123", hash));
+  REQUIRE_THROWS_AS(m.tryGetItem("1234", Map<std::string, int>::hash("1234")), not_found);
+}
+
+TEST_CASE("Map keeps its index consistent", "[index]")
+{
+  Map<long, long> m;
+  for (long i = 0; i < 10'000; i++)
+  {
+    m[i * 1'024] = i;
+  }
+  for (long i = 0; i < 10'000; i += 2)
+  {
+    m.tryRemoveItem(i * 1'024);
+  }
+
+  REQUIRE(5'000 == m.getCount());
+  for (long i = 0; i < 10'000; i++)
+  {
+    REQUIRE(m.contains(i * 1'024) == (i % 2 == 1));
+  }
+
+  long last = -1;
+  m.foreach (
+    [&](long key, long item)
+    {
+      REQUIRE(key == item * 1'024);
+      REQUIRE(item > last);
+      last = item;
+    });
+
+  REQUIRE_THROWS_AS(m.tryRemoveItem(0), not_found);
+  REQUIRE(m[2'048] == 0);
+  REQUIRE(5'001 == m.getCount());
+}
+
+namespace
+{
+struct Point
+{
+  int x;
+  int y;
+
+  bool operator==(const Point& other) const
+  {
+    return x == other.x && y == other.y;
+  }
+
+  bool operator!=(const Point& other) const
+  {
+    return !(*this == other);
+  }
+};
+} // namespace
+
+TEST_CASE("Map accepts keys without a hash", "[unhashed]")
+{
+  Map<Point, int> m;
+  for (int i = 0; i < 100; i++)
+  {
+    m[Point{i, -i}] = i;
+  }
+
+  REQUIRE(100 == m.getCount());
+  REQUIRE(42 == m.tryGetItem(Point{42, -42}));
+  REQUIRE_FALSE(m.contains(Point{42, 42}));
+
+  m.tryRemoveItem(Point{0, 0});
+  REQUIRE(99 == m.getCount());
+  REQUIRE_FALSE(m.contains(Point{0, 0}));
+  REQUIRE_THROWS_AS(m.tryRemoveItem(Point{0, 0}), not_found);
+  REQUIRE(99 == m[Point{99, -99}]);
+}
+
+TEST_CASE("Map hashes Array keys by content", "[array_key]")
+{
+  Map<Array<int>, int> m;
+  m[Array<int>{1, 2}] = 12;
+  m[Array<int>{2, 1}] = 21;
+
+  REQUIRE(2 == m.getCount());
+  REQUIRE(12 == m.tryGetItem(Array<int>{1, 2}));
+  REQUIRE(21 == m.tryGetItem(Array<int>{2, 1}));
+  REQUIRE_FALSE(m.contains(Array<int>{1, 2, 3}));
+}
+
+TEST_CASE("Map can be moved", "[move]")
+{
+  Map<int, int> m = {{1, 10}, {2, 20}};
+
+  Map<int, int> other = std::move(m);
+  REQUIRE(2 == other.getCount());
+  REQUIRE(20 == other.tryGetItem(2));
+
+  REQUIRE(0 == m.getCount());
+  REQUIRE_FALSE(m.contains(1));
+  m[3] = 30;
+  REQUIRE(30 == m.tryGetItem(3));
+
+  Map<int, int> big;
+  for (int i = 0; i < 100; i++)
+  {
+    big[i] = i;
+  }
+  big = std::move(other);
+  REQUIRE(2 == big.getCount());
+  REQUIRE(10 == big.tryGetItem(1));
+  REQUIRE_FALSE(big.contains(50));
+
+  REQUIRE(0 == other.getCount());
+  other[7] = 70;
+  REQUIRE(1 == other.getCount());
+  REQUIRE(70 == other.tryGetItem(7));
+  REQUIRE_FALSE(other.contains(50));
+}
@@ -0,0 +1,91 @@
+#include "StaticMap.hpp"
+#include "String.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+enum class Color
+{
+  Red,
+  Green,
+  Blue
+};
+
+// Built during compilation
+static constexpr auto Keywords = makeStaticMap<std::string_view, int>(
+  {{"select", 1}, {"from", 2}, {"where", 3}, {"group", 4}, {"order", 5}, {"by", 6}, {"limit", 7}, {"join", 8}});
+static constexpr auto Colors = makeStaticMap<Color, const char *>({{Color::Red, "red"}, {Color::Blue, "blue"}});
+
+static_assert(Keywords.getCount() == 8);
+
+TEST_CASE("StaticMap lookups", "[static_map][find]")
+{
+  SECTION("Every key finds its own item")
+  {
+    REQUIRE(1 == *Keywords.find("select"));
+    REQUIRE(8 == Keywords.tryGetItem(std::string("join")));
+    REQUIRE(3 == Keywords.tryGetItem(String("where")));
+    REQUIRE(std::string("blue") == *Colors.find(Color::Blue));
+  }
+
+  SECTION("Missing keys are not found")
+  {
+    REQUIRE(nullptr == Keywords.find("insert"));
+    REQUIRE(nullptr == Keywords.find(""));
+    REQUIRE_FALSE(Keywords.contains("selec"));
+    REQUIRE_FALSE(Colors.contains(Color::Green));
+    REQUIRE_THROWS_AS(Keywords.tryGetItem("update"), not_found);
+  }
+
+  SECTION("foreach visits every entry once")
+  {
+    int sum = 0;
+    Keywords.foreach (
+      [&](std::string_view key, int item)
+      {
+        REQUIRE(item == *Keywords.find(key));
+        sum += item;
+      });
+    REQUIRE(36 == sum);
+  }
+}
+
+TEST_CASE("StaticMap built at runtime", "[static_map][runtime]")
+{
+  SECTION("Larger key sets get minimal perfect hashes")
+  {
+    static std::pair<uint64_t, size_t> entries[5'000];
+    for (size_t i = 0; i < 5'000; i++)
+    {
+      entries[i] = {i * 7'919 + 3, i};
+    }
+
+    auto map = std::make_unique<StaticMap<uint64_t, size_t, 5'000>>(entries);
+    for (size_t i = 0; i < 5'000; i++)
+    {
+      REQUIRE(i == map->tryGetItem(i * 7'919 + 3));
+      REQUIRE_FALSE(map->contains(i * 7'919 + 4));
+    }
+    REQUIRE(0 == map->tryGetItem(3));
+  }
+
+  SECTION("Non-literal keys and items")
+  {
+    auto map = makeStaticMap<String, std::string>({{"a", "1"}, {"bb", "2"}, {"ccc", "3"}});
+    REQUIRE("2" == map.tryGetItem("bb"));
+    REQUIRE("3" == map.tryGetItem(std::string_view("ccc")));
+    REQUIRE_FALSE(map.contains("d"));
+  }
+
+  SECTION("Duplicate keys are rejected")
+  {
+    REQUIRE_THROWS_AS((makeStaticMap<std::string_view, int>({{"a", 1}, {"b", 2}, {"a", 3}})), std::invalid_argument);
+  }
+}
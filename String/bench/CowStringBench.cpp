@@ -0,0 +1,64 @@
+#include "Benchmark.hpp"
+#include "CowString.hpp"
+#include "Map.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace CppUtil;
+
+// Values copied from a small set of source strings into map values, then the whole map copied as a snapshot
+static constexpr size_t Entries = 200'000;
+static constexpr size_t Sources = 1'000;
+
+template <typename S> static void run(const char * name, const std::vector<S>& sources)
+{
+  Map<int, S> map;
+  double      fill = Benchmark::measure(
+    [&]
+    {
+      map = Map<int, S>();
+      for (size_t i = 0; i < Entries; i++)
+      {
+        map[(int)i] = sources[i % Sources];
+      }
+    },
+    3);
+
+  double snapshot = Benchmark::measure(
+    [&]
+    {
+      Map<int, S> copy = map;
+      Benchmark::doNotOptimize(copy.getCount());
+    },
+    3);
+
+  size_t length = 0;
+  double read   = Benchmark::measure(
+    [&]
+    {
+      map.foreach ([&](int, const S& value) { length += value.length(); });
+      Benchmark::doNotOptimize(length);
+    },
+    3);
+
+  Benchmark::report((std::string(name) + " fill map values").c_str(), fill, Entries);
+  Benchmark::report((std::string(name) + " copy map").c_str(), snapshot, Entries);
+  Benchmark::report((std::string(name) + " read values").c_str(), read, Entries);
+}
+
+int main()
+{
+  std::vector<String>    strings;
+  std::vector<CowString> cows;
+  for (size_t i = 0; i < Sources; i++)
+  {
+    std::string value = "session-" + std::to_string(i) + ";user=someone@example.com;region=eu-west-1";
+    strings.push_back(String(value));
+    cows.push_back(CowString(value));
+  }
+
+  run("String", strings);
+  run("CowString", cows);
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include "Benchmark.hpp"
+#include "FixedString.hpp"
+#include "Map.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace CppUtil;
+
+// Classify tokens of a query language as keywords, once with a table built at startup and once with hashes computed
+// during compilation
+static constexpr size_t Tokens = 1'000'000;
+
+static constexpr FixedString Select = "select";
+static constexpr FixedString From   = "from";
+static constexpr FixedString Where  = "where";
+static constexpr FixedString Group  = "group";
+static constexpr FixedString Order  = "order";
+static constexpr FixedString By     = "by";
+static constexpr FixedString Limit  = "limit";
+
+template <typename S> static int check(std::string_view token, const S& keyword, int id)
+{
+  return token == keyword.view() ? id : 0;
+}
+
+static int classify(std::string_view token)
+{
+  switch (Hash::string(token))
+  {
+    case Select.getHash():
+      return check(token, Select, 1);
+    case From.getHash():
+      return check(token, From, 2);
+    case Where.getHash():
+      return check(token, Where, 3);
+    case Group.getHash():
+      return check(token, Group, 4);
+    case Order.getHash():
+      return check(token, Order, 5);
+    case By.getHash():
+      return check(token, By, 6);
+    case Limit.getHash():
+      return check(token, Limit, 7);
+    default:
+      return 0;
+  }
+}
+
+int main()
+{
+  const char *             words[] = {"select", "from", "where", "group", "order", "by",
+                                      "limit",  "id",   "name",  "users", "count", "*"};
+  std::mt19937             rng(1);
+  std::vector<std::string> tokens(Tokens);
+  for (auto& token : tokens)
+  {
+    token = words[rng() % 12];
+  }
+
+  Map<String, int> table;
+  double           build = Benchmark::measure(
+    [&]
+    {
+      table =
+        Map<String, int>{{"select", 1}, {"from", 2}, {"where", 3}, {"group", 4}, {"order", 5}, {"by", 6}, {"limit", 7}};
+    },
+    5);
+
+  double lookup = Benchmark::measure(
+    [&]
+    {
+      int sum = 0;
+      for (const std::string& token : tokens)
+      {
+        const int * id = table.find(std::string_view(token));
+        sum += id == nullptr ? 0 : *id;
+      }
+      Benchmark::doNotOptimize(sum);
+    },
+    3);
+
+  double compiled = Benchmark::measure(
+    [&]
+    {
+      int sum = 0;
+      for (const std::string& token : tokens)
+      {
+        sum += classify(token);
+      }
+      Benchmark::doNotOptimize(sum);
+    },
+    3);
+
+  Benchmark::report("Map<String, int> keyword table build", build, 7);
+  Benchmark::report("Map<String, int> keyword lookup", lookup, Tokens);
+  Benchmark::report("constexpr hash switch lookup", compiled, Tokens);
+  return 0;
+}
@@ -0,0 +1,257 @@
+#include "Benchmark.hpp"
+#include "String.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace CppUtil;
+
+// Classification as it was before CharClass: a range check per character and a scan of `characters` per miss
+static bool legacyCharIsAlpha(char c)
+{
+  return (c >= 0x30 && c <= 0x39) || (c >= 0x41 && c <= 0x5A) || (c >= 0x61 && c <= 0x7A);
+}
+
+static bool legacyIsAlphaOr(const char * str, size_t len, const char * characters, size_t n)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    if (!legacyCharIsAlpha(str[i]))
+    {
+      bool res = false;
+      for (size_t j = 0; j < n; j++)
+      {
+        if (str[i] == characters[j])
+          res = true;
+      }
+      if (!res)
+        return false;
+    }
+  }
+  return true;
+}
+
+static const char * isaName(CharClass::Isa isa)
+{
+  switch (isa)
+  {
+    case CharClass::Isa::AVX2:
+      return "avx2";
+    case CharClass::Isa::SSSE3:
+      return "ssse3";
+    default:
+      return "scalar";
+  }
+}
+
+static constexpr size_t Size = 64 << 20;
+
+// Random lowercase words of 3 to 10 letters, separated by spaces
+static std::string randomWords(std::mt19937& rng, size_t size)
+{
+  std::string res;
+  res.reserve(size + 11);
+  while (res.size() < size)
+  {
+    size_t len = 3 + rng() % 8;
+    for (size_t i = 0; i < len; i++)
+      res += (char)('a' + rng() % 26);
+    res += ' ';
+  }
+  res.resize(size);
+  return res;
+}
+
+// Multi-pattern search as before MultiPattern: one pass over the text per pattern
+static size_t legacyCountAll(const std::string& text, const std::vector<std::string>& patterns)
+{
+  size_t count = 0;
+  for (const auto& p : patterns)
+  {
+    for (size_t pos = text.find(p); pos != std::string::npos; pos = text.find(p, pos + 1))
+      count++;
+  }
+  return count;
+}
+
+static void benchMultiPattern(std::mt19937& rng)
+{
+  std::string text  = randomWords(rng, 16 << 20);
+  std::string slice = text.substr(0, 1 << 20);
+
+  for (size_t n : {10, 100, 1'000, 10'000})
+  {
+    std::vector<std::string> patterns;
+    MultiPattern             mp;
+    for (size_t i = 0; i < n; i++)
+    {
+      patterns.push_back(randomWords(rng, 4 + rng() % 6));
+      mp.add(patterns.back());
+    }
+    mp.compile();
+
+    // The legacy search runs on 1 MiB only, it takes too long on the full text
+    size_t count = 0;
+    double sec   = Benchmark::measure([&] { count = legacyCountAll(slice, patterns); }, 1);
+    Benchmark::doNotOptimize(count);
+    std::string name = std::to_string(n) + " patterns, one pass per pattern";
+    Benchmark::report(name.c_str(), sec, slice.size(), slice.size());
+
+    sec = Benchmark::measure(
+      [&]
+      {
+        count = 0;
+        mp.foreachMatch(text.data(), text.size(), [&](const MultiPattern::Match&) { count++; });
+      },
+      3);
+    Benchmark::doNotOptimize(count);
+    name = std::to_string(n) + " patterns, MultiPattern (" + std::to_string(mp.getStateCount()) + " states)";
+    Benchmark::report(name.c_str(), sec, text.size(), text.size());
+  }
+}
+
+// Splitting as it was before CharClass: a bounds checked copy per character and a growing result
+static String legacySubstring(const String& str, size_t idx, size_t len)
+{
+  // The original wrote into a preallocated String, which is not accessible from here
+  std::string res(len, '\0');
+  for (size_t i = 0; i < len; i++)
+  {
+    res[i] = str[i + idx];
+  }
+  return res;
+}
+
+static DynamicArray<String> legacySplitAt(const String& str, char character)
+{
+  DynamicArray<String> res;
+  for (size_t i = 0; i < str.length(); i++)
+  {
+    if (str[i] == character)
+      continue;
+
+    size_t startIdx = i;
+    while (1)
+    {
+      if (i >= str.length() || str[i] == character)
+      {
+        res.add(legacySubstring(str, startIdx, i - startIdx));
+        break;
+      }
+      i++;
+    }
+  }
+  return res;
+}
+
+static void benchSplit(std::mt19937& rng)
+{
+  // CSV-like lines of 8 fields, each field being a word or a number
+  std::string csv;
+  while (csv.size() < (4 << 20))
+  {
+    for (int f = 0; f < 8; f++)
+    {
+      csv += (f % 2) ? std::to_string(rng() % 100'000) : randomWords(rng, 3 + rng() % 8);
+      csv += (f < 7) ? ',' : '\n';
+    }
+  }
+  String text  = csv;
+  size_t count = 0;
+
+  double sec = Benchmark::measure([&] { count = legacySplitAt(text, ',').getCount(); }, 3);
+  Benchmark::doNotOptimize(count);
+  Benchmark::report("splitAt 4 MiB CSV, legacy", sec, count, csv.size());
+
+  sec = Benchmark::measure([&] { count = text.splitAt(',').getCount(); }, 3);
+  Benchmark::doNotOptimize(count);
+  Benchmark::report("splitAt 4 MiB CSV, String::splitAt(char)", sec, count, csv.size());
+
+  CharSet delims(",\n ");
+  sec = Benchmark::measure([&] { count = text.splitAt(delims).getCount(); }, 3);
+  Benchmark::doNotOptimize(count);
+  Benchmark::report("splitAt 4 MiB CSV, String::splitAt(\",\\n \")", sec, count, csv.size());
+
+  DynamicArray<std::string_view> views;
+  sec = Benchmark::measure([&] { count = text.splitViews(CharSet(",\n"), views, true); }, 3);
+  Benchmark::doNotOptimize(count);
+  Benchmark::report("splitAt 4 MiB CSV, String::splitViews(\",\\n\")", sec, count, csv.size());
+}
+
+int main()
+{
+  const char   identChars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-";
+  const char * extra        = "_-./:";
+  CharSet      allowed      = CharClass::Alnum | CharSet(extra);
+
+  std::mt19937 rng(42);
+  std::string  text(Size, ' ');
+  for (auto& c : text)
+    c = identChars[rng() % (sizeof(identChars) - 1)];
+
+  std::vector<CharClass::Isa> isas = {CharClass::Isa::Scalar};
+  if (CharClass::getIsa() >= CharClass::Isa::SSSE3)
+    isas.push_back(CharClass::Isa::SSSE3);
+  if (CharClass::getIsa() >= CharClass::Isa::AVX2)
+    isas.push_back(CharClass::Isa::AVX2);
+
+  bool   ok  = false;
+  double sec = Benchmark::measure([&] { ok = legacyIsAlphaOr(text.data(), text.size(), extra, strlen(extra)); });
+  Benchmark::doNotOptimize(ok);
+  Benchmark::report("isAlphaOr 64 MiB, legacy", sec, Size, Size);
+
+  for (auto isa : isas)
+  {
+    sec = Benchmark::measure([&] { ok = CharClass::all(text.data(), text.size(), allowed, isa); });
+    Benchmark::doNotOptimize(ok);
+    std::string name = std::string("isAlphaOr 64 MiB, ") + isaName(isa);
+    Benchmark::report(name.c_str(), sec, Size, Size);
+  }
+  printf("\n");
+
+  size_t count = 0;
+  for (auto isa : isas)
+  {
+    sec = Benchmark::measure([&] { count = CharClass::countIf(text.data(), text.size(), CharClass::Digits, isa); });
+    Benchmark::doNotOptimize(count);
+    std::string name = std::string("countIf digits 64 MiB, ") + isaName(isa);
+    Benchmark::report(name.c_str(), sec, Size, Size);
+  }
+  printf("\n");
+
+  // Many short identifiers, 8 to 40 characters each
+  std::vector<String> idents;
+  size_t              bytes = 0;
+  for (size_t i = 0; i < 1'000'000; i++)
+  {
+    std::string s = text.substr(i * 40, 8 + rng() % 33);
+    bytes += s.size();
+    idents.emplace_back(s);
+  }
+
+  size_t valid = 0;
+  sec          = Benchmark::measure(
+    [&]
+    {
+      for (auto& s : idents)
+        valid += legacyIsAlphaOr(&s[0], s.length(), extra, strlen(extra));
+    });
+  Benchmark::report("1M identifiers, legacy", sec, idents.size(), bytes);
+
+  sec = Benchmark::measure(
+    [&]
+    {
+      for (auto& s : idents)
+        valid += s.isAlphaOr(allowed);
+    });
+  Benchmark::report("1M identifiers, String::isAlphaOr", sec, idents.size(), bytes);
+  Benchmark::doNotOptimize(valid);
+  printf("\n");
+
+  benchMultiPattern(rng);
+  printf("\n");
+
+  benchSplit(rng);
+  return 0;
+}
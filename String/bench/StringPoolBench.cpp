@@ -0,0 +1,132 @@
+#include "Benchmark.hpp"
+#include "Map.hpp"
+#include "StringPool.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace CppUtil;
+
+// Log records referencing a skewed set of hostnames, as stored in a `DynamicArray<String>` column
+static constexpr size_t Records = 1'000'000;
+static constexpr size_t Hosts   = 2'000;
+
+static size_t heapInUse()
+{
+#if defined(__GLIBC__)
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+#else
+  return 0;
+#endif
+}
+
+int main()
+{
+  std::vector<std::string> hosts;
+  for (size_t i = 0; i < Hosts; i++)
+    hosts.push_back("api-" + std::to_string(i) + ".eu-west-" + std::to_string(i % 3) + ".service.example.com");
+
+  // Roughly Zipf distributed: low host ids are much more frequent
+  std::mt19937          rng(1);
+  std::vector<uint32_t> ids(Records);
+  for (auto& id : ids)
+  {
+    double u = std::uniform_real_distribution<double>(0, 1)(rng);
+    id       = (uint32_t)(u * u * u * Hosts);
+  }
+
+  size_t               before = heapInUse();
+  DynamicArray<String> strings(Records);
+  for (uint32_t id : ids)
+    strings.add(String(hosts[id]));
+  size_t stringBytes = heapInUse() - before;
+
+  before = heapInUse();
+  StringPool                   pool;
+  DynamicArray<InternedString> handles(Records);
+  double                       intern = Benchmark::measure(
+    [&]
+    {
+      handles.clear();
+      for (uint32_t id : ids)
+        handles.add(pool.intern(hosts[id]));
+    },
+    1);
+  size_t handleBytes = heapInUse() - before;
+
+  Benchmark::report("StringPool::intern", intern, Records);
+  printf("  memory: DynamicArray<String> %zu KB, StringPool + DynamicArray<InternedString> %zu KB (pool %zu KB)\n\n",
+         stringBytes >> 10, handleBytes >> 10, pool.getMemoryUsage() >> 10);
+
+  const String *         str = strings.getData();
+  const InternedString * hnd = handles.getData();
+
+  // Compare every record with its successor
+  size_t equal   = 0;
+  double compare = Benchmark::measure(
+    [&]
+    {
+      equal = 0;
+      for (size_t i = 1; i < Records; i++)
+        equal += str[i] == str[i - 1];
+      Benchmark::doNotOptimize(equal);
+    });
+  Benchmark::report("String::operator==", compare, Records);
+  double compareHandles = Benchmark::measure(
+    [&]
+    {
+      equal = 0;
+      for (size_t i = 1; i < Records; i++)
+        equal += hnd[i] == hnd[i - 1];
+      Benchmark::doNotOptimize(equal);
+    });
+  Benchmark::report("InternedString::operator==", compareHandles, Records);
+  printf("  speedup: %.1fx\n\n", compare / compareHandles);
+
+  size_t sum  = 0;
+  double hash = Benchmark::measure(
+    [&]
+    {
+      sum = 0;
+      for (size_t i = 0; i < Records; i++)
+        sum += Hasher<String>()(str[i]);
+      Benchmark::doNotOptimize(sum);
+    });
+  Benchmark::report("Hasher<String>", hash, Records);
+  double hashHandles = Benchmark::measure(
+    [&]
+    {
+      sum = 0;
+      for (size_t i = 0; i < Records; i++)
+        sum += Hasher<InternedString>()(hnd[i]);
+      Benchmark::doNotOptimize(sum);
+    });
+  Benchmark::report("Hasher<InternedString>", hashHandles, Records);
+  printf("  speedup: %.1fx\n\n", hash / hashHandles);
+
+  // Count records per host
+  Map<String, size_t>         perHost;
+  Map<InternedString, size_t> perHandle;
+  double                      count = Benchmark::measure(
+    [&]
+    {
+      for (size_t i = 0; i < Records; i++)
+        perHost[str[i]]++;
+    });
+  Benchmark::report("Map<String, size_t>::operator[]", count, Records);
+  double countHandles = Benchmark::measure(
+    [&]
+    {
+      for (size_t i = 0; i < Records; i++)
+        perHandle[hnd[i]]++;
+    });
+  Benchmark::report("Map<InternedString, size_t>::operator[]", countHandles, Records);
+  printf("  speedup: %.1fx\n", count / countHandles);
+  return 0;
+}
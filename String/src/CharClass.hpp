@@ -0,0 +1,424 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define CHARCLASS_SIMD_X86 1
+#endif
+
+namespace CppUtil
+{
+/**
+  * Set of byte values, usable in constant expressions
+  *
+  * Bytes are stored as a 256 bit bitmap indexed by nibbles: bit `h` of `rows[l]` tells whether `h * 16 + l` is
+  * part of the set for `h < 8`, `rows[16 + l]` holds the same for `h >= 8`. That way SIMD kernels classify a
+  * whole vector of bytes with three byte shuffles, for arbitrary sets.
+  */
+class CharSet
+{
+private:
+  uint8_t rows[32] = {};
+
+  friend class CharClass;
+
+public:
+  constexpr CharSet() {}
+
+  explicit constexpr CharSet(const char * chars)
+  {
+    while (*chars != '\0')
+      this->add(*chars++);
+  }
+
+  constexpr CharSet(const char * chars, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      this->add(chars[i]);
+  }
+
+  /**
+    * All characters from `first` to `last` (inclusive)
+    */
+  static constexpr CharSet range(char first, char last)
+  {
+    CharSet res;
+    for (int c = (unsigned char)first; c <= (unsigned char)last; c++)
+      res.add((char)c);
+    return res;
+  }
+
+  constexpr void add(char c)
+  {
+    unsigned char u = (unsigned char)c;
+    this->rows[(u >> 7) * 16 + (u & 15)] |= (uint8_t)(1 << ((u >> 4) & 7));
+  }
+
+  constexpr bool contains(char c) const
+  {
+    unsigned char u = (unsigned char)c;
+    return (this->rows[(u >> 7) * 16 + (u & 15)] >> ((u >> 4) & 7)) & 1;
+  }
+
+  constexpr CharSet operator|(const CharSet& other) const
+  {
+    CharSet res;
+    for (size_t i = 0; i < 32; i++)
+      res.rows[i] = this->rows[i] | other.rows[i];
+    return res;
+  }
+
+  constexpr CharSet operator&(const CharSet& other) const
+  {
+    CharSet res;
+    for (size_t i = 0; i < 32; i++)
+      res.rows[i] = this->rows[i] & other.rows[i];
+    return res;
+  }
+
+  constexpr CharSet operator~() const
+  {
+    CharSet res;
+    for (size_t i = 0; i < 32; i++)
+      res.rows[i] = (uint8_t) ~this->rows[i];
+    return res;
+  }
+};
+
+/**
+  * Bulk character classification over a `CharSet`
+  *
+  * On x86 with GCC or Clang, SSSE3 and AVX2 kernels are compiled in regardless of the build flags, and the best
+  * one supported by the CPU is picked at runtime. Everywhere else, a scalar table lookup is used.
+  */
+class CharClass
+{
+public:
+  static constexpr size_t npos = SIZE_MAX;
+
+  static constexpr CharSet Digits  = CharSet::range('0', '9');
+  static constexpr CharSet Letters = CharSet::range('a', 'z') | CharSet::range('A', 'Z');
+  static constexpr CharSet Alnum   = Digits | Letters;
+  static constexpr CharSet Spaces  = CharSet(" \t\n\v\f\r");
+
+  enum class Isa
+  {
+    Scalar,
+    SSSE3,
+    AVX2
+  };
+
+private:
+  enum class Op
+  {
+    FindIn,
+    FindNotIn,
+    Count
+  };
+
+  template <Op O> static size_t scalar(const unsigned char * data, size_t n, const CharSet& set)
+  {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      bool in = set.contains((char)data[i]);
+      if constexpr (O == Op::Count)
+        count += in;
+      else if (in == (O == Op::FindIn))
+        return i;
+    }
+    return (O == Op::Count) ? count : npos;
+  }
+
+#if defined(CHARCLASS_SIMD_X86)
+  // Mask of the bytes in `v` not contained in the set given by its nibble tables
+  __attribute__((target("ssse3"))) static __m128i nonMembers(__m128i v, __m128i low, __m128i high)
+  {
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m128i nib  = _mm_set1_epi8(0x0f);
+
+    __m128i lo    = _mm_and_si128(v, nib);
+    __m128i hi    = _mm_and_si128(_mm_srli_epi16(v, 4), nib);
+    __m128i upper = _mm_cmpgt_epi8(hi, _mm_set1_epi8(7));
+    __m128i row   = _mm_or_si128(_mm_andnot_si128(upper, _mm_shuffle_epi8(low, lo)),
+                                 _mm_and_si128(upper, _mm_shuffle_epi8(high, lo)));
+    return _mm_cmpeq_epi8(_mm_and_si128(row, _mm_shuffle_epi8(bits, hi)), _mm_setzero_si128());
+  }
+
+  template <Op O>
+  __attribute__((target("ssse3"))) static size_t ssse3(const unsigned char * data, size_t n, const CharSet& set)
+  {
+    const __m128i low  = _mm_loadu_si128((const __m128i *)set.rows);
+    const __m128i high = _mm_loadu_si128((const __m128i *)(set.rows + 16));
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t  i = 0, count = 0;
+    __m128i acc    = zero;
+    size_t  rounds = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+      __m128i notIn = nonMembers(_mm_loadu_si128((const __m128i *)(data + i)), low, high);
+
+      if constexpr (O == Op::Count)
+      {
+        // Count non-members per byte lane, flushing before the 8 bit counters overflow
+        acc = _mm_sub_epi8(acc, notIn);
+        if (++rounds == 255)
+        {
+          __m128i sum = _mm_sad_epu8(acc, zero);
+          count += 16 * rounds - (size_t)(_mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4));
+          acc    = zero;
+          rounds = 0;
+        }
+      }
+      else
+      {
+        unsigned mask = (unsigned)_mm_movemask_epi8(notIn);
+        if (O == Op::FindIn)
+          mask ^= 0xffff;
+        if (mask != 0)
+          return i + __builtin_ctz(mask);
+      }
+    }
+
+    if constexpr (O == Op::Count)
+    {
+      __m128i sum = _mm_sad_epu8(acc, zero);
+      count += 16 * rounds - (size_t)(_mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4));
+    }
+
+    // Classify the tail in a zero padded copy, so short strings do not fall back to scalar code
+    if (i < n)
+    {
+      alignas(16) unsigned char buf[16] = {};
+      memcpy(buf, data + i, n - i);
+
+      unsigned valid = (1u << (n - i)) - 1;
+      unsigned notIn = (unsigned)_mm_movemask_epi8(nonMembers(_mm_load_si128((const __m128i *)buf), low, high)) & valid;
+
+      if constexpr (O == Op::Count)
+      {
+        count += (n - i) - __builtin_popcount(notIn);
+      }
+      else
+      {
+        unsigned mask = (O == Op::FindIn) ? (~notIn & valid) : notIn;
+        if (mask != 0)
+          return i + __builtin_ctz(mask);
+      }
+    }
+    return (O == Op::Count) ? count : npos;
+  }
+
+  __attribute__((target("avx2"))) static __m256i nonMembers(__m256i v, __m256i low, __m256i high)
+  {
+    const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16,
+                                          32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m256i nib  = _mm256_set1_epi8(0x0f);
+
+    __m256i lo  = _mm256_and_si256(v, nib);
+    __m256i hi  = _mm256_and_si256(_mm256_srli_epi16(v, 4), nib);
+    __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low, lo), _mm256_shuffle_epi8(high, lo),
+                                     _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7)));
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, _mm256_shuffle_epi8(bits, hi)), _mm256_setzero_si256());
+  }
+
+  template <Op O>
+  __attribute__((target("avx2"))) static size_t avx2(const unsigned char * data, size_t n, const CharSet& set)
+  {
+    const __m256i low  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set.rows));
+    const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(set.rows + 16)));
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t  i = 0, count = 0;
+    __m256i acc    = zero;
+    size_t  rounds = 0;
+
+    for (; i + 32 <= n; i += 32)
+    {
+      __m256i notIn = nonMembers(_mm256_loadu_si256((const __m256i *)(data + i)), low, high);
+
+      if constexpr (O == Op::Count)
+      {
+        acc = _mm256_sub_epi8(acc, notIn);
+        if (++rounds == 255)
+        {
+          count += 32 * rounds - sum256(_mm256_sad_epu8(acc, zero));
+          acc    = zero;
+          rounds = 0;
+        }
+      }
+      else
+      {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(notIn);
+        if (O == Op::FindIn)
+          mask = ~mask;
+        if (mask != 0)
+          return i + __builtin_ctz(mask);
+      }
+    }
+
+    if (i == n)
+      return (O == Op::Count) ? count + 32 * rounds - sum256(_mm256_sad_epu8(acc, zero)) : npos;
+
+    size_t tail = ssse3<O>(data + i, n - i, set);
+    if constexpr (O == Op::Count)
+      return count + 32 * rounds - sum256(_mm256_sad_epu8(acc, zero)) + tail;
+    else
+      return (tail == npos) ? npos : i + tail;
+  }
+
+  template <typename F>
+  __attribute__((target("ssse3"))) static void eachSsse3(const unsigned char * data, size_t n, const CharSet& set, F& f)
+  {
+    const __m128i low  = _mm_loadu_si128((const __m128i *)set.rows);
+    const __m128i high = _mm_loadu_si128((const __m128i *)(set.rows + 16));
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+      unsigned mask = ~(unsigned)_mm_movemask_epi8(nonMembers(_mm_loadu_si128((const __m128i *)(data + i)), low, high));
+      for (mask &= 0xffff; mask != 0; mask &= mask - 1)
+        f(i + __builtin_ctz(mask));
+    }
+
+    if (i < n)
+    {
+      alignas(16) unsigned char buf[16] = {};
+      memcpy(buf, data + i, n - i);
+
+      unsigned mask = ~(unsigned)_mm_movemask_epi8(nonMembers(_mm_load_si128((const __m128i *)buf), low, high));
+      for (mask &= (1u << (n - i)) - 1; mask != 0; mask &= mask - 1)
+        f(i + __builtin_ctz(mask));
+    }
+  }
+
+  template <typename F>
+  __attribute__((target("avx2"))) static void eachAvx2(const unsigned char * data, size_t n, const CharSet& set, F& f)
+  {
+    const __m256i low  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set.rows));
+    const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(set.rows + 16)));
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+      uint32_t mask =
+        ~(uint32_t)_mm256_movemask_epi8(nonMembers(_mm256_loadu_si256((const __m256i *)(data + i)), low, high));
+      for (; mask != 0; mask &= mask - 1)
+        f(i + __builtin_ctz(mask));
+    }
+
+    if (i < n)
+    {
+      auto shifted = [&](size_t idx) { f(i + idx); };
+      eachSsse3(data + i, n - i, set, shifted);
+    }
+  }
+
+  // Sum of the four 64 bit lanes produced by `_mm256_sad_epu8`
+  __attribute__((target("avx2"))) static size_t sum256(__m256i v)
+  {
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return (size_t)_mm_cvtsi128_si64(s) + (size_t)_mm_extract_epi64(s, 1);
+  }
+#endif
+
+  template <Op O> static size_t run(const char * data, size_t n, const CharSet& set, Isa isa)
+  {
+    auto p = (const unsigned char *)data;
+    if (isa > getIsa())
+      isa = getIsa();
+
+#if defined(CHARCLASS_SIMD_X86)
+    if (isa == Isa::AVX2)
+      return avx2<O>(p, n, set);
+    if (isa == Isa::SSSE3)
+      return ssse3<O>(p, n, set);
+#endif
+    return scalar<O>(p, n, set);
+  }
+
+public:
+  /**
+    * Best instruction set supported by the CPU, detected once
+    */
+  static Isa getIsa()
+  {
+#if defined(CHARCLASS_SIMD_X86)
+    static const Isa isa = []
+    {
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+        return Isa::AVX2;
+      if (__builtin_cpu_supports("ssse3"))
+        return Isa::SSSE3;
+      return Isa::Scalar;
+    }();
+    return isa;
+#else
+    return Isa::Scalar;
+#endif
+  }
+
+  /**
+    * Index of the first of the `n` characters at `data` contained in `set`, or `npos`
+    *
+    * @param isa Kernel to use; instruction sets not supported by the CPU fall back to the best supported one
+    */
+  static size_t findFirstOf(const char * data, size_t n, const CharSet& set, Isa isa = getIsa())
+  {
+    return run<Op::FindIn>(data, n, set, isa);
+  }
+
+  /**
+    * Index of the first of the `n` characters at `data` not contained in `set`, or `npos`
+    */
+  static size_t findFirstNotOf(const char * data, size_t n, const CharSet& set, Isa isa = getIsa())
+  {
+    return run<Op::FindNotIn>(data, n, set, isa);
+  }
+
+  /**
+    * Amount of the `n` characters at `data` contained in `set`
+    */
+  static size_t countIf(const char * data, size_t n, const CharSet& set, Isa isa = getIsa())
+  {
+    return run<Op::Count>(data, n, set, isa);
+  }
+
+  /**
+    * Call `f(idx)` for the index of every one of the `n` characters at `data` contained in `set`, in order
+    */
+  template <typename F>
+  static void foreachOf(const char * data, size_t n, const CharSet& set, F&& f, Isa isa = getIsa())
+  {
+    auto p = (const unsigned char *)data;
+    if (isa > getIsa())
+      isa = getIsa();
+
+#if defined(CHARCLASS_SIMD_X86)
+    if (isa == Isa::AVX2)
+      return eachAvx2(p, n, set, f);
+    if (isa == Isa::SSSE3)
+      return eachSsse3(p, n, set, f);
+#endif
+    for (size_t i = 0; i < n; i++)
+    {
+      if (set.contains((char)p[i]))
+        f(i);
+    }
+  }
+
+  /**
+    * Whether all `n` characters at `data` are contained in `set`
+    */
+  static bool all(const char * data, size_t n, const CharSet& set, Isa isa = getIsa())
+  {
+    return findFirstNotOf(data, n, set, isa) == npos;
+  }
+};
+} // namespace CppUtil
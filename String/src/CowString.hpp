@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "CowArray.hpp"
+#include "String.hpp"
+
+namespace CppUtil
+{
+/**
+  * Immutable-by-default string whose copies share their characters until one of them is modified
+  *
+  * Copying takes O(1), which suits strings that are passed around and stored in containers like `Map` values far more
+  * often than they are changed. Non-const `operator[]` and appending detach a shared string by copying its
+  * characters first. Thread safety follows `CowArray`.
+  */
+class CowString
+{
+private:
+  CowArray<char> chars; // Characters followed by a terminating null, empty for the empty string
+
+  template <typename S> static std::string_view viewOf(const S& str)
+  {
+    if constexpr (std::is_same_v<S, CowString>)
+      return str.view();
+    else
+      return std::string_view(str);
+  }
+
+public:
+  CowString() = default;
+
+  CowString(std::string_view str)
+  {
+    if (str.empty())
+      return;
+
+    this->chars = CowArray<char>(str.size() + 1);
+    memcpy(this->chars.getMutableData(), str.data(), str.size());
+  }
+
+  CowString(const char * str) : CowString(std::string_view(str)) {}
+
+  CowString(const std::string& str) : CowString(std::string_view(str)) {}
+
+  CowString(const String& str) : CowString(str.view()) {}
+
+  size_t length() const
+  {
+    return this->chars.isEmpty() ? 0 : this->chars.getSize() - 1;
+  }
+
+  bool isEmpty() const
+  {
+    return this->chars.isEmpty();
+  }
+
+  /**
+    * View of the characters without the terminating null
+    *
+    * The view is invalidated by any modification of this string.
+    */
+  std::string_view view() const
+  {
+    return std::string_view(this->c_str(), this->length());
+  }
+
+  /**
+    * Null terminated characters
+    */
+  const char * c_str() const
+  {
+    return this->chars.isEmpty() ? "" : this->chars.getData();
+  }
+
+  /**
+    * @throws `out_of_range` if @param idx is not smaller than the length
+    */
+  char& operator[](size_t idx)
+  {
+    if (idx >= this->length())
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for string of length " +
+                              std::to_string(this->length()) + "!");
+    return this->chars[idx];
+  }
+
+  char operator[](size_t idx) const
+  {
+    if (idx >= this->length())
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for string of length " +
+                              std::to_string(this->length()) + "!");
+    return this->chars[idx];
+  }
+
+  /**
+    * Append `str`, which is a `CowString` or anything convertible to `std::string_view`
+    */
+  template <typename S> CowString& operator+=(const S& str)
+  {
+    std::string_view add = viewOf(str);
+    if (add.empty())
+      return *this;
+
+    CowString res;
+    res.chars  = CowArray<char>(this->length() + add.size() + 1);
+    char * dst = res.chars.getMutableData();
+    memcpy(dst, this->c_str(), this->length());
+    memcpy(dst + this->length(), add.data(), add.size());
+    return *this = std::move(res);
+  }
+
+  template <typename S> CowString operator+(const S& str) const
+  {
+    CowString res = *this;
+    return res += str;
+  }
+
+  bool operator==(const CowString& other) const
+  {
+    return this->chars.sharesWith(other.chars) || this->view() == other.view();
+  }
+
+  template <typename S, typename = std::enable_if_t<std::is_convertible_v<const S&, std::string_view>>>
+  bool operator==(const S& str) const
+  {
+    return this->view() == std::string_view(str);
+  }
+
+  template <typename S> bool operator!=(const S& str) const
+  {
+    return !(this->operator==(str));
+  }
+
+  operator std::string() const
+  {
+    return std::string(this->view());
+  }
+
+  /**
+    * Deep copy into a `String`
+    */
+  String toString() const
+  {
+    return String(this->view());
+  }
+
+  /**
+    * Whether other strings share the characters of this one
+    */
+  bool isShared() const
+  {
+    return this->chars.isShared();
+  }
+};
+} // namespace CppUtil
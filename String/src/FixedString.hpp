@@ -0,0 +1,244 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "CharClass.hpp"
+#include "Hash.hpp"
+#include "String.hpp"
+
+namespace CppUtil
+{
+/**
+  * String of `N` characters stored inline, usable during compilation
+  *
+  * Comparison, searching, substrings, concatenation and hashing are `constexpr`, so keyword tables, character sets
+  * and their hashes can be computed at compile time instead of at startup:
+  *
+  *   constexpr FixedString Keyword = "select";
+  *   static_assert(Keyword.getHash() == Hash::constString("select"));
+  *
+  * At runtime a `FixedString` is a string-like type: it converts to `std::string_view`, compares with `String` and
+  * hashes like it, so it can be used to look up `Map<String, U>`.
+  */
+template <size_t N> class FixedString
+{
+  template <size_t M> friend class FixedString;
+
+private:
+  char chars[N + 1] = {};
+
+public:
+  static constexpr size_t npos = (size_t)-1;
+
+  constexpr FixedString() = default;
+
+  /**
+    * From a string literal, e.g. `FixedString("abc")` deduces `FixedString<3>`
+    */
+  constexpr FixedString(const char (&str)[N + 1])
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      this->chars[i] = str[i];
+    }
+  }
+
+  /**
+    * @throws `length_error` if `str` does not have exactly `N` characters
+    */
+  explicit constexpr FixedString(std::string_view str)
+  {
+    if (str.size() != N)
+    {
+      throw std::length_error("Cannot store " + std::to_string(str.size()) + " characters in fixed string of length " +
+                              std::to_string(N) + "!");
+    }
+
+    for (size_t i = 0; i < N; i++)
+    {
+      this->chars[i] = str[i];
+    }
+  }
+
+  static constexpr size_t length()
+  {
+    return N;
+  }
+
+  static constexpr bool isEmpty()
+  {
+    return N == 0;
+  }
+
+  constexpr std::string_view view() const
+  {
+    return std::string_view(this->chars, N);
+  }
+
+  /**
+    * Null terminated characters
+    */
+  constexpr const char * c_str() const
+  {
+    return this->chars;
+  }
+
+  constexpr operator std::string_view() const
+  {
+    return this->view();
+  }
+
+  /**
+    * Copy into a runtime `String`
+    */
+  String toString() const
+  {
+    return String(this->view());
+  }
+
+  /**
+    * @throws `out_of_range` if @param idx is not smaller than the length
+    */
+  constexpr char operator[](size_t idx) const
+  {
+    if (idx >= N)
+    {
+      throw std::out_of_range("Index " + std::to_string(idx) + " out of bounds for string of length " +
+                              std::to_string(N) + "!");
+    }
+    return this->chars[idx];
+  }
+
+  /**
+    * Index of the first occurrence of `str` at or after `startIdx`, or `npos`
+    */
+  constexpr size_t find(std::string_view str, size_t startIdx = 0) const
+  {
+    return this->view().find(str, startIdx);
+  }
+
+  constexpr size_t find(char c, size_t startIdx = 0) const
+  {
+    return this->view().find(c, startIdx);
+  }
+
+  constexpr bool contains(std::string_view str) const
+  {
+    return this->find(str) != npos;
+  }
+
+  constexpr bool startsWith(std::string_view str) const
+  {
+    return this->view().substr(0, str.size()) == str;
+  }
+
+  constexpr bool endsWith(std::string_view str) const
+  {
+    return N >= str.size() && this->view().substr(N - str.size()) == str;
+  }
+
+  /**
+    * The `Len` characters starting at `Idx`, with the length checked during compilation
+    */
+  template <size_t Idx, size_t Len> constexpr FixedString<Len> substring() const
+  {
+    static_assert(Idx <= N && Len <= N - Idx, "Substring exceeds the string!");
+
+    FixedString<Len> res;
+    for (size_t i = 0; i < Len; i++)
+    {
+      res.chars[i] = this->chars[Idx + i];
+    }
+    return res;
+  }
+
+  /**
+    * View of the `len` characters starting at `idx`
+    *
+    * @throws `out_of_range` if the substring exceeds the string
+    */
+  constexpr std::string_view substring(size_t idx, size_t len) const
+  {
+    if (idx > N || len > N - idx)
+    {
+      throw std::out_of_range("Substring [" + std::to_string(idx) + ", " + std::to_string(idx + len) +
+                              ") exceeds string of length " + std::to_string(N) + "!");
+    }
+    return this->view().substr(idx, len);
+  }
+
+  template <size_t M> constexpr FixedString<N + M> operator+(const FixedString<M>& other) const
+  {
+    FixedString<N + M> res;
+    for (size_t i = 0; i < N; i++)
+    {
+      res.chars[i] = this->chars[i];
+    }
+    for (size_t i = 0; i < M; i++)
+    {
+      res.chars[N + i] = other.chars[i];
+    }
+    return res;
+  }
+
+  template <size_t M> constexpr FixedString<N + M - 1> operator+(const char (&str)[M]) const
+  {
+    return *this + FixedString<M - 1>(str);
+  }
+
+  /**
+    * `Hash::string` of the characters, computed during compilation for constant strings
+    */
+  constexpr uint64_t getHash(uint64_t seed = 0) const
+  {
+    return Hash::constString(this->view(), seed);
+  }
+
+  /**
+    * Set of the characters, e.g. for `String::isAlphaOr`
+    */
+  constexpr CharSet toCharSet() const
+  {
+    return CharSet(this->chars, N);
+  }
+
+  constexpr int compare(std::string_view str) const
+  {
+    return this->view().compare(str);
+  }
+
+  // Comparisons with anything convertible to `std::string_view`, including other fixed strings and literals
+  template <typename S>
+  using EnableStringLike = std::enable_if_t<std::is_convertible_v<const S&, std::string_view>, int>;
+
+  template <typename S, EnableStringLike<S> = 0> constexpr bool operator==(const S& str) const
+  {
+    return this->view() == std::string_view(str);
+  }
+
+  template <typename S, EnableStringLike<S> = 0> constexpr bool operator!=(const S& str) const
+  {
+    return this->view() != std::string_view(str);
+  }
+
+  template <typename S, EnableStringLike<S> = 0> constexpr bool operator<(const S& str) const
+  {
+    return this->view() < std::string_view(str);
+  }
+
+  bool operator==(const String& str) const
+  {
+    return this->view() == str.view();
+  }
+
+  bool operator!=(const String& str) const
+  {
+    return this->view() != str.view();
+  }
+};
+
+template <size_t N> FixedString(const char (&)[N]) -> FixedString<N - 1>;
+} // namespace CppUtil
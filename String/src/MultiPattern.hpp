@@ -0,0 +1,327 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Array.hpp"
+
+namespace CppUtil
+{
+/**
+  * Matcher searching for many patterns in a single pass, using an Aho-Corasick automaton
+  *
+  * The automaton is compiled into a flat DFA table: failure links are resolved ahead of time, so every input byte
+  * costs exactly one table lookup. Bytes not occurring in any pattern share one column of the table, which keeps
+  * rows short and the table cache friendly.
+  */
+class MultiPattern
+{
+public:
+  struct Match
+  {
+    size_t pattern = 0;
+    size_t offset  = 0;
+    size_t length  = 0;
+
+    bool operator==(const Match& other) const
+    {
+      return this->pattern == other.pattern && this->offset == other.offset && this->length == other.length;
+    }
+
+    bool operator!=(const Match& other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  enum class MatchKind
+  {
+    // Every occurrence of every pattern, including overlapping ones, ordered by end offset
+    All,
+    // Non overlapping matches, preferring the match starting first and then the longest one
+    LeftmostLongest
+  };
+
+private:
+  static constexpr uint32_t None      = UINT32_MAX;
+  static constexpr uint32_t MatchFlag = 0x80000000;
+
+  std::vector<std::string> patterns;
+
+  // Byte -> column of the transition table
+  uint8_t  classes[256] = {};
+  uint32_t stride       = 1;
+
+  // Transition table; entries are premultiplied by `stride`, so they directly index the row of the next state.
+  // `MatchFlag` is set on transitions into states at which a pattern ends.
+  std::vector<uint32_t> delta = {0};
+
+  // Per state: pattern ending here, next state along the failure chain at which a pattern ends, depth
+  std::vector<uint32_t> output  = {None};
+  std::vector<uint32_t> outLink = {None};
+  std::vector<uint32_t> depth   = {0};
+
+  bool compiled = true;
+
+  void checkCompiled() const
+  {
+    if (!this->compiled)
+      throw std::logic_error("MultiPattern must be compiled before searching!");
+  }
+
+  // Report all patterns ending in (plain) state `s` at offset `end`
+  template <typename F> void emitAll(uint32_t s, size_t end, F& f) const
+  {
+    if (this->output[s] == None)
+      s = this->outLink[s];
+
+    while (s != None)
+    {
+      size_t len = this->patterns[this->output[s]].size();
+      f(Match{this->output[s], end - len, len});
+      s = this->outLink[s];
+    }
+  }
+
+  template <typename F> void scanAll(const unsigned char * data, size_t n, F& f) const
+  {
+    uint32_t s = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      uint32_t e = this->delta[s + this->classes[data[i]]];
+      s          = e & ~MatchFlag;
+      if (e & MatchFlag)
+        this->emitAll(s / this->stride, i + 1, f);
+    }
+  }
+
+  template <typename F> void scanLeftmostLongest(const unsigned char * data, size_t n, F& f) const
+  {
+    uint32_t s       = 0;
+    bool     pending = false;
+    Match    cand;
+
+    for (size_t i = 0; i < n || pending; i++)
+    {
+      if (i == n)
+      {
+        // End of input, the candidate is final; bytes consumed after it still need to be searched
+        f(cand);
+        pending = false;
+        s       = 0;
+        i       = cand.offset + cand.length - 1;
+        continue;
+      }
+
+      uint32_t e = this->delta[s + this->classes[data[i]]];
+      s          = e & ~MatchFlag;
+
+      if (pending && i + 1 - this->depth[s / this->stride] > cand.offset)
+      {
+        // No match in progress can start at or before the candidate anymore, so it is final.
+        // Continue right after it from the root, as matches must not overlap.
+        f(cand);
+        pending = false;
+        s       = 0;
+        i       = cand.offset + cand.length - 1;
+        continue;
+      }
+
+      if (e & MatchFlag)
+      {
+        // The longest pattern ending here is the first one along the output chain
+        uint32_t plain = s / this->stride;
+        uint32_t o     = (this->output[plain] != None) ? plain : this->outLink[plain];
+        size_t   len   = this->patterns[this->output[o]].size();
+
+        if (!pending || i + 1 - len <= cand.offset)
+        {
+          cand    = Match{this->output[o], i + 1 - len, len};
+          pending = true;
+        }
+      }
+    }
+  }
+
+public:
+  MultiPattern() {}
+
+  MultiPattern(std::initializer_list<std::string_view> patterns)
+  {
+    for (auto p : patterns)
+      this->add(p);
+    this->compile();
+  }
+
+  /**
+    * Add `pattern`, which can be searched for after the next `compile()`
+    *
+    * @return Id of the pattern, reported with its matches. Duplicate patterns are reported with the first id only.
+    * @throws std::invalid_argument If `pattern` is empty
+    */
+  size_t add(std::string_view pattern)
+  {
+    if (pattern.empty())
+      throw std::invalid_argument("Patterns must not be empty!");
+
+    this->patterns.emplace_back(pattern);
+    this->compiled = false;
+    return this->patterns.size() - 1;
+  }
+
+  /**
+    * Build the automaton for all added patterns
+    *
+    * @throws std::length_error If the transition table would exceed 2^31 entries
+    */
+  void compile()
+  {
+    // Every byte occurring in a pattern gets its own column, all others share column 0
+    bool used[256] = {};
+    for (const auto& p : this->patterns)
+    {
+      for (unsigned char c : p)
+        used[c] = true;
+    }
+
+    uint32_t cols = 1;
+    for (size_t b = 0; b < 256; b++)
+      this->classes[b] = used[b] ? (uint8_t)cols++ : 0;
+    this->stride = cols;
+
+    // Build the trie; `None` marks missing transitions until failure links are resolved
+    this->delta.assign(this->stride, None);
+    this->output  = {None};
+    this->outLink = {None};
+    this->depth   = {0};
+
+    for (size_t id = 0; id < this->patterns.size(); id++)
+    {
+      uint32_t s = 0;
+      for (unsigned char c : this->patterns[id])
+      {
+        uint32_t& next = this->delta[s * this->stride + this->classes[c]];
+        if (next == None)
+        {
+          uint32_t states = (uint32_t)this->output.size();
+          if (((uint64_t)states + 1) * this->stride >= MatchFlag)
+            throw std::length_error("MultiPattern automaton exceeds the maximum table size!");
+
+          next = states;
+          this->delta.resize(this->delta.size() + this->stride, None);
+          this->output.push_back(None);
+          this->outLink.push_back(None);
+          this->depth.push_back(this->depth[s] + 1);
+        }
+        s = this->delta[s * this->stride + this->classes[c]];
+      }
+
+      if (this->output[s] == None)
+        this->output[s] = (uint32_t)id;
+    }
+
+    // Resolve failure links in BFS order, turning the trie into a DFA over plain state ids
+    std::vector<uint32_t> fail(this->output.size(), 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(this->output.size());
+
+    for (uint32_t c = 0; c < this->stride; c++)
+    {
+      uint32_t& t = this->delta[c];
+      if (t == None)
+        t = 0;
+      else
+        queue.push_back(t);
+    }
+
+    for (size_t q = 0; q < queue.size(); q++)
+    {
+      uint32_t s = queue[q];
+      uint32_t f = fail[s];
+
+      this->outLink[s] = (this->output[f] != None) ? f : this->outLink[f];
+
+      for (uint32_t c = 0; c < this->stride; c++)
+      {
+        uint32_t& t = this->delta[s * this->stride + c];
+        if (t == None)
+        {
+          t = this->delta[f * this->stride + c];
+        }
+        else
+        {
+          fail[t] = this->delta[f * this->stride + c];
+          queue.push_back(t);
+        }
+      }
+    }
+
+    // Premultiply and flag transitions into states with output
+    for (auto& t : this->delta)
+    {
+      bool match = this->output[t] != None || this->outLink[t] != None;
+      t          = t * this->stride | (match ? MatchFlag : 0);
+    }
+
+    this->compiled = true;
+  }
+
+  size_t getCount() const
+  {
+    return this->patterns.size();
+  }
+
+  size_t getStateCount() const
+  {
+    return this->output.size();
+  }
+
+  const std::string& getPattern(size_t id) const
+  {
+    return this->patterns.at(id);
+  }
+
+  /**
+    * Call `f(const Match&)` for every match in the `n` bytes at `data`
+    */
+  template <typename F> void foreachMatch(const char * data, size_t n, F&& f, MatchKind kind = MatchKind::All) const
+  {
+    this->checkCompiled();
+    if (kind == MatchKind::All)
+      this->scanAll((const unsigned char *)data, n, f);
+    else
+      this->scanLeftmostLongest((const unsigned char *)data, n, f);
+  }
+
+  DynamicArray<Match> findAll(const char * data, size_t n, MatchKind kind = MatchKind::All) const
+  {
+    DynamicArray<Match> res;
+    this->foreachMatch(
+      data, n, [&](const Match& m) { res.add(m); }, kind);
+    return res;
+  }
+
+  /**
+    * Whether any pattern occurs in the `n` bytes at `data`, stopping at the first match
+    */
+  bool containsAny(const char * data, size_t n) const
+  {
+    this->checkCompiled();
+
+    auto     p = (const unsigned char *)data;
+    uint32_t s = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+      uint32_t e = this->delta[s + this->classes[p[i]]];
+      if (e & MatchFlag)
+        return true;
+      s = e;
+    }
+    return false;
+  }
+};
+} // namespace CppUtil
@@ -3,9 +3,12 @@
 #include <iostream>
 #include <stdexcept>
 #include <string.h>
+#include <string_view>
 
 #include "Array.hpp"
+#include "CharClass.hpp"
 #include "Exception.hpp"
+#include "MultiPattern.hpp"
 
 namespace CppUtil
 {
@@ -25,6 +28,35 @@ public:
 
   String(std::string str) : ResizableArray<char>(str.c_str(), strlen(str.c_str()) + 1){};
 
+  String(std::string_view str) : ResizableArray<char>(str.size() + 1)
+  {
+    memcpy(this->arr, str.data(), str.size());
+    this->arr[str.size()] = '\0';
+  }
+
+  String(const String& other)            = default;
+  String& operator=(const String& other) = default;
+
+  /**
+    * Take over the characters of `other`, leaving it as an empty string
+    */
+  String(String&& other) : String()
+  {
+    std::swap(this->arr, other.arr);
+    std::swap(this->size, other.size);
+  }
+
+  String& operator=(String&& other)
+  {
+    if (&other != this)
+    {
+      String tmp(std::move(other));
+      std::swap(this->arr, tmp.arr);
+      std::swap(this->size, tmp.size);
+    }
+    return *this;
+  }
+
   String operator+(const String& other) const
   {
     String res = String(this->size + other.size - 1);
@@ -85,6 +117,16 @@ public:
     return this->size - 1;
   }
 
+  /**
+    * View of the characters without the terminating null
+    *
+    * The view is invalidated by any modification of this string.
+    */
+  std::string_view view() const
+  {
+    return std::string_view(this->arr, this->length());
+  }
+
   //ToDo: UnitTest
   void remove(size_t idx, size_t len)
   {
@@ -172,13 +214,84 @@ public:
     }
   }
 
+  /**
+    * All matches of `patterns` in this string
+    */
+  DynamicArray<MultiPattern::Match> findAll(const MultiPattern&     patterns,
+                                            MultiPattern::MatchKind kind = MultiPattern::MatchKind::All) const
+  {
+    return patterns.findAll(this->arr, this->length(), kind);
+  }
+
+  /**
+    * Replace all matches of `patterns` with `replacements[patternId]` in a single sweep
+    *
+    * Matches are chosen leftmost-longest and never overlap; replaced text is not searched again.
+    *
+    * @throws std::invalid_argument If there is not exactly one replacement per pattern
+    */
+  String replaceAll(const MultiPattern& patterns, const Array<String>& replacements) const
+  {
+    if (replacements.getSize() != patterns.getCount())
+      throw std::invalid_argument("Expected " + std::to_string(patterns.getCount()) + " replacements, got " +
+                                  std::to_string(replacements.getSize()) + "!");
+
+    std::string out;
+    out.reserve(this->length());
+
+    const String * reps = replacements;
+    size_t         last = 0;
+    patterns.foreachMatch(
+      this->arr, this->length(),
+      [&](const MultiPattern::Match& m)
+      {
+        const String& rep = reps[m.pattern];
+        out.append(this->arr + last, m.offset - last);
+        out.append(rep.arr, rep.length());
+        last = m.offset + m.length;
+      },
+      MultiPattern::MatchKind::LeftmostLongest);
+    out.append(this->arr + last, this->length() - last);
+
+    String res(out.size() + 1);
+    memcpy(res.arr, out.data(), out.size());
+    res.arr[out.size()] = '\0';
+    return res;
+  }
+
+  /**
+    * Replace all occurrences of the keys of `map` with their items in a single sweep
+    *
+    * `map` must provide `foreach(f(key, item))`, e.g. `Map<String, String>`.
+    *
+    * @note Builds and compiles a `MultiPattern` of the keys on every call. To apply the same replacements repeatedly,
+    * compile the patterns once and use `replaceAll(const MultiPattern&, const Array<String>&)`.
+    */
+  template <typename M> String replaceAll(const M& map) const
+  {
+    MultiPattern         patterns;
+    DynamicArray<String> items;
+
+    map.foreach (
+      [&](const String& key, const String& item)
+      {
+        patterns.add(key.view());
+        items.add(item);
+      });
+    patterns.compile();
+
+    return this->replaceAll(patterns, items.toArray());
+  }
+
   String substring(size_t idx, size_t len) const
   {
+    if (idx > this->length() || len > this->length() - idx)
+      throw std::out_of_range("Substring [" + std::to_string(idx) + ", " + std::to_string(idx + len) +
+                              ") exceeds string of length " + std::to_string(this->length()) + "!");
+
     String res(len + 1);
-    for (size_t i = 0; i < len; i++)
-    {
-      res[i] = this->operator[](i + idx);
-    }
+    memcpy(res.arr, this->arr + idx, len);
+    res.arr[len] = '\0';
     return res;
   }
 
@@ -210,76 +323,134 @@ public:
     }
   }
 
-  // ToDo: UnitTest
+  /**
+    * Split the string at every occurrence of `character`, skipping empty parts
+    */
   DynamicArray<String> splitAt(char character) const
   {
-    DynamicArray<String> res;
-    for (size_t i = 0; i < this->length(); i++)
-    {
-      if (this->operator[](i) == character)
-        continue;
+    return this->splitAt(CharSet(&character, 1));
+  }
 
-      size_t startIdx = i;
+  /**
+    * Split the string at every character contained in `delimiters`, skipping empty parts
+    *
+    * Delimiters are located in a single vectorized pass, and the result is sized up front.
+    */
+  DynamicArray<String> splitAt(const CharSet& delimiters) const
+  {
+    DynamicArray<String> res(CharClass::countIf(this->arr, this->length(), delimiters) + 1);
+
+    size_t start = 0;
+    CharClass::foreachOf(this->arr, this->length(), delimiters,
+                         [&](size_t pos)
+                         {
+                           if (pos > start)
+                             res.add(this->substring(start, pos - start));
+                           start = pos + 1;
+                         });
+
+    if (this->length() > start)
+      res.add(this->substring(start));
+    return res;
+  }
 
-      while (1)
-      {
-        if (i >= this->length())
-        {
-          res.add(this->substring(startIdx, i - startIdx));
-          break;
-        }
+  /**
+    * Split the string at every character contained in `delimiters` into views of this string
+    *
+    * `out` is cleared first and keeps its capacity, so reusing it across calls avoids allocations.
+    * The views are invalidated by any modification of this string.
+    *
+    * @param keepEmpty Whether to emit empty parts between adjacent delimiters, as needed for CSV-like data
+    * @return Amount of parts
+    */
+  size_t splitViews(const CharSet& delimiters, DynamicArray<std::string_view>& out, bool keepEmpty = false) const
+  {
+    return splitViews(this->view(), delimiters, out, keepEmpty);
+  }
 
-        if (this->operator[](i) == character)
-        {
-          res.add(this->substring(startIdx, i - startIdx));
-          break;
-        }
-        i++;
-      }
-    }
-    return res;
+  /**
+    * Split `str` at every character contained in `delimiters` into views of `str`
+    *
+    * @see splitViews(const CharSet&, DynamicArray<std::string_view>&, bool) const
+    */
+  static size_t splitViews(std::string_view str, const CharSet& delimiters, DynamicArray<std::string_view>& out,
+                           bool keepEmpty = false)
+  {
+    out.clear();
+
+    size_t start = 0;
+    CharClass::foreachOf(str.data(), str.size(), delimiters,
+                         [&](size_t pos)
+                         {
+                           if (keepEmpty || pos > start)
+                             out.add(str.substr(start, pos - start));
+                           start = pos + 1;
+                         });
+
+    if (keepEmpty || str.size() > start)
+      out.add(str.substr(start));
+    return out.getCount();
   }
 
   static bool charIsAlpha(char c)
   {
-    if (c >= 0x30 && c <= 0x39)
-      return true;
-    if (c >= 0x41 && c <= 0x5A)
-      return true;
-    if (c >= 0x61 && c <= 0x7A)
-      return true;
+    return CharClass::Alnum.contains(c);
+  }
 
-    return false;
+  /**
+    * Whether the string only consists of letters and digits
+    */
+  bool isAlpha() const
+  {
+    return CharClass::all(this->arr, this->length(), CharClass::Alnum);
   }
 
-  bool isAlpha()
+  /**
+    * Whether the string only consists of letters, digits and the given `characters`
+    */
+  bool isAlphaOr(const String& characters) const
   {
-    for (size_t i = 0; i < this->length(); i++)
-    {
-      if (!charIsAlpha(this->operator[](i)))
-        return false;
-    }
-    return true;
+    return this->isAlphaOr(CharSet(characters.arr, characters.length()));
   }
 
-  bool isAlphaOr(String characters)
+  bool isAlphaOr(const CharSet& characters) const
   {
-    for (size_t i = 0; i < this->length(); i++)
-    {
-      char c = this->operator[](i);
-      if (!charIsAlpha(c))
-      {
-        bool res = false;
-        for (size_t j = 0; j < characters.length(); j++)
-        {
-          if (c == characters[j])
-            res = true;
-        }
-        if (!res)
-          return false;
-      }
-    }
-    return true;
+    return CharClass::all(this->arr, this->length(), CharClass::Alnum | characters);
+  }
+
+  bool isDigit() const
+  {
+    return CharClass::all(this->arr, this->length(), CharClass::Digits);
+  }
+
+  bool isSpace() const
+  {
+    return CharClass::all(this->arr, this->length(), CharClass::Spaces);
+  }
+
+  /**
+    * Index of the first character at or after `startIdx` not contained in `set`, or `CharClass::npos`
+    */
+  size_t findFirstNotOf(const CharSet& set, size_t startIdx = 0) const
+  {
+    if (startIdx >= this->length())
+      return CharClass::npos;
+
+    size_t idx = CharClass::findFirstNotOf(this->arr + startIdx, this->length() - startIdx, set);
+    return (idx == CharClass::npos) ? idx : idx + startIdx;
+  }
+
+  size_t findFirstNotOf(const String& characters, size_t startIdx = 0) const
+  {
+    return this->findFirstNotOf(CharSet(characters.arr, characters.length()), startIdx);
+  }
+
+  /**
+    * Amount of characters contained in `set`
+    */
+  size_t countIf(const CharSet& set) const
+  {
+    return CharClass::countIf(this->arr, this->length(), set);
   }
 
   template <typename func> void foreach (size_t startIdx, func && f)
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string_view>
+
+#include "Array.hpp"
+#include "Hash.hpp"
+#include "String.hpp"
+
+namespace CppUtil
+{
+class StringPool;
+
+/**
+  * Handle to a string interned in a `StringPool`
+  *
+  * A handle is a single pointer into the pool, so copying, comparing and hashing it take O(1). Handles stay valid as
+  * long as their pool exists. Handles of different pools must not be compared with each other, as equal strings of
+  * different pools have different handles. A default constructed handle is the empty string and equals the empty
+  * string interned in any pool.
+  */
+class InternedString
+{
+  friend class StringPool;
+
+private:
+  struct Entry
+  {
+    uint64_t hash;
+    size_t   length;
+
+    const char * chars() const
+    {
+      return (const char *)(this + 1);
+    }
+  };
+
+  const Entry * entry;
+
+  InternedString(const Entry * entry) : entry(entry) {}
+
+  static const Entry * emptyEntry()
+  {
+    alignas(Entry) static char storage[sizeof(Entry) + 1] = {};
+    static const Entry *       entry                      = new (storage) Entry{Hash::bytes(nullptr, 0), 0};
+    return entry;
+  }
+
+public:
+  InternedString() : entry(emptyEntry()) {}
+
+  std::string_view view() const
+  {
+    return std::string_view(this->entry->chars(), this->entry->length);
+  }
+
+  /**
+    * Null terminated characters
+    */
+  const char * c_str() const
+  {
+    return this->entry->chars();
+  }
+
+  size_t length() const
+  {
+    return this->entry->length;
+  }
+
+  bool isEmpty() const
+  {
+    return this->entry->length == 0;
+  }
+
+  /**
+    * `Hash::string` of the characters, computed once when interning
+    */
+  uint64_t getHash() const
+  {
+    return this->entry->hash;
+  }
+
+  bool operator==(const InternedString& other) const
+  {
+    return this->entry == other.entry;
+  }
+
+  bool operator!=(const InternedString& other) const
+  {
+    return this->entry != other.entry;
+  }
+};
+
+/**
+  * Hash of an `InternedString`, read from the handle unless a seed is given
+  *
+  * Equals the hash of other string-like types with the same characters, so `Map<InternedString, U>` can also be
+  * searched by `const char*` or `std::string_view`.
+  */
+template <> struct Hasher<InternedString>
+{
+  uint64_t seed = 0;
+
+  Hasher(uint64_t seed = 0) : seed(seed) {}
+
+  size_t operator()(const InternedString& str) const
+  {
+    return (size_t)(this->seed == 0 ? str.getHash() : Hash::string(str.view(), this->seed));
+  }
+};
+
+/**
+  * Thread safe pool storing each distinct string once
+  *
+  * Characters are copied into large arena blocks instead of one heap allocation per string. The pool is split into
+  * shards selected by the hash, each with its own lock and hash table, so concurrent interning rarely contends.
+  * Memory is only released when the pool is destroyed.
+  */
+class StringPool
+{
+private:
+  using Entry = InternedString::Entry;
+
+  static constexpr size_t ShardCount = 16;
+  static constexpr size_t BlockSize  = 64 << 10;
+
+  struct Block
+  {
+    Block * next;
+  };
+
+  struct Shard
+  {
+    mutable std::mutex   mtx;
+    Array<const Entry *> slots = Array<const Entry *>(16);
+    size_t               count = 0;
+    Block *              block = nullptr;
+    char *               pos   = nullptr;
+    char *               end   = nullptr;
+    size_t               bytes = 0;
+
+    ~Shard()
+    {
+      while (this->block != nullptr)
+      {
+        Block * next = this->block->next;
+        delete[](char *) this->block;
+        this->block = next;
+      }
+    }
+
+    const Entry * find(std::string_view str, uint64_t hash) const
+    {
+      const Entry * const * s    = this->slots;
+      size_t                mask = this->slots.getSize() - 1;
+      for (size_t pos = hash & mask;; pos = (pos + 1) & mask)
+      {
+        const Entry * e = s[pos];
+        if (e == nullptr)
+          return nullptr;
+        if (e->hash == hash && e->length == str.size() && memcmp(e->chars(), str.data(), str.size()) == 0)
+          return e;
+      }
+    }
+
+    void link(const Entry * e)
+    {
+      const Entry ** s    = this->slots;
+      size_t         mask = this->slots.getSize() - 1;
+      size_t         pos  = e->hash & mask;
+      while (s[pos] != nullptr)
+      {
+        pos = (pos + 1) & mask;
+      }
+      s[pos] = e;
+    }
+
+    void grow()
+    {
+      Array<const Entry *> old = std::move(this->slots);
+      this->slots              = Array<const Entry *>(old.getSize() * 2);
+      for (size_t i = 0; i < old.getSize(); i++)
+      {
+        if (old[i] != nullptr)
+          this->link(old[i]);
+      }
+    }
+
+    char * allocate(size_t size)
+    {
+      size = (size + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+      if (size > (size_t)(this->end - this->pos))
+      {
+        // Large strings get a block of their own, so the remainder of the current block is not wasted
+        size_t  blockSize = size > BlockSize / 4 ? size : BlockSize;
+        Block * b         = (Block *)new char[sizeof(Block) + blockSize];
+        this->bytes += sizeof(Block) + blockSize;
+        if (blockSize != BlockSize && this->block != nullptr)
+        {
+          b->next           = this->block->next;
+          this->block->next = b;
+          return (char *)(b + 1);
+        }
+        b->next     = this->block;
+        this->block = b;
+        this->pos   = (char *)(b + 1);
+        this->end   = this->pos + blockSize;
+      }
+      char * res = this->pos;
+      this->pos += size;
+      return res;
+    }
+
+    const Entry * intern(std::string_view str, uint64_t hash)
+    {
+      std::lock_guard<std::mutex> lock(this->mtx);
+
+      const Entry * e = this->find(str, hash);
+      if (e != nullptr)
+        return e;
+
+      if (2 * (this->count + 1) > this->slots.getSize())
+        this->grow();
+
+      char *  mem = this->allocate(sizeof(Entry) + str.size() + 1);
+      Entry * res = new (mem) Entry{hash, str.size()};
+      memcpy(mem + sizeof(Entry), str.data(), str.size());
+      mem[sizeof(Entry) + str.size()] = '\0';
+
+      this->link(res);
+      this->count++;
+      return res;
+    }
+  };
+
+  Shard shards[ShardCount];
+
+  Shard& shardOf(uint64_t hash)
+  {
+    return this->shards[hash >> 60];
+  }
+
+  const Shard& shardOf(uint64_t hash) const
+  {
+    return this->shards[hash >> 60];
+  }
+
+public:
+  StringPool() = default;
+
+  StringPool(const StringPool&)            = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  /**
+    * Handle to the pooled copy of `str`, adding it if it is not in the pool yet
+    */
+  InternedString intern(std::string_view str)
+  {
+    if (str.empty())
+      return InternedString();
+
+    uint64_t hash = Hash::string(str);
+    return InternedString(this->shardOf(hash).intern(str, hash));
+  }
+
+  InternedString intern(const String& str)
+  {
+    return this->intern(str.view());
+  }
+
+  InternedString intern(const std::string& str)
+  {
+    return this->intern(std::string_view(str));
+  }
+
+  InternedString intern(const char * str)
+  {
+    return this->intern(std::string_view(str));
+  }
+
+  /**
+    * Whether `str` has been interned in this pool
+    */
+  bool contains(std::string_view str) const
+  {
+    if (str.empty())
+      return true;
+
+    uint64_t     hash  = Hash::string(str);
+    const Shard& shard = this->shardOf(hash);
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    return shard.find(str, hash) != nullptr;
+  }
+
+  /**
+    * Amount of distinct non-empty strings in the pool
+    */
+  size_t getCount() const
+  {
+    size_t res = 0;
+    for (const Shard& shard : this->shards)
+    {
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      res += shard.count;
+    }
+    return res;
+  }
+
+  /**
+    * Bytes allocated for arena blocks and hash tables
+    */
+  size_t getMemoryUsage() const
+  {
+    size_t res = 0;
+    for (const Shard& shard : this->shards)
+    {
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      res += shard.bytes + shard.slots.getSize() * sizeof(const Entry *);
+    }
+    return res;
+  }
+};
+} // namespace CppUtil
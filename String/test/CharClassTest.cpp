@@ -0,0 +1,148 @@
+#include "CharClass.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+static constexpr CharClass::Isa AllIsas[] = {CharClass::Isa::Scalar, CharClass::Isa::SSSE3, CharClass::Isa::AVX2};
+
+TEST_CASE("CharSet", "[string][charset]")
+{
+  SECTION("Characters can be added and queried")
+  {
+    CharSet set("abc");
+
+    REQUIRE(set.contains('a'));
+    REQUIRE(set.contains('c'));
+    REQUIRE_FALSE(set.contains('d'));
+    REQUIRE_FALSE(set.contains('\0'));
+  }
+
+  SECTION("Bytes above 127 are supported")
+  {
+    CharSet set;
+    set.add((char)0xff);
+    set.add((char)0x80);
+
+    REQUIRE(set.contains((char)0xff));
+    REQUIRE(set.contains((char)0x80));
+    REQUIRE_FALSE(set.contains((char)0x7f));
+    REQUIRE_FALSE(set.contains((char)0x00));
+  }
+
+  SECTION("Sets can be combined")
+  {
+    constexpr CharSet digits = CharSet::range('0', '9');
+    constexpr CharSet hex    = digits | CharSet::range('a', 'f');
+
+    static_assert(hex.contains('7') && hex.contains('e') && !hex.contains('g'), "");
+    REQUIRE((hex & ~digits).contains('a'));
+    REQUIRE_FALSE((hex & ~digits).contains('1'));
+  }
+
+  SECTION("Predefined classes match the <cctype> classification")
+  {
+    for (int c = 0; c < 256; c++)
+    {
+      REQUIRE(CharClass::Digits.contains((char)c) == (c >= '0' && c <= '9'));
+      REQUIRE(CharClass::Alnum.contains((char)c) == (c < 128 && isalnum(c) != 0));
+      REQUIRE(CharClass::Spaces.contains((char)c) == (c < 128 && isspace(c) != 0));
+    }
+  }
+}
+
+TEST_CASE("CharClass kernels", "[string][charclass]")
+{
+  std::mt19937 rng(42);
+
+  SECTION("All kernels find the same first (non) member")
+  {
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000})
+    {
+      for (size_t pos = 0; pos <= len; pos += (len / 7) + 1)
+      {
+        std::string str(len, 'a');
+        if (pos < len)
+          str[pos] = '-';
+
+        for (auto isa : AllIsas)
+        {
+          size_t expected = (pos < len) ? pos : CharClass::npos;
+          REQUIRE(expected == CharClass::findFirstNotOf(str.data(), len, CharClass::Alnum, isa));
+          REQUIRE(expected == CharClass::findFirstOf(str.data(), len, CharSet("-"), isa));
+        }
+      }
+    }
+  }
+
+  SECTION("All kernels agree on random data and arbitrary sets")
+  {
+    std::string data(5'000, '\0');
+    for (auto& c : data)
+      c = (char)rng();
+
+    for (int round = 0; round < 20; round++)
+    {
+      CharSet set;
+      for (int i = 0; i < 40; i++)
+        set.add((char)rng());
+
+      size_t expected = 0;
+      for (char c : data)
+        expected += set.contains(c);
+
+      for (auto isa : AllIsas)
+      {
+        REQUIRE(expected == CharClass::countIf(data.data(), data.size(), set, isa));
+        REQUIRE(CharClass::findFirstOf(data.data(), data.size(), set, CharClass::Isa::Scalar) ==
+                CharClass::findFirstOf(data.data(), data.size(), set, isa));
+        REQUIRE(CharClass::findFirstNotOf(data.data(), data.size(), ~set, CharClass::Isa::Scalar) ==
+                CharClass::findFirstNotOf(data.data(), data.size(), ~set, isa));
+      }
+    }
+  }
+
+  SECTION("All kernels report the same member positions")
+  {
+    std::string data(1'000, '\0');
+    for (auto& c : data)
+      c = (char)rng();
+
+    CharSet set;
+    for (int i = 0; i < 40; i++)
+      set.add((char)rng());
+
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000})
+    {
+      std::vector<size_t> expected;
+      CharClass::foreachOf(
+        data.data(), len, set, [&](size_t pos) { expected.push_back(pos); }, CharClass::Isa::Scalar);
+
+      for (auto isa : AllIsas)
+      {
+        std::vector<size_t> positions;
+        CharClass::foreachOf(
+          data.data(), len, set, [&](size_t pos) { positions.push_back(pos); }, isa);
+        REQUIRE(expected == positions);
+      }
+    }
+  }
+
+  SECTION("Counting does not overflow on long inputs")
+  {
+    std::string data(100'000, 'x');
+    for (size_t i = 0; i < data.size(); i += 3)
+      data[i] = ' ';
+
+    for (auto isa : AllIsas)
+    {
+      REQUIRE((data.size() + 2) / 3 == CharClass::countIf(data.data(), data.size(), CharClass::Spaces, isa));
+      REQUIRE(data.size() - (data.size() + 2) / 3 ==
+              CharClass::countIf(data.data(), data.size(), CharClass::Letters, isa));
+    }
+  }
+}
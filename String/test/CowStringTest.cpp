@@ -0,0 +1,106 @@
+#include "CowString.hpp"
+#include "Map.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("CowString Init", "[cow_string][init]")
+{
+  REQUIRE(CowString().isEmpty());
+  REQUIRE(CowString("").isEmpty());
+  REQUIRE(std::string("") == CowString().c_str());
+
+  CowString s("hello");
+  REQUIRE(5 == s.length());
+  REQUIRE(s == "hello");
+  REQUIRE(s == std::string("hello"));
+  REQUIRE(s == CowString(String("hello")));
+  REQUIRE(s != "hell");
+  REQUIRE(s.view() == "hello");
+  REQUIRE('\0' == s.c_str()[5]);
+  REQUIRE(std::string(s) == "hello");
+  REQUIRE(s.toString() == "hello");
+  REQUIRE_THROWS_AS(s[5], std::out_of_range);
+  REQUIRE_THROWS_AS(std::as_const(s)[5], std::out_of_range);
+}
+
+TEST_CASE("CowString copies share until modified", "[cow_string][share]")
+{
+  CowString a = "shared value";
+  CowString b = a;
+  REQUIRE(a.isShared());
+  REQUIRE(a.c_str() == b.c_str());
+
+  SECTION("Writing a character detaches")
+  {
+    b[0] = 'S';
+    REQUIRE_FALSE(a.isShared());
+    REQUIRE(a == "shared value");
+    REQUIRE(b == "Shared value");
+  }
+
+  SECTION("Appending detaches")
+  {
+    b += "!";
+    REQUIRE(a == "shared value");
+    REQUIRE(b == "shared value!");
+    REQUIRE(a + " " + b == "shared value shared value!");
+    a += a;
+    REQUIRE(a == "shared valueshared value");
+  }
+}
+
+TEST_CASE("CowString as Map value and key", "[cow_string][map]")
+{
+  Map<CowString, CowString> map;
+  CowString                 value = "10.0.0.1";
+  for (int i = 0; i < 10; i++)
+  {
+    map["host" + std::to_string(i)] = value;
+  }
+
+  REQUIRE(10 == map.getCount());
+  REQUIRE(map.contains("host3"));
+  REQUIRE(map.contains(std::string_view("host9")));
+  REQUIRE(map.tryGetItem(CowString("host5")) == "10.0.0.1");
+  REQUIRE(map.find("host5")->c_str() == value.c_str());
+  REQUIRE(Hasher<CowString>()(value) == Hash::string("10.0.0.1"));
+}
+
+TEST_CASE("CowString copies are independent across threads", "[cow_string][thread]")
+{
+  CowString                original = "the quick brown fox";
+  std::vector<std::thread> threads;
+  std::vector<int>         matches(8);
+  for (size_t t = 0; t < matches.size(); t++)
+  {
+    threads.emplace_back(
+      [&, t]
+      {
+        for (int round = 0; round < 1'000; round++)
+        {
+          CowString copy = original;
+          if (round % 2 == 0)
+            copy[0] = 'T';
+          matches[t] += copy == "the quick brown fox";
+        }
+      });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (int m : matches)
+  {
+    REQUIRE(500 == m);
+  }
+  REQUIRE_FALSE(original.isShared());
+}
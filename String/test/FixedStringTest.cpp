@@ -0,0 +1,87 @@
+#include "FixedString.hpp"
+#include "Map.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+static constexpr FixedString Select = "select";
+static constexpr FixedString From   = "from";
+
+static_assert(Select.length() == 6);
+static_assert(Select == "select" && Select != From);
+static_assert(From < Select);
+static_assert(Select.find('l') == 2 && Select.find("ect") == 3 && Select.find("x") == FixedString<6>::npos);
+static_assert(Select.startsWith("sel") && Select.endsWith("ct") && !Select.endsWith("selects"));
+static_assert(Select.substring<1, 3>() == "ele");
+static_assert(Select.substring(3, 3) == "ect");
+static_assert(Select + " * " + From == "select * from");
+static_assert((Select + From).length() == 10);
+static_assert(FixedString("").isEmpty());
+static_assert(Select.toCharSet().contains('s') && !Select.toCharSet().contains('x'));
+
+// Hashes usable as switch labels
+static_assert(Select.getHash() == Hash::constString("select"));
+static_assert(Select.getHash() != From.getHash());
+static_assert(Hash::combine(1, 2) != Hash::combine(2, 1));
+
+static int keywordId(std::string_view word)
+{
+  switch (Hash::string(word))
+  {
+    case Select.getHash():
+      return 1;
+    case From.getHash():
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+TEST_CASE("FixedString hashes match runtime hashes", "[fixed_string][hash]")
+{
+  // Cover every length class of the hash: empty, 1-3, 4-16, 17-47 and 48+ bytes
+  std::string str;
+  for (size_t len = 0; len <= 200; len++)
+  {
+    REQUIRE(Hash::constString(str) == Hash::string(str));
+    REQUIRE(Hash::constString(str, 42) == Hash::string(str, 42));
+    str += (char)(len * 37 + 200);
+  }
+
+  REQUIRE(Select.getHash() == Hash::string("select"));
+  REQUIRE(Select.getHash() == Hasher<String>()(String("select")));
+  REQUIRE(Hasher<FixedString<6>>()(Select) == Select.getHash());
+
+  REQUIRE(1 == keywordId("select"));
+  REQUIRE(2 == keywordId(std::string("from")));
+  REQUIRE(0 == keywordId("where"));
+}
+
+TEST_CASE("FixedString interoperates with String", "[fixed_string][string]")
+{
+  String str = Select.toString();
+  REQUIRE(str == "select");
+  REQUIRE(Select == str);
+  REQUIRE(From != str);
+  REQUIRE(std::string(Select.c_str()) == "select");
+
+  Map<String, int> keywords{{"select", 1}, {"from", 2}};
+  REQUIRE(keywords.contains(Select));
+  REQUIRE(2 == keywords.tryGetItem(From));
+
+  constexpr CharSet Extra = FixedString("_-").toCharSet();
+  REQUIRE(String("snake_case-name").isAlphaOr(Extra));
+  REQUIRE_FALSE(String("no spaces").isAlphaOr(Extra));
+}
+
+TEST_CASE("FixedString runtime errors", "[fixed_string][throw]")
+{
+  REQUIRE_THROWS_AS(Select[6], std::out_of_range);
+  REQUIRE_THROWS_AS(Select.substring(4, 3), std::out_of_range);
+  REQUIRE_THROWS_AS(FixedString<3>(std::string_view("abcd")), std::length_error);
+  REQUIRE(FixedString<3>(std::string_view("abc")) == "abc");
+}
@@ -0,0 +1,189 @@
+#include "Map.hpp"
+#include "String.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+using Match = MultiPattern::Match;
+
+// Reference implementation: try every pattern at every offset
+static std::vector<Match> naiveFindAll(const std::vector<std::string>& patterns, const std::string& text)
+{
+  std::vector<Match> res;
+  for (size_t end = 1; end <= text.size(); end++)
+  {
+    // Longest pattern first, matching the order of the automaton's output chain
+    std::vector<Match> here;
+    for (size_t id = 0; id < patterns.size(); id++)
+    {
+      const auto& p = patterns[id];
+      if (p.size() <= end && text.compare(end - p.size(), p.size(), p) == 0)
+        here.push_back(Match{id, end - p.size(), p.size()});
+    }
+    std::sort(here.begin(), here.end(), [](const Match& a, const Match& b) { return a.length > b.length; });
+    res.insert(res.end(), here.begin(), here.end());
+  }
+  return res;
+}
+
+// Reference implementation: at each offset take the longest matching pattern, then continue after it
+static std::vector<Match> naiveLeftmostLongest(const std::vector<std::string>& patterns, const std::string& text)
+{
+  std::vector<Match> res;
+  for (size_t pos = 0; pos < text.size();)
+  {
+    Match best;
+    for (size_t id = 0; id < patterns.size(); id++)
+    {
+      const auto& p = patterns[id];
+      if (p.size() > best.length && text.compare(pos, p.size(), p) == 0)
+        best = Match{id, pos, p.size()};
+    }
+
+    if (best.length == 0)
+    {
+      pos++;
+    }
+    else
+    {
+      res.push_back(best);
+      pos += best.length;
+    }
+  }
+  return res;
+}
+
+static std::vector<Match> toVector(DynamicArray<Match> arr)
+{
+  std::vector<Match> res;
+  arr.foreach ([&](Match& m) { res.push_back(m); });
+  return res;
+}
+
+TEST_CASE("MultiPattern", "[string][multipattern]")
+{
+  SECTION("All overlapping matches are reported")
+  {
+    MultiPattern mp  = {"he", "she", "his", "hers"};
+    auto         res = toVector(mp.findAll("ushers", 6));
+
+    REQUIRE(std::vector<Match>{{1, 1, 3}, {0, 2, 2}, {3, 2, 4}} == res);
+  }
+
+  SECTION("Leftmost-longest matches do not overlap")
+  {
+    MultiPattern mp  = {"a", "ab", "abc", "bcd", "d"};
+    auto         res = toVector(mp.findAll("abcdabd", 7, MultiPattern::MatchKind::LeftmostLongest));
+
+    REQUIRE(std::vector<Match>{{2, 0, 3}, {4, 3, 1}, {1, 4, 2}, {4, 6, 1}} == res);
+  }
+
+  SECTION("Bytes outside the ASCII range are supported")
+  {
+    MultiPattern mp = {"\xff\xfe", "\x80"};
+    std::string  text("a\xff\xfe\x80z");
+
+    REQUIRE(2 == mp.findAll(text.data(), text.size()).getCount());
+    REQUIRE(mp.containsAny(text.data(), text.size()));
+    REQUIRE_FALSE(mp.containsAny("plain", 5));
+  }
+
+  SECTION("Empty patterns are rejected and uncompiled matchers cannot search")
+  {
+    MultiPattern mp;
+    REQUIRE_THROWS_AS(mp.add(""), std::invalid_argument);
+
+    mp.add("x");
+    REQUIRE_THROWS_AS(mp.containsAny("x", 1), std::logic_error);
+
+    mp.compile();
+    REQUIRE(mp.containsAny("x", 1));
+  }
+
+  SECTION("An empty matcher matches nothing")
+  {
+    MultiPattern mp;
+    REQUIRE(0 == mp.findAll("abc", 3).getCount());
+  }
+
+  SECTION("Matches equal a naive search on random input")
+  {
+    std::mt19937 rng(7);
+
+    for (int round = 0; round < 20; round++)
+    {
+      std::vector<std::string> patterns;
+      MultiPattern             mp;
+      for (int i = 0; i < 30; i++)
+      {
+        std::string p(1 + rng() % 5, ' ');
+        for (auto& c : p)
+          c = (char)('a' + rng() % 3);
+
+        patterns.push_back(p);
+        mp.add(p);
+      }
+      mp.compile();
+
+      std::string text(500, ' ');
+      for (auto& c : text)
+        c = (char)('a' + rng() % 4);
+
+      // Duplicate patterns are only reported with their first id
+      auto expected = naiveFindAll(patterns, text);
+      expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                    [&](const Match& m)
+                                    {
+                                      for (size_t id = 0; id < m.pattern; id++)
+                                      {
+                                        if (patterns[id] == patterns[m.pattern])
+                                          return true;
+                                      }
+                                      return false;
+                                    }),
+                     expected.end());
+
+      REQUIRE(expected == toVector(mp.findAll(text.data(), text.size())));
+      REQUIRE(naiveLeftmostLongest(patterns, text) ==
+              toVector(mp.findAll(text.data(), text.size(), MultiPattern::MatchKind::LeftmostLongest)));
+    }
+  }
+}
+
+TEST_CASE("String replaceAll", "[string][replace]")
+{
+  SECTION("Patterns are replaced by id")
+  {
+    MultiPattern mp = {"cat", "dog"};
+    String       s  = "cat chases dog, dog chases cat";
+
+    REQUIRE(s.replaceAll(mp, Array<String>{"dog", "cat"}) == "dog chases cat, cat chases dog");
+  }
+
+  SECTION("Replacements are taken from a map and not searched again")
+  {
+    Map<String, String> map = {{"a", "aa"}, {"ab", "X"}, {"b", ""}};
+    String              s   = "abba";
+
+    REQUIRE(s.replaceAll(map) == "Xaa");
+  }
+
+  SECTION("The replacement count must match the pattern count")
+  {
+    MultiPattern mp = {"a", "b"};
+    REQUIRE_THROWS_AS(String("ab").replaceAll(mp, Array<String>{"x"}), std::invalid_argument);
+  }
+
+  SECTION("Strings without matches are copied unchanged")
+  {
+    MultiPattern mp = {"xyz"};
+    REQUIRE(String("hello").replaceAll(mp, Array<String>{"!"}) == "hello");
+    REQUIRE(String("").replaceAll(mp, Array<String>{"!"}) == "");
+  }
+}
@@ -0,0 +1,109 @@
+#include "Map.hpp"
+#include "StringPool.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CatchVer.hpp"
+
+using namespace CppUtil;
+
+TEST_CASE("StringPool interns equal strings once", "[string_pool][intern]")
+{
+  StringPool pool;
+
+  InternedString a = pool.intern("host.example.com");
+  InternedString b = pool.intern(std::string("host.example.com"));
+  InternedString c = pool.intern(String("other.example.com"));
+
+  REQUIRE(a == b);
+  REQUIRE(a != c);
+  REQUIRE(a.c_str() == b.c_str());
+  REQUIRE(a.view() == "host.example.com");
+  REQUIRE(strlen(c.c_str()) == c.length());
+  REQUIRE(a.getHash() == Hash::string("host.example.com"));
+  REQUIRE(2 == pool.getCount());
+  REQUIRE(pool.contains("other.example.com"));
+  REQUIRE_FALSE(pool.contains("example.com"));
+
+  SECTION("The empty string equals default constructed handles")
+  {
+    InternedString empty = pool.intern("");
+    REQUIRE(empty == InternedString());
+    REQUIRE(empty.isEmpty());
+    REQUIRE(empty.getHash() == Hash::string(""));
+    REQUIRE(2 == pool.getCount());
+  }
+
+  SECTION("Handles stay valid while the pool grows")
+  {
+    std::vector<InternedString> handles;
+    for (int i = 0; i < 10'000; i++)
+    {
+      handles.push_back(pool.intern("field_" + std::to_string(i)));
+    }
+    // Strings larger than a quarter block get their own block
+    InternedString large = pool.intern(std::string(100'000, 'x'));
+
+    for (int i = 0; i < 10'000; i++)
+    {
+      REQUIRE(handles[i].view() == "field_" + std::to_string(i));
+      REQUIRE(handles[i] == pool.intern("field_" + std::to_string(i)));
+    }
+    REQUIRE(large.length() == 100'000);
+    REQUIRE(a.view() == "host.example.com");
+    REQUIRE(10'003 == pool.getCount());
+    REQUIRE(pool.getMemoryUsage() > 100'000);
+  }
+}
+
+TEST_CASE("StringPool can be used from multiple threads", "[string_pool][threads]")
+{
+  StringPool                               pool;
+  std::vector<std::vector<InternedString>> results(4);
+  std::vector<std::thread>                 threads;
+
+  for (size_t t = 0; t < results.size(); t++)
+  {
+    threads.emplace_back(
+      [&, t]
+      {
+        for (int i = 0; i < 5'000; i++)
+        {
+          results[t].push_back(pool.intern("key" + std::to_string((i * 7 + t) % 1'000)));
+        }
+      });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  REQUIRE(1'000 == pool.getCount());
+  for (size_t t = 0; t < results.size(); t++)
+  {
+    for (int i = 0; i < 5'000; i++)
+    {
+      REQUIRE(results[t][i] == pool.intern("key" + std::to_string((i * 7 + t) % 1'000)));
+    }
+  }
+}
+
+TEST_CASE("InternedString can be used as key", "[string_pool][map]")
+{
+  StringPool               pool;
+  Map<InternedString, int> m;
+  InternedString           get  = pool.intern("GET");
+  InternedString           post = pool.intern("POST");
+
+  m[get]  = 1;
+  m[post] = 2;
+
+  REQUIRE(m[pool.intern("GET")] == 1);
+  REQUIRE(m.tryGetItem("POST") == 2);
+  REQUIRE(m.contains(std::string_view("GET")));
+  REQUIRE_FALSE(m.contains("PUT"));
+  REQUIRE(Hasher<InternedString>()(get) == Hasher<String>()(String("GET")));
+  REQUIRE(Hasher<InternedString>(1)(get) == Hasher<String>(1)(String("GET")));
+}
@@ -25,6 +25,19 @@ TEST_CASE("String Init", "[string][init]")
     REQUIRE_NOTHROW(s = String(str));
     REQUIRE(s == "AMOG-SUS");
   }
+
+  SECTION("A moved-from String is empty")
+  {
+    String src   = "AMOGUS";
+    String other = std::move(src);
+    REQUIRE(other == "AMOGUS");
+    REQUIRE(src.length() == 0);
+    REQUIRE(src == "");
+
+    s = std::move(other);
+    REQUIRE(s == "AMOGUS");
+    REQUIRE(other.length() == 0);
+  }
 }
 
 TEST_CASE("String concat", "[string][concat]")
@@ -142,4 +155,95 @@ TEST_CASE("String Insert Element", "[string][insert]")
     s3.insert("o W", 4);
     REQUIRE(s3 == "Hello World");
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("String character classes", "[string][charclass]")
+{
+  SECTION("isAlpha accepts letters and digits only")
+  {
+    REQUIRE(String("abcXYZ019").isAlpha());
+    REQUIRE(String("").isAlpha());
+    REQUIRE_FALSE(String("abc_def").isAlpha());
+    REQUIRE_FALSE(String("abc def").isAlpha());
+  }
+
+  SECTION("isAlphaOr accepts additional characters")
+  {
+    REQUIRE(String("snake_case-name").isAlphaOr("_-"));
+    REQUIRE_FALSE(String("snake_case name").isAlphaOr("_-"));
+    REQUIRE(String("a.b.c").isAlphaOr(CharSet(".")));
+  }
+
+  SECTION("isDigit and isSpace")
+  {
+    REQUIRE(String("0123456789").isDigit());
+    REQUIRE_FALSE(String("12a").isDigit());
+    REQUIRE(String(" \t\r\n").isSpace());
+    REQUIRE_FALSE(String(" x ").isSpace());
+  }
+
+  SECTION("findFirstNotOf and countIf")
+  {
+    String s = "   indented text";
+
+    REQUIRE(3 == s.findFirstNotOf(" "));
+    REQUIRE(11 == s.findFirstNotOf(CharClass::Letters, 3));
+    REQUIRE(CharClass::npos == s.findFirstNotOf(CharClass::Letters | CharClass::Spaces));
+    REQUIRE(CharClass::npos == s.findFirstNotOf(" ", 100));
+    REQUIRE(4 == s.countIf(CharClass::Spaces));
+  }
+}
+
+TEST_CASE("String split", "[string][split]")
+{
+  SECTION("Strings can be split at a single character")
+  {
+    auto parts = String("a b  c ").splitAt(' ');
+
+    REQUIRE(3 == parts.getCount());
+    REQUIRE(parts[0] == "a");
+    REQUIRE(parts[1] == "b");
+    REQUIRE(parts[2] == "c");
+  }
+
+  SECTION("Strings can be split at multiple delimiters")
+  {
+    auto parts = String("key=value;other = 42").splitAt(CharSet("=; "));
+
+    REQUIRE(4 == parts.getCount());
+    REQUIRE(parts[0] == "key");
+    REQUIRE(parts[1] == "value");
+    REQUIRE(parts[2] == "other");
+    REQUIRE(parts[3] == "42");
+  }
+
+  SECTION("Strings without content yield no parts")
+  {
+    REQUIRE(0 == String("").splitAt(',').getCount());
+    REQUIRE(0 == String(",,,").splitAt(',').getCount());
+  }
+
+  SECTION("Views keep empty parts on request")
+  {
+    DynamicArray<std::string_view> views;
+    String                         csv = "1,,3,";
+
+    REQUIRE(2 == csv.splitViews(CharSet(","), views));
+    REQUIRE(views[1] == "3");
+
+    REQUIRE(4 == csv.splitViews(CharSet(","), views, true));
+    REQUIRE(views[0] == "1");
+    REQUIRE(views[1].empty());
+    REQUIRE(views[2] == "3");
+    REQUIRE(views[3].empty());
+  }
+
+  SECTION("Substrings out of range are rejected")
+  {
+    String s = "Hello";
+
+    REQUIRE(s.substring(1, 3) == "ell");
+    REQUIRE(s.substring(5) == "");
+    REQUIRE_THROWS_AS(s.substring(2, 4), std::out_of_range);
+  }
+}